@@ -0,0 +1,114 @@
+/**
+ * @file UbidotsLabels.cpp
+ */
+
+#include "UbidotsLabels.h"
+#include "UbidotsPayload.h"
+#include <string.h>
+
+#define FRAGMENT_START        "\""
+#define FRAGMENT_END          "\": [{\"value\": "
+#define LABEL_TABLE_GROWTH    8
+
+LabelTable::LabelTable() {
+  _labels = NULL;
+  _count = 0;
+  _capacity = 0;
+}
+
+LabelTable::~LabelTable() {
+  for (uint8_t i = 0; i < _count; i++) {
+    free(_labels[i]._fragment);
+  }
+  free(_labels);
+}
+
+uint8_t LabelTable::add(const char* variableLabel) {
+  uint8_t id = find(variableLabel);
+
+  if (id != LABEL_NONE) {
+    return id;
+  }
+
+  if (variableLabel == NULL || _count >= MAX_LABELS) {
+    return LABEL_NONE;
+  }
+
+  if (_count == _capacity) {
+    uint16_t capacity = _capacity + LABEL_TABLE_GROWTH;
+    if (capacity > MAX_LABELS) {
+      capacity = MAX_LABELS;
+    }
+
+    LabelFragment* labels = (LabelFragment *)realloc(_labels, capacity * sizeof(LabelFragment));
+    if (labels == NULL) {
+      return LABEL_NONE;
+    }
+
+    _labels = labels;
+    _capacity = capacity;
+  }
+
+  // Se mide el fragmento ya escapado, y luego se escribe en un buffer justo de ese tamaño, seguido
+  // de una copia del nombre (así el nombre puede estar en un buffer que el sketch reutiliza)
+  PayloadCounter counter;
+  counter.append(FRAGMENT_START);
+  counter.appendEscaped(variableLabel);
+  counter.append(FRAGMENT_END);
+
+  size_t labelLength = strlen(variableLabel);
+
+  if (counter.length() > 0xFFFF) {
+    return LABEL_NONE;
+  }
+
+  char* fragment = (char *)malloc(counter.length() + 1 + labelLength + 1);
+  if (fragment == NULL) {
+    return LABEL_NONE;
+  }
+
+  PayloadBuffer writer(fragment, counter.length() + 1);
+  writer.append(FRAGMENT_START);
+  writer.appendEscaped(variableLabel);
+  writer.append(FRAGMENT_END);
+
+  char* label = fragment + counter.length() + 1;
+  memcpy(label, variableLabel, labelLength + 1);
+
+  LabelFragment* entry = _labels + _count;
+  entry->_label = label;
+  entry->_fragment = fragment;
+  entry->_length = writer.length();
+
+  return _count++;
+}
+
+uint8_t LabelTable::find(const char* variableLabel) const {
+  if (variableLabel == NULL) {
+    return LABEL_NONE;
+  }
+
+  for (uint8_t i = 0; i < _count; i++) {
+    if (_labels[i]._label == variableLabel || strcmp(_labels[i]._label, variableLabel) == 0) {
+      return i;
+    }
+  }
+
+  return LABEL_NONE;
+}
+
+const char* LabelTable::label(uint8_t id) const {
+  return _labels[id]._label;
+}
+
+const char* LabelTable::fragment(uint8_t id) const {
+  return _labels[id]._fragment;
+}
+
+uint16_t LabelTable::fragmentLength(uint8_t id) const {
+  return _labels[id]._length;
+}
+
+uint8_t LabelTable::count() const {
+  return _count;
+}
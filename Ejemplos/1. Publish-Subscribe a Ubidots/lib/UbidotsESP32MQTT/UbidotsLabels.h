@@ -0,0 +1,74 @@
+/**
+ * @file UbidotsLabels.h
+ */
+
+#ifndef UbidotsLabels_H
+#define UbidotsLabels_H
+
+#include <Arduino.h>
+
+#define LABEL_NONE            0xFF  //!< Id inválido: la variable no está registrada
+#define MAX_LABELS            0xFF  //!< Cantidad máxima de variables registradas
+
+/**
+ * @brief Variable registrada: nombre y fragmento JSON precalculado.
+ */
+typedef struct LabelFragment {
+  const char* _label;   // Copia del nombre, en la misma reserva que el fragmento
+  char* _fragment;      // "variable": [{"value": (con el nombre ya escapado)
+  uint16_t _length;
+} LabelFragment;
+
+/**
+ * @brief Tabla de variables registradas, identificadas por un id pequeño.
+ *
+ * Al registrar una variable se calcula una sola vez el inicio de su entrada en el JSON, con el
+ * nombre escapado. Los valores pendientes del cliente (ver ValueStore) sólo guardan el id, y al
+ * publicar el fragmento se copia tal cual, sin volver a recorrer el nombre.
+ */
+class LabelTable {
+  public:
+    LabelTable();
+    ~LabelTable();
+
+    /**
+     * @brief Registrar una variable. Si ya estaba registrada, se devuelve su id.
+     *
+     * @param variableLabel Nombre de la variable (se copia)
+     * @return uint8_t Id de la variable, o LABEL_NONE si el nombre es NULL, la tabla está llena o
+     * no hay memoria
+     */
+    uint8_t add(const char* variableLabel);
+
+    /**
+     * @brief Id de una variable registrada, o LABEL_NONE.
+     */
+    uint8_t find(const char* variableLabel) const;
+
+    /**
+     * @brief Nombre de una variable registrada.
+     */
+    const char* label(uint8_t id) const;
+
+    /**
+     * @brief Fragmento JSON precalculado de una variable registrada.
+     */
+    const char* fragment(uint8_t id) const;
+
+    /**
+     * @brief Largo del fragmento JSON de una variable registrada.
+     */
+    uint16_t fragmentLength(uint8_t id) const;
+
+    /**
+     * @brief Cantidad de variables registradas.
+     */
+    uint8_t count() const;
+
+  private:
+    LabelFragment* _labels;
+    uint8_t _count;
+    uint8_t _capacity;
+};
+
+#endif
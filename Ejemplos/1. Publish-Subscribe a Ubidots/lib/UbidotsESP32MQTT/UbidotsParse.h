@@ -0,0 +1,54 @@
+/**
+ * @file UbidotsParse.h
+ */
+
+#ifndef UbidotsParse_H
+#define UbidotsParse_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Convertir un número en texto a entero, directamente desde el payload recibido.
+ *
+ * No necesita que el texto termine en '\0' ni lo copia. Formato aceptado: signo opcional, dígitos
+ * y parte decimal opcional ("255", "-3", "1.0"); la parte decimal se trunca. Cualquier otro
+ * caracter, un texto vacío o un número fuera del rango de int32_t se rechazan.
+ *
+ * @param text Texto (por ejemplo, el payload de un mensaje)
+ * @param length Largo del texto
+ * @param value Resultado (sólo se modifica si la conversión tiene éxito)
+ * @return true Conversión exitosa
+ * @return false Texto inválido
+ */
+bool ubidotsParseInt(const uint8_t* text, unsigned int length, int32_t* value);
+
+/**
+ * @brief Convertir un número en texto a punto fijo, directamente desde el payload recibido.
+ *
+ * Por ejemplo, "21.57" con 1 decimal entrega 216 (21.6). El último decimal se redondea. Acepta el
+ * mismo formato que ubidotsParseInt().
+ *
+ * @param text Texto (por ejemplo, el payload de un mensaje)
+ * @param length Largo del texto
+ * @param decimals Cantidad de decimales del resultado (0 a 9)
+ * @param value Resultado, escalado por 10^decimals (sólo se modifica si la conversión tiene éxito)
+ * @return true Conversión exitosa
+ * @return false Texto inválido o fuera del rango de int32_t
+ */
+bool ubidotsParseFixed(const uint8_t* text, unsigned int length, uint8_t decimals, int32_t* value);
+
+/**
+ * @brief Convertir un número en texto a decimal, directamente desde el payload recibido.
+ *
+ * Además del formato de ubidotsParseInt(), acepta exponente ("1.5e3"). Se consideran hasta 19
+ * dígitos significativos; el resto se ignora, muy por debajo de la precisión de un float.
+ *
+ * @param text Texto (por ejemplo, el payload de un mensaje)
+ * @param length Largo del texto
+ * @param value Resultado (sólo se modifica si la conversión tiene éxito)
+ * @return true Conversión exitosa
+ * @return false Texto inválido o fuera del rango de float
+ */
+bool ubidotsParseFloat(const uint8_t* text, unsigned int length, float* value);
+
+#endif
@@ -113,14 +113,16 @@
 /* Main Constructor, pass Ubidots Token as a parameter */
 Ubidots ubidots(TOKEN);
 
-// Delays para Envío de Paquetes, y reconexión WiFi
-/* Delays for Sending Packages, and WiFi reconnection */
-DelayMillis t_envio, t_reconexion;
-/* -------------------------------------------------------------------------- */
-
-/* ------------------ Variables Globales (Global Variables) ----------------- */
-bool wifi_on = false; // Indica si hay conexión activa a WiFi
-                      /* Indicates WiFi connection */
+// Delay para Envío de Paquetes
+/* Delay for Sending Packages */
+DelayMillis t_envio;
+
+// Muestreo del potenciómetro: 10 lecturas por segundo, en una ventana con las últimas 100. Cada
+// envío publica su media, con el mínimo, el máximo y la desviación estándar como contexto
+/** Potentiometer sampling: 10 readings per second, in a window with the last 100. Each send
+ * publishes their mean, with the minimum, maximum and standard deviation as context */
+float leerPot();
+Sampler muestreoPot(VAR_POT, leerPot, 100, 100);
 /* -------------------------------------------------------------------------- */
 
 /* -------------- Declaracion Funciones (Function Declarations) ------------- */
@@ -158,8 +160,6 @@ void setup() {
   /* Start delays */
   t_envio.empezar(10000);     // Enviar cada 10s a Ubidots
                               /* Send every 10s to Ubidots */
-  t_reconexion.empezar(3000); // Intentar reconectar cada 3s en caso de que no haya conexión
-                              /* Try to reconnect every 3s if there are no connection */
 
   // Asociar Callbacks del WiFi
   /* Associate WiFi Callbacks */
@@ -172,40 +172,29 @@ void setup() {
   /* Configure Ubidots client */
   ubidots.setDebug(true);   // Setear a TRUE para visualizar información útil
                             /* Set to TRUE to display useful info */
+  ubidots.setConnectTimeout(1000, 1); // Si el servidor no responde, loop() espera a lo más 1 s
+                                      /* If the server does not respond, loop() waits 1 s at most */
   ubidots.begin(callback);  // Iniciar Servidor y asociar Callback para recibir paquetes
                             /* Start Server and associate Callback to receive packages */
   ubidots.wifiConnection(SSID, PASS); // Iniciar conexión WiFi
                                       /* Start WiFi connection */
+
+  // Registrar suscripciones una sola vez. loop() se encarga de conectar, reconectar y renovarlas
+  /** Register subscriptions only once. loop() takes care of connecting, reconnecting and renewing
+   * them */
+  ubidots.ubidotsSubscribe(DISPOSITIVO, VAR_BOTON);
 }
 // * ---------------------------------------------------------------------------
 
 // ANCHOR loop()
 // * ---------------------------------------------------------------------------
 void loop() {
-  // Revisar si el cliente MQTT y el WiFi se encuentran conectados
-  /* Check if the MQTT client and WiFi are connected */
-  if (!ubidots.connected() && wifi_on == true) {
-    
-    // Intentar reconectar cliente MQTT cada cierto tiempo de reintento (t_reconexion)
-    /* Try to reconnect MQTT client every t_reconexion time */
-    if (t_reconexion.finalizado()) {
-      ubidots.reconnect();
-      t_reconexion.repetir(); // Reiniciar tiempo *Restart time*
-    }
-  
-    // Suscribirse, si el cliente se conectó
-    /* Subscribe, if the client is connected */
-    if (ubidots.connected()) {
-      ubidots.ubidotsSubscribe(DISPOSITIVO, VAR_BOTON);
-    }
-  }
-
   // Si el cliente se encuentra conectado, y el tiempo de envío ha finalizado, publicar variable/s a
   // Ubidots y reiniciar tiempo
   /* If the client is connected, and the send time has finished, publish variables to Ubidots */
   if (ubidots.connected() && t_envio.finalizado()) {
-    ubidots.add(VAR_POT, analogRead(POT));  // Añadir variable al buffer
-                                            /* Add variable to buffer */
+    ubidots.add(muestreoPot.aggregate());   // Añadir resumen de la ventana al buffer
+                                            /* Add window summary to buffer */
 
     Serial.println("[INFO] Enviando datos...");
     ubidots.ubidotsPublish(DISPOSITIVO);    // Publicar variable al dispositivo en Ubidots
@@ -215,6 +204,10 @@ void loop() {
     t_envio.repetir(); // Reiniciar tiempo *Restart time*
   }
 
+  // Leer el potenciómetro cuando corresponda (cada 100 ms)
+  /* Read the potentiometer when it is due (every 100 ms) */
+  muestreoPot.poll(millis());
+
   // loop() debe ser llamado constantemente para verificar conexión al servidor y revisar mensajes
   // entrantes (mensajes de un Subscribe)
   /* loop() must be constantly called to verify server connection and check incoming messages */
@@ -254,15 +247,21 @@ void callback(char* topic, uint8_t* payload, unsigned int length) {
 // ANCHOR Callbacks WiFi
 // * ---------------------------------------------------------------------------
 void callbackWifiConectado(WiFiEvent_t event) {
-  wifi_on = true;
   digitalWrite(LED_WIFI, HIGH);
   Serial.print("[WIFI] WiFi Conectado. IP: ");
   Serial.println(WiFi.localIP());
 }
 
 void callbackWifiDesconectado(WiFiEvent_t event) {
-  wifi_on = false;
   digitalWrite(LED_WIFI, LOW);
   Serial.print("[WIFI] WiFi Desconectado!");
 }
-// * ---------------------------------------------------------------------------
\ No newline at end of file
+// * ---------------------------------------------------------------------------
+// ANCHOR Lectura Potenciómetro
+// * ---------------------------------------------------------------------------
+// Fuente del muestreo: entrega una lectura del pin análogo
+/* Sampling source: returns one reading of the analog pin */
+float leerPot() {
+  return analogRead(POT);
+}
+// * ---------------------------------------------------------------------------
@@ -0,0 +1,91 @@
+/**
+ * @file UbidotsSeries.cpp
+ */
+
+#include "UbidotsSeries.h"
+
+SampleSeries::SampleSeries(const char* variableLabel, uint16_t capacity) {
+  _variableLabel = variableLabel;
+  _samples = (Sample *)malloc(capacity*sizeof(Sample));
+  _capacity = (_samples != NULL) ? capacity : 0;
+  _head = 0;
+  _count = 0;
+  _dropped = 0;
+  _next = NULL;
+}
+
+SampleSeries::~SampleSeries() {
+  free(_samples);
+}
+
+void SampleSeries::record(float value, uint32_t timestamp, uint16_t millis) {
+  if (_capacity == 0) {
+    _dropped++;
+    return;
+  }
+
+  uint16_t index = _head + _count;
+
+  if (_count == _capacity) {
+    // Serie llena: se sobrescribe la muestra más antigua
+    index = _head;
+    _head = (_head + 1 == _capacity) ? 0 : _head + 1;
+    _dropped++;
+
+  } else {
+    _count++;
+  }
+
+  if (index >= _capacity) {
+    index -= _capacity;
+  }
+
+  // El JSON escribe los milisegundos con 3 dígitos: los segundos completos pasan al timestamp
+  _samples[index]._value = value;
+  _samples[index]._timestamp = timestamp + millis / 1000;
+  _samples[index]._millis = millis % 1000;
+}
+
+void SampleSeries::clear() {
+  _head = 0;
+  _count = 0;
+}
+
+void SampleSeries::discard(uint16_t count) {
+  if (count >= _count) {
+    clear();
+    return;
+  }
+
+  _head += count;
+  if (_head >= _capacity) {
+    _head -= _capacity;
+  }
+  _count -= count;
+}
+
+uint16_t SampleSeries::count() const {
+  return _count;
+}
+
+uint32_t SampleSeries::dropped() const {
+  return _dropped;
+}
+
+const Sample& SampleSeries::at(uint16_t index) const {
+  uint16_t i = _head + index;
+
+  if (i >= _capacity) {
+    i -= _capacity;
+  }
+
+  return _samples[i];
+}
+
+const char* SampleSeries::label() const {
+  return _variableLabel;
+}
+
+SampleSeries* SampleSeries::next() const {
+  return _next;
+}
@@ -65,10 +65,13 @@
 
 #define VAR_GPS "gps" // Nombres de variables en Ubidots *variable names on Ubidots*
 
-// Ubicación real de Creatiox.
-// El '\' se antepone al '"' para indicar que lea las comillas como un caracter
-/* Creatiox real Location */
-char ubicacion_creatiox[] = "\"lat\": -33.023034, \"lng\": -71.546400";
+// Ubicación real de Creatiox. Un GPS entregaría estos valores en cada lectura
+/* Creatiox real Location. A GPS would give these values on each reading */
+float latitud = -33.023034;
+float longitud = -71.546400;
+
+#define DECIMALES_GPS 6 // Decimales a enviar (un float mantiene ~1 m de precisión)
+                        /* Decimals to send (a float keeps ~1 m of precision) */
 /* -------------------------------------------------------------------------- */
 
 // NOTE Pines ESP32
@@ -89,14 +92,9 @@ char ubicacion_creatiox[] = "\"lat\": -33.023034, \"lng\": -71.546400";
 /* Main Constructor, pass Ubidots Token as a parameter */
 Ubidots ubidots(TOKEN);
 
-// Delays para Envío de Paquetes, y reconexión WiFi
-/* Delays for Sending Packages, and WiFi reconnection */
-DelayMillis t_envio, t_reconexion;
-/* -------------------------------------------------------------------------- */
-
-/* ------------------ Variables Globales (Global Variables) ----------------- */
-bool wifi_on = false; // Indica si hay conexión activa a WiFi
-                      /* Indicates WiFi connection */
+// Delay para Envío de Paquetes
+/* Delay for Sending Packages */
+DelayMillis t_envio;
 /* -------------------------------------------------------------------------- */
 
 /* -------------- Declaracion Funciones (Function Declarations) ------------- */
@@ -131,8 +129,6 @@ void setup() {
   /* Start delays */
   t_envio.empezar(10000);     // Enviar cada 10s a Ubidots
                               /* Send every 10s to Ubidots */
-  t_reconexion.empezar(3000); // Intentar reconectar cada 3s en caso de que no haya conexión
-                              /* Try to reconnect every 3s if there are no connection */
 
   // Asociar Callbacks del WiFi
   /* Associate WiFi Callbacks */
@@ -145,6 +141,8 @@ void setup() {
   /* Configure Ubidots client */
   ubidots.setDebug(true);   // Setear a TRUE para visualizar información útil
                             /* Set to TRUE to display useful info */
+  ubidots.setConnectTimeout(1000, 1); // Si el servidor no responde, loop() espera a lo más 1 s
+                                      /* If the server does not respond, loop() waits 1 s at most */
   ubidots.begin(callback);  // Iniciar Servidor y asociar Callback para recibir paquetes
                             /* Start Server and associate Callback to receive packages */
   ubidots.wifiConnection(SSID, PASS); // Iniciar conexión WiFi
@@ -155,28 +153,18 @@ void setup() {
 // ANCHOR loop()
 // * ---------------------------------------------------------------------------
 void loop() {
-  // Revisar si el cliente MQTT y el WiFi se encuentran conectados
-  /* Check if the MQTT client and WiFi are connected */
-  if (!ubidots.connected() && wifi_on == true) {
-    
-    // Intentar reconectar cliente MQTT cada cierto tiempo de reintento (t_reconexion)
-    /* Try to reconnect MQTT client every t_reconexion time */
-    if (t_reconexion.finalizado()) {
-      ubidots.reconnect();
-      t_reconexion.repetir(); // Reiniciar tiempo *Restart time*
-    }
-  }
-
   // Si el cliente se encuentra conectado, y el tiempo de envío ha finalizado, publicar variable/s a
   // Ubidots y reiniciar tiempo
   /* If the client is connected, and the send time has finished, publish variables to Ubidots */
   if (ubidots.connected() && t_envio.finalizado()) {
 
-    // Añadir variable "gps" al buffer, y pasarle como tercer parámetro el contexto, en este caso,
-    // la localización GPS del dispositivo
-    /** Add variable "gps" to the buffer, and pass it as third parameter the context, in this case,
-     * the GPS location of the device */
-    ubidots.add(VAR_GPS, 0, ubicacion_creatiox);
+    // Añadir variable "gps" al buffer, y luego su contexto, en este caso, la localización GPS del
+    // dispositivo. Las coordenadas se guardan como números y se escriben recién al publicar
+    /** Add variable "gps" to the buffer, and then its context, in this case, the GPS location of
+     * the device. The coordinates are stored as numbers and written only when publishing */
+    ubidots.add(VAR_GPS, 0);
+    ubidots.addContext("lat", latitud, DECIMALES_GPS);
+    ubidots.addContext("lng", longitud, DECIMALES_GPS);
 
     Serial.println("[INFO] Enviando datos...");
     ubidots.ubidotsPublish(DISPOSITIVO);    // Publicar variable al dispositivo en Ubidots
@@ -204,14 +192,12 @@ void callback(char* topic, uint8_t* payload, unsigned int length) {
 // ANCHOR Callbacks WiFi
 // * ---------------------------------------------------------------------------
 void callbackWifiConectado(WiFiEvent_t event) {
-  wifi_on = true;
   digitalWrite(LED_WIFI, HIGH);
   Serial.print("[WIFI] WiFi Conectado. IP: ");
   Serial.println(WiFi.localIP());
 }
 
 void callbackWifiDesconectado(WiFiEvent_t event) {
-  wifi_on = false;
   digitalWrite(LED_WIFI, LOW);
   Serial.print("[WIFI] WiFi Desconectado!");
 }
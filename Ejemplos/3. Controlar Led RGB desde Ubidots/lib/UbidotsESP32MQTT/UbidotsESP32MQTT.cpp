@@ -23,19 +23,37 @@
  */
 
 #include "UbidotsESP32MQTT.h"
+#include "UbidotsFormat.h"
+#include <time.h>
 
 Ubidots::Ubidots(const char* token){
-  initialize(token, NULL);
+  initialize(token, NULL, MAX_VALUES, MAX_VALUES*CONTEXT_ENTRIES_PER_VALUE);
 }
 
 Ubidots::Ubidots(const char* token, char* clientName) {
-  initialize(token, clientName);
+  initialize(token, clientName, MAX_VALUES, MAX_VALUES*CONTEXT_ENTRIES_PER_VALUE);
+}
+
+Ubidots::Ubidots(const char* token, char* clientName, uint16_t maxValues) {
+  uint32_t entries = (uint32_t)maxValues*CONTEXT_ENTRIES_PER_VALUE;
+  initialize(token, clientName, maxValues, (entries > 0xFFFF) ? 0xFFFF : entries);
+}
+
+Ubidots::Ubidots(const char* token, char* clientName, uint16_t maxValues,
+                 uint16_t maxContextEntries) {
+  initialize(token, clientName, maxValues, maxContextEntries);
+}
+
+Ubidots::~Ubidots() {
 }
 
 void Ubidots::begin(void (*callback)(char*,uint8_t*,unsigned int)) {
   this->callback = callback;
   _client.setServer(_server, MQTT_PORT);
-  _client.setCallback(callback);
+  _client.setSocketTimeout(_mqttTimeout);
+  _client.setCallback([this](char* topic, uint8_t* payload, unsigned int length) {
+    handleMessage(topic, payload, length);
+  });
 }
 
 void Ubidots::wifiConnection(const char* ssid, const char* pass) {
@@ -59,6 +77,11 @@ void Ubidots::reconnect() {
     if (_debug) {
       Serial.println("conectado!");
     }
+
+    // loop() vuelve a suscribirse a las variables registradas
+    _retryDelay = RECONNECT_INTERVAL;
+    _nextSubscription = _handlers.first();
+    setState(UBIDOTS_SUBSCRIBING);
         
   } else {
     if (_debug) {
@@ -68,14 +91,139 @@ void Ubidots::reconnect() {
   }
 }
 
-bool Ubidots::loop() {    
+bool Ubidots::loop() {
+  uint32_t now = millis();
+
+  supervise(now);
+
+  // Enviar lo que espera por el límite de envío, cuando ya debería haber tokens
+  if ((_queued > 0 || _seriesQueued) && _client.connected() &&
+      (int32_t)(now - _nextRelease) >= 0) {
+    flushQueue(now);
+  }
+
+  // Con la cola vacía, enviar lo guardado en el journal mientras no hubo conexión
+  if (_journal != NULL && _journal->pending() > 0 && _state == UBIDOTS_CONNECTED &&
+      _queued == 0 && !_seriesQueued && (int32_t)(now - _nextRelease) >= 0) {
+    replayJournal(now);
+  }
+
   return _client.loop();
 }
 
+UbidotsState Ubidots::state() const {
+  return _state;
+}
+
+void Ubidots::supervise(uint32_t now) {
+  if (WiFi.status() != WL_CONNECTED) {
+    if (_state != UBIDOTS_WIFI_DOWN) {
+      _link.stop();
+      setState(UBIDOTS_WIFI_DOWN);
+    }
+    return;
+  }
+
+  switch (_state) {
+    case UBIDOTS_WIFI_DOWN:
+      // Con WiFi recién conectado se intenta de inmediato
+      _retryDelay = RECONNECT_INTERVAL;
+      _nextAttempt = now;
+      setState(UBIDOTS_TCP_CONNECTING);
+      break;
+
+    case UBIDOTS_TCP_CONNECTING:
+      if ((int32_t)(now - _nextAttempt) < 0) {
+        break;
+      }
+
+      if (_clientName == NULL) {
+        _clientName = getMac();
+      }
+
+      if (espClient.connect(_server, MQTT_PORT, _tcpTimeout)) {
+        setState(UBIDOTS_MQTT_CONNECTING);
+      } else {
+        retryLater(now);
+      }
+      break;
+
+    case UBIDOTS_MQTT_CONNECTING:
+      // Con la conexión TCP abierta, PubSubClient sólo envía CONNECT y espera la respuesta
+      if (_client.connect(_clientName, _token, NULL)) {
+        _retryDelay = RECONNECT_INTERVAL;
+        _nextSubscription = _handlers.first();
+        setState(UBIDOTS_SUBSCRIBING);
+      } else {
+        if (_debug) {
+          Serial.print("[UDOTS] Conexion MQTT rechazada, rc=");
+          Serial.println(_client.state());
+        }
+        retryLater(now);
+        setState(UBIDOTS_TCP_CONNECTING);
+      }
+      break;
+
+    case UBIDOTS_SUBSCRIBING:
+      if (!_client.connected()) {
+        retryLater(now);
+        setState(UBIDOTS_TCP_CONNECTING);
+
+      } else if (_nextSubscription == NULL) {
+        setState(UBIDOTS_CONNECTED);
+
+      } else {
+        // Una suscripción por llamada
+        subscribeHandler(_nextSubscription);
+        _nextSubscription = _nextSubscription->_next;
+      }
+      break;
+
+    case UBIDOTS_CONNECTED:
+      if (!_client.connected()) {
+        _link.stop();
+        _nextAttempt = now;
+        setState(UBIDOTS_TCP_CONNECTING);
+      }
+      break;
+  }
+}
+
+void Ubidots::setState(UbidotsState state) {
+  static const char* const NAMES[] = {
+    "sin WiFi", "conectando TCP", "conectando MQTT", "suscribiendo", "conectado"
+  };
+
+  if (_debug && state != _state) {
+    Serial.print("[UDOTS] Estado: ");
+    Serial.println(NAMES[state]);
+  }
+
+  _state = state;
+}
+
+void Ubidots::retryLater(uint32_t now) {
+  _link.stop();
+  _nextAttempt = now + _retryDelay;
+
+  // Espera creciente, para no saturar el servidor si muchos equipos se reconectan a la vez
+  _retryDelay = (_retryDelay < MAX_RECONNECT_INTERVAL / 2) ? _retryDelay * 2 : MAX_RECONNECT_INTERVAL;
+}
+
 void Ubidots::setDebug(bool debug){
     _debug = debug;
 }
 
+void Ubidots::setMaxPacketSize(uint16_t size) {
+  _maxPacketSize = size;
+}
+
+void Ubidots::setConnectTimeout(uint16_t tcpTimeout, uint16_t mqttTimeout) {
+  _tcpTimeout = tcpTimeout;
+  _mqttTimeout = (mqttTimeout > 0) ? mqttTimeout : 1;
+  _client.setSocketTimeout(_mqttTimeout);
+}
+
 void Ubidots::add(const char* variableLabel, float value) {
   return add(variableLabel, value, NULL, 0);
 }
@@ -85,80 +233,767 @@ void Ubidots::add(const char* variableLabel, float value, char *context) {
 }
 
 void Ubidots::add(const char* variableLabel, float value, char *context, uint32_t timestamp) {
-  (val+currentValue)->_variableLabel = variableLabel;
-  (val+currentValue)->_value = value;
-  (val+currentValue)->_context = context;
-  (val+currentValue)->_timestamp = timestamp;
-  currentValue++;
-  
-  if (currentValue > MAX_VALUES) {
+  _lastAdded = false;
+
+  if (variableLabel == NULL) {
+    if (_debug) {
+      Serial.println("[UDOTS] Variable sin nombre!");
+    }
+    return;
+  }
+
+  if (_store.count() >= _store.capacity()) {
     // Serial.println("You are sending more than the maximum of consecutive variables");
     Serial.println("[UDOTS] Estas enviando mas variables consecutivas del maximo permitido!");
-    currentValue = MAX_VALUES;
+    _dropped++;
+    return;
+  }
+
+  PublishPolicy* policy = findPolicy(variableLabel);
+
+  if (policy != NULL && !policy->evaluate(value, millis())) {
+    return;
   }
+
+  // La variable se registra para guardar sólo su id; si la tabla no la acepta, el nombre va en
+  // el detalle del valor, junto con el timestamp y el contexto
+  uint8_t labelId = _labels.add(variableLabel);
+  ValueDetail detail;
+
+  detail._variableLabel = (labelId == LABEL_NONE) ? variableLabel : NULL;
+  detail._context = context;
+  detail._timestamp = timestamp;
+
+  bool plain = labelId != LABEL_NONE && context == NULL && timestamp == 0;
+  store(labelId, value, plain ? NULL : &detail);
 }
 
-bool Ubidots::ubidotsSubscribe(const char* deviceLabel, const char* variableLabel) {
-    char topic[150];
-    sprintf(topic, "%s%s/%s/lv", FIRST_PART_TOPIC, deviceLabel, variableLabel);
-    
-    if (!_client.connected()) {
-        reconnect();
+uint8_t Ubidots::addLabel(const char* variableLabel) {
+  return _labels.add(variableLabel);
+}
+
+void Ubidots::add(uint8_t labelId, float value) {
+  _lastAdded = false;
+
+  if (labelId >= _labels.count()) {
+    if (_debug) {
+      Serial.println("[UDOTS] Id de variable no registrado!");
     }
+    return;
+  }
+
+  if (_store.count() >= _store.capacity()) {
+    Serial.println("[UDOTS] Estas enviando mas variables consecutivas del maximo permitido!");
+    _dropped++;
+    return;
+  }
+
+  PublishPolicy* policy = findPolicy(_labels.label(labelId));
+
+  if (policy != NULL && !policy->evaluate(value, millis())) {
+    return;
+  }
 
-    if (_debug){
-      Serial.print("[UDOTS] Suscribiendose a: ");
-      Serial.println(topic);
+  store(labelId, value, NULL);
+}
+
+void Ubidots::store(uint8_t labelId, float value, const ValueDetail* detail) {
+  if (!_store.add(labelId, value, _currentDevice, detail)) {
+    if (_debug) {
+      Serial.println("[UDOTS] Sin memoria para el valor, o demasiados dispositivos pendientes!");
     }
+    _dropped++;
+    return;
+  }
 
-    return _client.subscribe(topic);
+  _lastAdded = true;
+}
+
+bool Ubidots::add(const SampleAggregate& aggregate) {
+  _lastAdded = false;
+
+  if (aggregate._count == 0) {
+    return false;
+  }
+
+  if (_store.freeEntries() < AGGREGATE_CONTEXT_ENTRIES) {
+    if (_debug) {
+      Serial.println("[UDOTS] Buffer de contexto lleno, resumen descartado!");
+    }
+    _dropped++;
+    return false;
+  }
+
+  add(aggregate._variableLabel, aggregate._mean);
+
+  if (!_lastAdded) {
+    return false;
+  }
+
+  // Si falta alguna entrada (sin memoria para el buffer), el resumen sale completo o no sale
+  if (!addContext("min", aggregate._min) || !addContext("max", aggregate._max) ||
+      !addContext("sd", sqrtf(aggregate._variance)) || !addContext("n", aggregate._count, 0)) {
+    _store.removeLast();
+    _lastAdded = false;
+    _dropped++;
+    return false;
+  }
+
+  return true;
+}
+
+void Ubidots::setDevice(const char* deviceLabel) {
+  _currentDevice = deviceLabel;
+}
+
+bool Ubidots::addContext(const char* key, float value) {
+  return addContext(key, value, 2);
+}
+
+bool Ubidots::addContext(const char* key, float value, uint8_t decimals) {
+  ContextEntry* entry = nextContextEntry(key);
+
+  if (entry == NULL) {
+    return false;
+  }
+
+  entry->_type = CONTEXT_NUMBER;
+  entry->_decimals = (decimals > FORMAT_MAX_DECIMALS) ? FORMAT_MAX_DECIMALS : decimals;
+  entry->_number = value;
+  return true;
+}
+
+bool Ubidots::addContext(const char* key, const char* text) {
+  ContextEntry* entry = nextContextEntry(key);
+
+  if (entry == NULL) {
+    return false;
+  }
+
+  entry->_type = CONTEXT_TEXT;
+  entry->_decimals = 0;
+  entry->_text = text;
+  return true;
+}
+
+ContextEntry* Ubidots::nextContextEntry(const char* key) {
+  // Un add() descartado (buffer lleno o política) descarta también su contexto
+  if (!_lastAdded) {
+    return NULL;
+  }
+
+  ContextEntry* entry = _store.addEntry(key);
+
+  if (entry == NULL && _debug) {
+    Serial.println("[UDOTS] Buffer de contexto lleno!");
+  }
+
+  return entry;
+}
+
+bool Ubidots::ubidotsSubscribe(const char* deviceLabel, const char* variableLabel) {
+  VariableHandler* h = _handlers.add(deviceLabel, variableLabel);
+  return h != NULL && (!_client.connected() || subscribeHandler(h));
+}
+
+bool Ubidots::on(const char* deviceLabel, const char* variableLabel, FloatHandler handler) {
+  VariableHandler* h = _handlers.add(deviceLabel, variableLabel, handler);
+  return h != NULL && (!_client.connected() || subscribeHandler(h));
+}
+
+bool Ubidots::on(const char* deviceLabel, const char* variableLabel, IntHandler handler) {
+  VariableHandler* h = _handlers.add(deviceLabel, variableLabel, handler);
+  return h != NULL && (!_client.connected() || subscribeHandler(h));
+}
+
+bool Ubidots::subscribeHandler(VariableHandler* handler) {
+  if (_debug){
+    Serial.print("[UDOTS] Suscribiendose a: ");
+    Serial.println(handler->_topic);
+  }
+
+  return _client.subscribe(handler->_topic);
+}
+
+void Ubidots::handleMessage(char* topic, uint8_t* payload, unsigned int length) {
+  if (!_handlers.dispatch(topic, payload, length) && callback != NULL) {
+    callback(topic, payload, length);
+  }
 }
 
 bool Ubidots::ubidotsPublish(const char *deviceLabel) {
-  char topic[150];
-  char payload[500];
-  sprintf(topic, "%s%s", FIRST_PART_TOPIC, deviceLabel);
-  sprintf(payload, "{");
-  
-  for (int i = 0; i <= currentValue; ) {
-    sprintf(payload, "%s\"%s\": [{\"value\": %.2f", payload, (val+i)->_variableLabel, (val+i)->_value);
-    
-    if ((val+i)->_timestamp != 0) {
-      sprintf(payload, "%s, \"timestamp\": %u000", payload, (val+i)->_timestamp);
+  uint32_t now = millis();
+
+  // Los valores nuevos pasan a la cola de salida, detrás de los que esperan por el límite. Cada
+  // uno guarda su dispositivo, así los que esperan no cambian de destino si luego se publica a otro
+  _store.queue(_queued, _store.count(), deviceLabel, now);
+  _queued = _store.count();
+  _lastAdded = false;
+
+  // Las series en espera mantienen el dispositivo con que se pidió publicarlas; las muestras que
+  // se registren mientras tanto salen con ellas, a ese mismo dispositivo
+  if (!_seriesQueued) {
+    for (SampleSeries* s = _series; s != NULL; s = s->next()) {
+      if (s->count() > 0) {
+        _seriesDevice = deviceLabel;
+        _seriesQueued = true;
+        break;
+      }
     }
-    
-    if ((val+i)->_context != NULL) {
-      sprintf(payload, "%s, \"context\": {%s}", payload, (val+i)->_context);
+  }
+
+  bool stored = (_journal != NULL && !_client.connected()) && storeValues();
+  bool sent = flushQueue(now);
+
+  return sent || (stored && _queued == 0 && !_seriesQueued);
+}
+
+bool Ubidots::storeValues() {
+  uint32_t clock = (uint32_t)time(NULL);
+  bool stored = false;
+
+  // Los valores que acepta el journal salen de la cola; el resto se mantiene en orden
+  for (uint16_t i = 0; i < _queued; i++) {
+    const StoredValue& v = _store.at(i);
+    const ValueDetail* d = _store.detail(i);
+    uint32_t timestamp = (d != NULL && d->_timestamp != 0) ? d->_timestamp : clock;
+
+    if (isJournalDevice(_store.device(v._device)) &&
+        _journal->record(_store.label(_labels, i), v._value, timestamp)) {
+      _store.mark(i, i + 1, v._device, 1, VALUE_DONE);
+      stored = true;
     }
+  }
 
-    i++;
+  _queued = _store.compact(_queued);
 
-    if (i >= currentValue) {
-      sprintf(payload, "%s}]}", payload);
+  if (_debug && stored) {
+    Serial.print("[UDOTS] Sin conexion, valores guardados en el journal: ");
+    Serial.println(_journal->pending());
+  }
+
+  return stored;
+}
+
+bool Ubidots::isJournalDevice(const char* deviceLabel) const {
+  return deviceLabel == _journalDevice ||
+         (deviceLabel != NULL && strcmp(deviceLabel, _journalDevice) == 0);
+}
+
+void Ubidots::replayJournal(uint32_t now) {
+  JournalEntry entries[JOURNAL_REPLAY_VALUES];
+  Value values[JOURNAL_REPLAY_VALUES];
+  uint16_t count = _journal->peek(entries, JOURNAL_REPLAY_VALUES);
+  bool complete = true;
+  bool published = false;
+  uint16_t done;
+
+  for (uint16_t i = 0; i < count; i++) {
+    values[i]._variableLabel = entries[i]._variableLabel;
+    values[i]._value = entries[i]._value;
+    values[i]._context = NULL;
+    values[i]._timestamp = entries[i]._timestamp;
+    values[i]._entries = NULL;
+    values[i]._entryCount = 0;
+  }
+
+  _retryIn = 0;
+  _link.beginBatch();
+  bool sent = publishValues(_journalDevice, values, count, now, &done, &complete, &published);
+  sent = _link.endBatch() && sent;
+
+  // Si la conexión cae, los valores siguen en el journal hasta la próxima reconexión
+  if (!sent) {
+    return;
+  }
+
+  _journal->consume(done);
+
+  if (done < count) {
+    _nextRelease = now + _retryIn;
+  }
+}
+
+bool Ubidots::flushQueue(uint32_t now) {
+  bool complete = true;
+  bool published = false;
+  bool sent = true;
+
+  _retryIn = 0;
+
+  // Todos los paquetes van seguidos por la misma conexión; sus escrituras se agrupan
+  _link.beginBatch();
+
+  // Un tramo de paquetes por dispositivo, en el orden en que aparecen en la cola. Lo que no tuvo
+  // token, o no alcanzó a enviarse si la conexión cae, queda en la cola en el mismo orden
+  for (uint16_t i = 0; sent && i < _queued; i++) {
+    const StoredValue& v = _store.at(i);
+
+    if (!(v._flags & (VALUE_DONE | VALUE_HELD))) {
+      sent = publishDevice(v._device, i, now, &complete, &published);
+    }
+  }
+
+  // Luego las series, con todas sus muestras como un arreglo por variable
+  if (sent && _seriesQueued) {
+    sent = publishSeries(_seriesDevice, now, &complete, &published);
+  }
+
+  // Si la conexión cae, nada se descarta: loop() reintenta cuando vuelva a conectarse
+  sent = _link.endBatch() && sent;
+
+  // Quitar los valores enviados; su contexto queda libre aunque otros sigan en espera
+  _queued = _store.compact(_queued);
+
+  if (_queued > 0 || _seriesQueued) {
+    _nextRelease = now + _retryIn;
+
+    if (_debug) {
+      Serial.print(sent ? "[UDOTS] Limite de envio, valores en espera: " :
+                          "[UDOTS] Envio fallido, valores en espera: ");
+      Serial.println(_queued);
+    }
+  }
+
+  return sent && complete && (published || _queued > 0 || _seriesQueued);
+}
+
+bool Ubidots::tokenReady(const char* deviceLabel, uint32_t now) {
+  RateLimit* device = findRateLimit(deviceLabel);
+  bool ready = _rateLimit.ready(now);
+  uint32_t wait = _rateLimit.wait();
+
+  // Se revisan ambos antes de consumir, para no gastar el token de uno si el otro no alcanza
+  if (device != NULL && !device->ready(now)) {
+    ready = false;
+    if (device->wait() > wait) {
+      wait = device->wait();
+    }
+  }
+
+  if (!ready) {
+    if (_retryIn == 0 || wait < _retryIn) {
+      _retryIn = wait;
+    }
+    return false;
+  }
+
+  _tokenLimit = device;
+  return true;
+}
+
+bool Ubidots::beginPacket(const char* topic, size_t length) {
+  if (!_client.beginPublish(topic, length, false)) {
+    return false;
+  }
+
+  // El token se consume recién cuando el paquete empieza a salir: sin conexión no se gasta
+  _rateLimit.consume();
+  if (_tokenLimit != NULL) {
+    _tokenLimit->consume();
+  }
+
+  return true;
+}
+
+void Ubidots::releaseValues(uint16_t first, uint8_t device, uint16_t count, uint32_t now) {
+  for (uint16_t i = _store.next(first, _queued, device); i < _queued && count > 0;
+       i = _store.next(i + 1, _queued, device)) {
+    if (_store.at(i)._flags & VALUE_DEFERRED) {
+      uint32_t delay = now - _store.queuedAt(i);
+
+      _released++;
+      _totalDelay += delay;
+      if (delay > _maxDelay) {
+        _maxDelay = delay;
+      }
+    }
+    count--;
+  }
+}
+
+void Ubidots::deferValues(uint16_t first, uint8_t device) {
+  for (uint16_t i = _store.next(first, _queued, device); i < _queued;
+       i = _store.next(i + 1, _queued, device)) {
+    if (!(_store.at(i)._flags & VALUE_DEFERRED)) {
+      _deferrals++;
+    }
+  }
+
+  _store.mark(first, _queued, device, _queued, VALUE_DEFERRED | VALUE_HELD);
+}
+
+bool Ubidots::buildTopic(const char* deviceLabel, char* topic, size_t* maxPayload) {
+  PayloadBuffer topicWriter(topic, MAX_TOPIC_LENGTH);
+
+  // Sin dispositivo no hay tópico (p. ej. ubidotsPublish(NULL) con valores sin setDevice())
+  if (deviceLabel == NULL) {
+    return false;
+  }
+
+  topicWriter.append(FIRST_PART_TOPIC);
+  topicWriter.append(deviceLabel);
+
+  if (topicWriter.overflowed()) {
+    return false;
+  }
+
+  // Espacio disponible para el JSON dentro de un paquete, descontando encabezado y tópico
+  size_t overhead = MQTT_MAX_HEADER_SIZE + 2 + topicWriter.length();
+  *maxPayload = (_maxPacketSize > overhead) ? _maxPacketSize - overhead : 0;
+  return true;
+}
+
+bool Ubidots::publishValues(const char* deviceLabel, const Value* values, uint16_t count,
+                            uint32_t now, uint16_t* done, bool* complete, bool* published) {
+  char topic[MAX_TOPIC_LENGTH];
+  size_t maxPayload;
+  uint16_t first = 0;
+
+  *done = count;
+
+  if (!buildTopic(deviceLabel, topic, &maxPayload)) {
+    *complete = false;
+    return true;
+  }
+
+  // Repartir los valores en tantos paquetes como sea necesario. Los paquetes se envían uno tras
+  // otro, sin esperar respuesta (QoS 0)
+  while (first < count) {
+    size_t length;
+    uint16_t n = fitPayload(values + first, count - first, maxPayload, &length);
+
+    if (length > maxPayload) {
+      if (_debug) {
+        Serial.print("[UDOTS] Variable demasiado grande para un paquete: ");
+        Serial.println(values[first]._variableLabel);
+      }
+      *complete = false;
+
+    } else if (!tokenReady(deviceLabel, now)) {
+      *done = first;
+      return true;
+
+    } else if (!publishPacket(topic, values + first, n, length)) {
+      *done = first;
+      return false;
+
+    } else {
+      *published = true;
+    }
+
+    first += n;
+  }
+
+  return true;
+}
+
+bool Ubidots::publishDevice(uint8_t device, uint16_t first, uint32_t now, bool* complete,
+                            bool* published) {
+  char topic[MAX_TOPIC_LENGTH];
+  size_t maxPayload;
+  const char* deviceLabel = _store.device(device);
+
+  if (!buildTopic(deviceLabel, topic, &maxPayload)) {
+    *complete = false;
+    _store.mark(first, _queued, device, _queued, VALUE_DONE);
+    return true;
+  }
+
+  // Repartir los valores del dispositivo en tantos paquetes como sea necesario. Los paquetes se
+  // envían uno tras otro, sin esperar respuesta (QoS 0)
+  for (first = _store.next(first, _queued, device); first < _queued;
+       first = _store.next(first, _queued, device)) {
+    size_t length;
+    uint16_t n = fitStorePayload(_store, _labels, first, _queued, device, maxPayload, &length);
+
+    if (length > maxPayload) {
+      if (_debug) {
+        Serial.print("[UDOTS] Variable demasiado grande para un paquete: ");
+        Serial.println(_store.label(_labels, first));
+      }
+      *complete = false;
+
+    } else if (!tokenReady(deviceLabel, now)) {
+      // El resto del dispositivo espera al próximo token
+      deferValues(first, device);
+      return true;
+
+    } else if (!publishStorePacket(topic, first, device, n, length)) {
+      return false;
+
+    } else {
+      releaseValues(first, device, n, now);
+      *published = true;
+    }
+
+    _store.mark(first, _queued, device, n, VALUE_DONE);
+  }
+
+  return true;
+}
+
+bool Ubidots::publishSeries(const char* deviceLabel, uint32_t now, bool* complete,
+                            bool* published) {
+  char topic[MAX_TOPIC_LENGTH];
+  size_t maxPayload;
+  SeriesCursor from = { _series, 0 };
+
+  if (!buildTopic(deviceLabel, topic, &maxPayload)) {
+    *complete = false;
+    clearSeries();
+    _seriesQueued = false;
+    return true;
+  }
+
+  while (from._series != NULL) {
+    SeriesCursor to;
+    size_t length;
+
+    if (fitSeriesPayload(from, maxPayload, &to, &length) == 0) {
       break;
+    }
+
+    if (length > maxPayload) {
+      if (_debug) {
+        Serial.print("[UDOTS] Variable demasiado grande para un paquete: ");
+        Serial.println(from._series->label());
+      }
+      *complete = false;
+
+    } else if (!tokenReady(deviceLabel, now)) {
+      // Se descarta sólo lo ya enviado; el resto espera al próximo token
+      discardSeries(from);
+      return true;
+
+    } else if (!publishSeriesPacket(topic, from, to, length)) {
+      // Lo mismo si la conexión cae: el resto espera a la reconexión
+      discardSeries(from);
+      return false;
 
     } else {
-      sprintf(payload, "%s}], ", payload);
+      *published = true;
     }
+
+    from = to;
   }
-  
+
+  clearSeries();
+  _seriesQueued = false;
+  return true;
+}
+
+void Ubidots::addSeries(SampleSeries* series) {
+  SampleSeries** last = &_series;
+
+  while (*last != NULL) {
+    if (*last == series) {
+      return;
+    }
+    last = &(*last)->_next;
+  }
+
+  series->_next = NULL;
+  *last = series;
+}
+
+void Ubidots::setJournal(UbidotsJournal* journal, const char* deviceLabel) {
+  _journal = journal;
+  _journalDevice = deviceLabel;
+}
+
+void Ubidots::setRateLimit(float perSecond, uint16_t burst) {
+  _rateLimit.setRate(perSecond).setBurst(burst);
+  _store.trackQueueTime();
+}
+
+void Ubidots::addRateLimit(RateLimit* limit) {
+  RateLimit** last = &_deviceLimits;
+
+  while (*last != NULL) {
+    if (*last == limit) {
+      return;
+    }
+    last = &(*last)->_next;
+  }
+
+  limit->_next = NULL;
+  *last = limit;
+  _store.trackQueueTime();
+}
+
+RateLimit* Ubidots::findRateLimit(const char* deviceLabel) {
+  for (RateLimit* r = _deviceLimits; r != NULL; r = r->next()) {
+    if (r->label() == deviceLabel ||
+        (deviceLabel != NULL && r->label() != NULL && strcmp(r->label(), deviceLabel) == 0)) {
+      return r;
+    }
+  }
+
+  return NULL;
+}
+
+uint16_t Ubidots::queued() const {
+  return _queued;
+}
+
+uint32_t Ubidots::dropped() const {
+  return _dropped;
+}
+
+uint32_t Ubidots::deferrals() const {
+  return _deferrals;
+}
+
+uint32_t Ubidots::deferralDelay() const {
+  return _totalDelay;
+}
+
+uint32_t Ubidots::maxDeferralDelay() const {
+  return _maxDelay;
+}
+
+void Ubidots::addPolicy(PublishPolicy* policy) {
+  PublishPolicy** last = &_policies;
+
+  while (*last != NULL) {
+    if (*last == policy) {
+      return;
+    }
+    last = &(*last)->_next;
+  }
+
+  policy->_next = NULL;
+  *last = policy;
+}
+
+PublishPolicy* Ubidots::findPolicy(const char* variableLabel) {
+  for (PublishPolicy* p = _policies; p != NULL; p = p->next()) {
+    if (p->label() == variableLabel ||
+        (variableLabel != NULL && p->label() != NULL && strcmp(p->label(), variableLabel) == 0)) {
+      return p;
+    }
+  }
+
+  return NULL;
+}
+
+void Ubidots::discardSeries(SeriesCursor to) {
+  for (SampleSeries* s = _series; s != to._series; s = s->next()) {
+    s->clear();
+  }
+  to._series->discard(to._sample);
+}
+
+void Ubidots::clearSeries() {
+  for (SampleSeries* s = _series; s != NULL; s = s->next()) {
+    s->clear();
+  }
+}
+
+bool Ubidots::publishPacket(const char* topic, const Value* values, uint16_t count, size_t length) {
   if (_debug){
-    Serial.print("[UDOTS] Publicando al TOPIC: ");
-    Serial.println(topic);
-    Serial.print("[UDOTS] JSON dict: ");
-    Serial.println(payload);
+    printPacket(topic);
+    PayloadStream debug(Serial);
+    buildPayload(values, count, debug);
+    debug.flush();
+    Serial.println();
+  }
+
+  if (!beginPacket(topic, length)) {
+    return false;
   }
 
-  currentValue = 0;
-  return _client.publish(topic, payload, 512);
+  // Transmitir el JSON directamente al socket, por bloques
+  PayloadStream stream(_client);
+  return endPacket(stream, buildPayload(values, count, stream), length);
 }
 
-void Ubidots::initialize(const char* token, char* clientName){
+bool Ubidots::publishStorePacket(const char* topic, uint16_t first, uint8_t device, uint16_t count,
+                                 size_t length) {
+  if (_debug){
+    printPacket(topic);
+    PayloadStream debug(Serial);
+    buildStorePayload(_store, _labels, first, _queued, device, count, debug);
+    debug.flush();
+    Serial.println();
+  }
+
+  if (!beginPacket(topic, length)) {
+    return false;
+  }
+
+  PayloadStream stream(_client);
+  return endPacket(stream, buildStorePayload(_store, _labels, first, _queued, device, count, stream),
+                   length);
+}
+
+bool Ubidots::publishSeriesPacket(const char* topic, SeriesCursor from, SeriesCursor to, size_t length) {
+  if (_debug){
+    printPacket(topic);
+    PayloadStream debug(Serial);
+    buildSeriesPayload(from, to, debug);
+    debug.flush();
+    Serial.println();
+  }
+
+  if (!beginPacket(topic, length)) {
+    return false;
+  }
+
+  PayloadStream stream(_client);
+  return endPacket(stream, buildSeriesPayload(from, to, stream), length);
+}
+
+void Ubidots::printPacket(const char* topic) {
+  Serial.print("[UDOTS] Publicando al TOPIC: ");
+  Serial.println(topic);
+  Serial.print("[UDOTS] JSON dict: ");
+}
+
+bool Ubidots::endPacket(PayloadStream& stream, size_t written, size_t length) {
+  bool sent = stream.flush() && written == length;
+
+  if (!sent) {
+    // El paquete quedó incompleto en el socket; el broker no podría interpretar lo que siga
+    _link.stop();
+    return false;
+  }
+
+  return _client.endPublish();
+}
+
+void Ubidots::initialize(const char* token, char* clientName, uint16_t maxValues,
+                         uint16_t maxContextEntries){
   _server = SERVER;
   _token = token;
-  currentValue = 0;
-  val = (Value *)malloc(MAX_VALUES*sizeof(Value));
-  
+  _maxPacketSize = MAX_PACKET_SIZE;
+  _store.begin(maxValues, maxContextEntries);
+  _lastAdded = false;
+  _currentDevice = NULL;
+  _state = UBIDOTS_WIFI_DOWN;
+  _nextAttempt = 0;
+  _retryDelay = RECONNECT_INTERVAL;
+  _tcpTimeout = TCP_CONNECT_TIMEOUT;
+  _mqttTimeout = MQTT_CONNECT_TIMEOUT;
+  _nextSubscription = NULL;
+  _queued = 0;
+  _seriesDevice = NULL;
+  _seriesQueued = false;
+  _deviceLimits = NULL;
+  _tokenLimit = NULL;
+  _nextRelease = 0;
+  _retryIn = 0;
+  _deferrals = 0;
+  _dropped = 0;
+  _released = 0;
+  _totalDelay = 0;
+  _maxDelay = 0;
+  _journal = NULL;
+  _journalDevice = NULL;
+  _series = NULL;
+  _policies = NULL;
+
   if(clientName != NULL){
     _clientName = clientName;
   }
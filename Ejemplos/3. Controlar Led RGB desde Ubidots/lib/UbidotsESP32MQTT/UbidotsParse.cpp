@@ -0,0 +1,197 @@
+/**
+ * @file UbidotsParse.cpp
+ */
+
+#include "UbidotsParse.h"
+
+#define MAX_DIGITS    19  // Dígitos significativos que caben en un uint64_t
+
+typedef struct ParsedNumber {
+  bool _negative;
+  uint64_t _mantissa;   // Dígitos significativos
+  int32_t _exponent;    // Valor = mantissa * 10^exponent
+} ParsedNumber;
+
+static const uint64_t POW10[MAX_DIGITS + 1] = {
+  1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL,
+  1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+  100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+  1000000000000000000ULL, 10000000000000000000ULL
+};
+
+static const float POW10F[] = {
+  1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f, 1e11f, 1e12f, 1e13f, 1e14f,
+  1e15f, 1e16f, 1e17f, 1e18f, 1e19f, 1e20f, 1e21f, 1e22f, 1e23f, 1e24f, 1e25f, 1e26f, 1e27f,
+  1e28f, 1e29f, 1e30f, 1e31f, 1e32f, 1e33f, 1e34f, 1e35f, 1e36f, 1e37f, 1e38f
+};
+
+#define MAX_POW10F    38
+
+static bool scanNumber(const uint8_t* text, unsigned int length, bool allowExponent,
+                       ParsedNumber* number) {
+  unsigned int i = 0;
+  uint8_t significant = 0;
+  bool digits = false;
+  bool point = false;
+
+  number->_negative = false;
+  number->_mantissa = 0;
+  number->_exponent = 0;
+
+  if (i < length && (text[i] == '-' || text[i] == '+')) {
+    number->_negative = (text[i] == '-');
+    i++;
+  }
+
+  for (; i < length; i++) {
+    uint8_t c = text[i];
+
+    if (c >= '0' && c <= '9') {
+      uint8_t d = c - '0';
+      digits = true;
+
+      if (significant < MAX_DIGITS) {
+        number->_mantissa = number->_mantissa * 10 + d;
+
+        if (number->_mantissa != 0) {
+          significant++;
+        }
+        if (point) {
+          number->_exponent--;
+        }
+
+      } else if (!point) {
+        // Dígito descartado de la parte entera: sólo aumenta la magnitud
+        number->_exponent++;
+      }
+
+    } else if (c == '.' && !point) {
+      point = true;
+
+    } else {
+      break;
+    }
+  }
+
+  if (!digits) {
+    return false;
+  }
+
+  if (i < length && allowExponent && (text[i] == 'e' || text[i] == 'E')) {
+    bool negative = false;
+    int32_t exponent = 0;
+    bool expDigits = false;
+
+    i++;
+    if (i < length && (text[i] == '-' || text[i] == '+')) {
+      negative = (text[i] == '-');
+      i++;
+    }
+
+    for (; i < length && text[i] >= '0' && text[i] <= '9'; i++) {
+      expDigits = true;
+      if (exponent < 10000) {
+        exponent = exponent * 10 + (text[i] - '0');
+      }
+    }
+
+    if (!expDigits) {
+      return false;
+    }
+
+    number->_exponent += negative ? -exponent : exponent;
+  }
+
+  return i == length;
+}
+
+// Convierte mantissa * 10^exponent a entero con signo, truncando o redondeando los decimales
+static bool toInt32(const ParsedNumber* number, int32_t exponent, bool round, int32_t* value) {
+  uint64_t magnitude = number->_mantissa;
+
+  if (magnitude != 0 && exponent > 0) {
+    if (exponent > MAX_DIGITS || magnitude > 0xFFFFFFFFULL / POW10[exponent]) {
+      return false;
+    }
+    magnitude *= POW10[exponent];
+
+  } else if (exponent < 0) {
+    if (-exponent > MAX_DIGITS) {
+      magnitude = 0;
+
+    } else {
+      uint64_t divisor = POW10[-exponent];
+      uint64_t remainder = magnitude % divisor;
+      magnitude /= divisor;
+
+      if (round && remainder >= divisor - remainder) {
+        magnitude++;
+      }
+    }
+  }
+
+  uint64_t limit = number->_negative ? 2147483648ULL : 2147483647ULL;
+
+  if (magnitude > limit) {
+    return false;
+  }
+
+  *value = number->_negative ? (int32_t)(0 - magnitude) : (int32_t)magnitude;
+  return true;
+}
+
+bool ubidotsParseInt(const uint8_t* text, unsigned int length, int32_t* value) {
+  ParsedNumber number;
+
+  if (!scanNumber(text, length, false, &number)) {
+    return false;
+  }
+
+  return toInt32(&number, number._exponent, false, value);
+}
+
+bool ubidotsParseFixed(const uint8_t* text, unsigned int length, uint8_t decimals, int32_t* value) {
+  ParsedNumber number;
+
+  if (decimals > 9 || !scanNumber(text, length, false, &number)) {
+    return false;
+  }
+
+  return toInt32(&number, number._exponent + decimals, true, value);
+}
+
+bool ubidotsParseFloat(const uint8_t* text, unsigned int length, float* value) {
+  ParsedNumber number;
+
+  if (!scanNumber(text, length, true, &number)) {
+    return false;
+  }
+
+  float result = (float)number._mantissa;
+  int32_t exponent = number._exponent;
+
+  if (result != 0) {
+    while (exponent > 0) {
+      int32_t e = (exponent > MAX_POW10F) ? MAX_POW10F : exponent;
+      result *= POW10F[e];
+      exponent -= e;
+    }
+
+    while (exponent < 0) {
+      int32_t e = (-exponent > MAX_POW10F) ? MAX_POW10F : -exponent;
+      result /= POW10F[e];
+      exponent += e;
+
+      if (result == 0) {
+        break;
+      }
+    }
+  }
+
+  if (isinf(result)) {
+    return false;
+  }
+
+  *value = number._negative ? -result : result;
+  return true;
+}
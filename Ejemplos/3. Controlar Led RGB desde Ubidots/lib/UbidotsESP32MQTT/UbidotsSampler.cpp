@@ -0,0 +1,213 @@
+/**
+ * @file UbidotsSampler.cpp
+ */
+
+#include "UbidotsSampler.h"
+
+Sampler::Sampler(const char* variableLabel, SampleSource source, uint32_t interval, uint16_t window) {
+  _variableLabel = variableLabel;
+  _source = source;
+  _interval = interval;
+  _values = (float *)malloc(window*sizeof(float));
+  _maxQueue = (uint16_t *)malloc(window*sizeof(uint16_t));
+  _minQueue = (uint16_t *)malloc(window*sizeof(uint16_t));
+  _capacity = (_values != NULL && _maxQueue != NULL && _minQueue != NULL) ? window : 0;
+  reset();
+}
+
+Sampler::~Sampler() {
+  free(_values);
+  free(_maxQueue);
+  free(_minQueue);
+}
+
+void Sampler::reset() {
+  _started = false;
+  _nextRead = 0;
+  _head = 0;
+  _count = 0;
+  _maxFront = 0;
+  _maxSize = 0;
+  _minFront = 0;
+  _minSize = 0;
+  _sinceRefresh = 0;
+  _mean = 0;
+  _m2 = 0;
+  _failures = 0;
+  _missed = 0;
+}
+
+bool Sampler::poll(uint32_t now) {
+  if (_source == NULL || _interval == 0) {
+    return false;
+  }
+
+  if (!_started) {
+    _nextRead = now;
+    _started = true;
+  }
+
+  if ((int32_t)(now - _nextRead) < 0) {
+    return false;
+  }
+
+  // La próxima lectura se cuenta desde la que correspondía, no desde ahora, para no acumular
+  // deriva. Con más de un intervalo de atraso, las lecturas vencidas se saltan
+  _nextRead += _interval;
+  if ((int32_t)(now - _nextRead) >= 0) {
+    uint32_t late = (now - _nextRead) / _interval + 1;
+    _missed += late;
+    _nextRead += late * _interval;
+  }
+
+  record(_source());
+  return true;
+}
+
+bool Sampler::record(float value) {
+  if (isnan(value)) {
+    _failures++;
+    return false;
+  }
+
+  if (_capacity == 0) {
+    return false;
+  }
+
+  uint16_t slot;
+
+  if (_count == _capacity) {
+    // Ventana llena: sale la muestra más antigua. Si era el extremo de una cola, es su frente
+    slot = _head;
+    _head = (_head + 1 == _capacity) ? 0 : _head + 1;
+    float oldest = _values[slot];
+
+    if (_maxSize > 0 && _maxQueue[_maxFront] == slot) {
+      _maxFront = (_maxFront + 1 == _capacity) ? 0 : _maxFront + 1;
+      _maxSize--;
+    }
+    if (_minSize > 0 && _minQueue[_minFront] == slot) {
+      _minFront = (_minFront + 1 == _capacity) ? 0 : _minFront + 1;
+      _minSize--;
+    }
+
+    // Welford con reemplazo: la cantidad de muestras no cambia
+    float previous = _mean;
+    _mean += (value - oldest) / _count;
+    _m2 += (value - oldest) * ((value - _mean) + (oldest - previous));
+
+  } else {
+    slot = _head + _count;
+    if (slot >= _capacity) {
+      slot -= _capacity;
+    }
+    _count++;
+
+    float delta = value - _mean;
+    _mean += delta / _count;
+    _m2 += delta * (value - _mean);
+  }
+
+  if (_m2 < 0) {
+    _m2 = 0;
+  }
+
+  _values[slot] = value;
+  push(_maxQueue, _maxFront, _maxSize, slot, true);
+  push(_minQueue, _minFront, _minSize, slot, false);
+
+  // Cada ventana completa se recalculan la media y la varianza, para que el error de redondeo de
+  // las restas no se acumule (sigue siendo tiempo constante por muestra, en promedio)
+  if (_count == _capacity && ++_sinceRefresh >= _capacity) {
+    refresh();
+  }
+
+  return true;
+}
+
+/*
+ * Agrega una posición al final de una cola monótona, quitando antes las que ya no pueden ser el
+ * extremo de la ventana (son más antiguas y no superan al nuevo valor).
+ */
+void Sampler::push(uint16_t* queue, uint16_t front, uint16_t& size, uint16_t slot, bool keepMax) {
+  float value = _values[slot];
+
+  while (size > 0) {
+    uint16_t back = front + size - 1;
+    if (back >= _capacity) {
+      back -= _capacity;
+    }
+
+    float last = _values[queue[back]];
+    if (keepMax ? last > value : last < value) {
+      break;
+    }
+    size--;
+  }
+
+  uint16_t end = front + size;
+  if (end >= _capacity) {
+    end -= _capacity;
+  }
+  queue[end] = slot;
+  size++;
+}
+
+void Sampler::refresh() {
+  float sum = 0;
+  for (uint16_t i = 0; i < _count; i++) {
+    sum += _values[i];
+  }
+  _mean = sum / _count;
+
+  float m2 = 0;
+  for (uint16_t i = 0; i < _count; i++) {
+    float d = _values[i] - _mean;
+    m2 += d * d;
+  }
+  _m2 = m2;
+  _sinceRefresh = 0;
+}
+
+SampleAggregate Sampler::aggregate() const {
+  SampleAggregate aggregate;
+  aggregate._variableLabel = _variableLabel;
+  aggregate._count = _count;
+  aggregate._mean = mean();
+  aggregate._min = minimum();
+  aggregate._max = maximum();
+  aggregate._variance = variance();
+  return aggregate;
+}
+
+uint16_t Sampler::count() const {
+  return _count;
+}
+
+float Sampler::mean() const {
+  return _count > 0 ? _mean : 0;
+}
+
+float Sampler::variance() const {
+  return _count > 1 ? _m2 / (_count - 1) : 0;
+}
+
+float Sampler::minimum() const {
+  return _minSize > 0 ? _values[_minQueue[_minFront]] : 0;
+}
+
+float Sampler::maximum() const {
+  return _maxSize > 0 ? _values[_maxQueue[_maxFront]] : 0;
+}
+
+uint32_t Sampler::failures() const {
+  return _failures;
+}
+
+uint32_t Sampler::missed() const {
+  return _missed;
+}
+
+const char* Sampler::label() const {
+  return _variableLabel;
+}
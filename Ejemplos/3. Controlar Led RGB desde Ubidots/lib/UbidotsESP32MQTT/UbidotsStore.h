@@ -0,0 +1,225 @@
+/**
+ * @file UbidotsStore.h
+ */
+
+#ifndef UbidotsStore_H
+#define UbidotsStore_H
+
+#include <Arduino.h>
+#include "UbidotsPayload.h"
+#include "UbidotsLabels.h"
+
+#define DEVICE_NONE           0xFF  //!< Valor sin dispositivo: recibe el de ubidotsPublish()
+#define MAX_DEVICES           32    //!< Dispositivos distintos con valores pendientes a la vez
+
+#define VALUE_DETAIL          0x01  //!< El valor tiene un ValueDetail
+#define VALUE_DEFERRED        0x02  //!< El valor tuvo que esperar por el límite de envío
+#define VALUE_DONE            0x04  //!< Enviado o descartado: sale en el próximo compact()
+#define VALUE_HELD            0x08  //!< Espera un token en este envío (compact() lo limpia)
+
+/**
+ * @brief Valor pendiente: 8 bytes, sin punteros.
+ */
+typedef struct StoredValue {
+  float _value;
+  uint8_t _labelId;     // Id en la LabelTable, o LABEL_NONE si el nombre está en el detalle
+  uint8_t _device;      // Índice en la tabla de dispositivos, o DEVICE_NONE
+  uint8_t _flags;
+} StoredValue;
+
+/**
+ * @brief Datos poco frecuentes de un valor: timestamp, contexto, o el nombre de una variable que
+ * no se pudo registrar.
+ */
+typedef struct ValueDetail {
+  const char* _variableLabel;     // Nombre de la variable si no está en la tabla, si no NULL
+  char* _context;
+  uint32_t _timestamp;
+  const ContextEntry* _entries;   // Contexto con tipo, en el buffer de entradas del store
+  uint8_t _entryCount;
+} ValueDetail;
+
+/**
+ * @brief Valores pendientes del cliente, en el orden en que se agregaron.
+ *
+ * Cada valor ocupa un StoredValue: id de la variable (ver LabelTable), valor, dispositivo (índice
+ * en una tabla de los dispositivos con valores pendientes) y marcas. Lo que usan pocos valores va
+ * en tablas aparte, paralelas a los valores, que se reservan recién al usarse: el detalle
+ * (ValueDetail), el momento en que entró a la cola (sólo con límite de envío) y las entradas de
+ * contexto. Así un sketch que sólo agrega valores ocupa 8 bytes por valor pendiente.
+ *
+ * Los valores nunca se reordenan: se marcan como enviados y compact() los quita, manteniendo el
+ * orden del resto.
+ */
+class ValueStore {
+  public:
+    ValueStore();
+    ~ValueStore();
+
+    /**
+     * @brief Reservar los valores. Las tablas aparte se reservan al usarse.
+     *
+     * @param capacity Cantidad máxima de valores pendientes
+     * @param maxEntries Cantidad máxima de entradas de contexto, entre todos los valores
+     * @return true Valores reservados
+     * @return false No hay memoria (la capacidad queda en 0)
+     */
+    bool begin(uint16_t capacity, uint16_t maxEntries);
+
+    /**
+     * @brief Agregar un valor al final.
+     *
+     * @param labelId Id de la variable, o LABEL_NONE si su nombre va en el detalle
+     * @param value Valor numérico
+     * @param deviceLabel Dispositivo (debe existir hasta publicar), o NULL
+     * @param detail Detalle a copiar, o NULL si no tiene
+     * @return true Valor agregado
+     * @return false Store lleno, demasiados dispositivos pendientes, o no hay memoria
+     */
+    bool add(uint8_t labelId, float value, const char* deviceLabel, const ValueDetail* detail);
+
+    /**
+     * @brief Agregar una entrada de contexto al último valor agregado.
+     *
+     * @param key Clave del contexto
+     * @return ContextEntry* Entrada a completar, o NULL si no hay valores, el buffer de entradas
+     * está lleno o no hay memoria
+     */
+    ContextEntry* addEntry(const char* key);
+
+    /**
+     * @brief Quitar el último valor agregado, con sus entradas de contexto.
+     */
+    void removeLast();
+
+    /**
+     * @brief Entradas de contexto libres.
+     */
+    uint16_t freeEntries() const;
+
+    /**
+     * @brief Pasar valores a la cola de salida: los que no tienen dispositivo reciben deviceLabel.
+     *
+     * @param first Primer valor
+     * @param end Valor siguiente al último
+     * @param deviceLabel Dispositivo de ubidotsPublish()
+     * @param now Tiempo actual en milisegundos (millis())
+     */
+    void queue(uint16_t first, uint16_t end, const char* deviceLabel, uint32_t now);
+
+    /**
+     * @brief Guardar el momento en que cada valor entra a la cola (ver queuedAt()).
+     *
+     * @return true Tabla reservada
+     * @return false No hay memoria
+     */
+    bool trackQueueTime();
+
+    /**
+     * @brief Primer valor desde first, antes de end, del dispositivo dado que no esté enviado ni
+     * esperando un token.
+     *
+     * @return uint16_t Índice del valor, o end si no hay
+     */
+    uint16_t next(uint16_t first, uint16_t end, uint8_t device) const;
+
+    /**
+     * @brief Marcar los primeros count valores de un dispositivo desde first (ver next()).
+     */
+    void mark(uint16_t first, uint16_t end, uint8_t device, uint16_t count, uint8_t flags);
+
+    /**
+     * @brief Quitar los valores marcados VALUE_DONE, manteniendo el orden del resto, y liberar sus
+     * entradas de contexto y dispositivos.
+     *
+     * @param end Fin de la cola de salida
+     * @return uint16_t Valores de la cola de salida que quedan
+     */
+    uint16_t compact(uint16_t end);
+
+    /**
+     * @brief Valor en una posición.
+     */
+    const StoredValue& at(uint16_t index) const;
+
+    /**
+     * @brief Detalle de un valor, o NULL si no tiene.
+     */
+    const ValueDetail* detail(uint16_t index) const;
+
+    /**
+     * @brief Nombre de la variable de un valor.
+     */
+    const char* label(const LabelTable& labels, uint16_t index) const;
+
+    /**
+     * @brief Nombre de un dispositivo de la tabla, o NULL para DEVICE_NONE.
+     */
+    const char* device(uint8_t device) const;
+
+    /**
+     * @brief Momento en que un valor entró a la cola, o 0 si no se guarda (ver trackQueueTime()).
+     */
+    uint32_t queuedAt(uint16_t index) const;
+
+    /**
+     * @brief Cantidad de valores.
+     */
+    uint16_t count() const;
+
+    /**
+     * @brief Cantidad máxima de valores.
+     */
+    uint16_t capacity() const;
+
+  private:
+    uint8_t findDevice(const char* deviceLabel);
+    ValueDetail* reserveDetail(uint16_t index);
+
+    StoredValue* _values;
+    ValueDetail* _details;      // Paralelo a _values, o NULL mientras ningún valor lo use
+    uint32_t* _queuedAt;        // Paralelo a _values, o NULL
+    ContextEntry* _entries;
+    const char** _devices;
+    uint16_t _count;
+    uint16_t _capacity;
+    uint16_t _entryCount;
+    uint16_t _maxEntries;
+    uint8_t _deviceCount;
+    uint8_t _deviceCapacity;
+};
+
+/**
+ * @brief Construir el diccionario JSON de Ubidots para valores del store (ver buildPayload()).
+ *
+ * Incluye los primeros count valores del dispositivo desde first (ver ValueStore::next()). Las
+ * variables registradas copian su fragmento precalculado.
+ *
+ * @param store Valores pendientes
+ * @param labels Tabla de variables registradas
+ * @param first Primer valor a considerar
+ * @param end Valor siguiente al último a considerar
+ * @param device Dispositivo de los valores
+ * @param count Cantidad de valores a incluir
+ * @param writer Escritor de destino
+ * @return Longitud del payload, o 0 si no pudo ser escrito completo
+ */
+size_t buildStorePayload(const ValueStore& store, const LabelTable& labels, uint16_t first,
+                         uint16_t end, uint8_t device, uint16_t count, PayloadWriter& writer);
+
+/**
+ * @brief Calcular cuántos valores del store caben en un mismo JSON (ver fitPayload()).
+ *
+ * @param store Valores pendientes
+ * @param labels Tabla de variables registradas
+ * @param first Primer valor a considerar
+ * @param end Valor siguiente al último a considerar
+ * @param device Dispositivo de los valores
+ * @param maxLength Largo máximo del JSON
+ * @param length Largo exacto del JSON con los valores que caben
+ * @return Cantidad de valores que caben (al menos 1 si hay valores)
+ */
+uint16_t fitStorePayload(const ValueStore& store, const LabelTable& labels, uint16_t first,
+                         uint16_t end, uint8_t device, size_t maxLength, size_t* length);
+
+#endif
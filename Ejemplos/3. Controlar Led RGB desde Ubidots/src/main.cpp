@@ -54,8 +54,6 @@
 
 #include <Arduino.h>          // Incluirla siempre al utilizar PlatformIO
                               // Always include it when using PlatformIO
-#include "delayMillis.h"      // Para utilizar Delays no-bloqueantes
-                              // Non-blocking Delays
 #include "UbidotsESP32MQTT.h" // Libreria de Ubidots MQTT
                               // Ubidots MQTT Library
 
@@ -103,20 +101,14 @@
 // Constructor principal, pasa como parámetro el Token de Ubidots
 /* Main Constructor, pass Ubidots Token as a parameter */
 Ubidots ubidots(TOKEN);
-
-// Delay para reconexión WiFi
-/* Delay for WiFi reconnection */
-DelayMillis t_reconexion;
-/* -------------------------------------------------------------------------- */
-
-/* ------------------ Variables Globales (Global Variables) ----------------- */
-bool wifi_on = false; // Indica si hay conexión activa a WiFi
-                      /* Indicates WiFi connection */
 /* -------------------------------------------------------------------------- */
 
 /* -------------- Declaracion Funciones (Function Declarations) ------------- */
 void callback(char* topic, uint8_t* payload, unsigned int length);  // Callback de Ubidots
                                                                     /* Ubidots Callback */
+void ledRojo(int32_t duty);   // Handlers de cada variable *Handlers of each variable*
+void ledVerde(int32_t duty);
+void ledAzul(int32_t duty);
 void callbackWifiConectado(WiFiEvent_t event);    // Se ejecuta cuando WiFi asoció dirección IP
                                                   /* WiFi connected Callback */
 void callbackWifiDesconectado(WiFiEvent_t event); // Se ejecuta cuando WiFi se desconecta
@@ -160,11 +152,6 @@ void setup() {
   /* Wait 2 seconds to open terminal */
   delay(2000);
 
-  // Iniciar delays
-  /* Start delays */
-  t_reconexion.empezar(3000); // Intentar reconectar cada 3s en caso de que no haya conexión
-                              /* Try to reconnect every 3s if there are no connection */
-
   // Asociar Callbacks del WiFi
   /* Associate WiFi Callbacks */
   WiFi.onEvent(callbackWifiConectado, SYSTEM_EVENT_STA_GOT_IP);
@@ -176,36 +163,26 @@ void setup() {
   /* Configure Ubidots client */
   ubidots.setDebug(true);   // Setear a TRUE para visualizar información útil
                             /* Set to TRUE to display useful info */
+  ubidots.setConnectTimeout(1000, 1); // Si el servidor no responde, loop() espera a lo más 1 s
+                                      /* If the server does not respond, loop() waits 1 s at most */
   ubidots.begin(callback);  // Iniciar Servidor y asociar Callback para recibir paquetes
                             /* Start Server and associate Callback to receive packages */
   ubidots.wifiConnection(SSID, PASS); // Iniciar conexión WiFi
                                       /* Start WiFi connection */
+
+  // Asociar un handler a cada variable. La librería se suscribe a ellas cada vez que se conecta, y
+  // entrega a cada handler el valor ya convertido a número
+  /** Associate a handler to each variable. The library subscribes to them every time it connects,
+   * and delivers to each handler the value already converted to number */
+  ubidots.on(DISPOSITIVO, VAR_LED_R, ledRojo);
+  ubidots.on(DISPOSITIVO, VAR_LED_G, ledVerde);
+  ubidots.on(DISPOSITIVO, VAR_LED_B, ledAzul);
 }
 // * ---------------------------------------------------------------------------
 
 // ANCHOR loop()
 // * ---------------------------------------------------------------------------
 void loop() {
-  // Revisar si el cliente MQTT y el WiFi se encuentran conectados
-  /* Check if the MQTT client and WiFi are connected */
-  if (!ubidots.connected() && wifi_on == true) {
-    
-    // Intentar reconectar cliente MQTT cada cierto tiempo de reintento (t_reconexion)
-    /* Try to reconnect MQTT client every t_reconexion time */
-    if (t_reconexion.finalizado()) {
-      ubidots.reconnect();
-      t_reconexion.repetir(); // Reiniciar tiempo *Restart time*
-    }
-  
-    // Suscribirse, si el cliente se conectó
-    /* Subscribe, if the client is connected */
-    if (ubidots.connected()) {
-      ubidots.ubidotsSubscribe(DISPOSITIVO, VAR_LED_R);
-      ubidots.ubidotsSubscribe(DISPOSITIVO, VAR_LED_G);
-      ubidots.ubidotsSubscribe(DISPOSITIVO, VAR_LED_B);
-    }
-  }
-
   // loop() debe ser llamado constantemente para verificar conexión al servidor y revisar mensajes
   // entrantes (mensajes de un Subscribe)
   /* loop() must be constantly called to verify server connection and check incoming messages */
@@ -216,69 +193,40 @@ void loop() {
 // ANCHOR Callback Ubidots
 // * ---------------------------------------------------------------------------
 void callback(char* topic, uint8_t* payload, unsigned int length) {
-  // NOTA: Recordar que Ubidots envía los datos en forma de texto, por lo tanto, para comparar
-  // números por ejemplo, se deben comparar CARACTERES, no números.
-  /** Remember: Ubidots sends data in text type, therefore, to compare numbers, CHARACTERS must be
-   * compared, not numbers. */
-  
-  // Buffer que almacena mensaje de Ubidots. 
-  // Longitud 4, dada por el mayor número (255 = 3 caracteres) más el caracter nulo '\0'
-  /**
-   * Buffer that stores message of Ubidots.
-   * Length 4, given by the largest number (255 = 3 characters) plus the null character '\0'
-   */
-  char buffer[4]; 
-  uint8_t duty; // Variable de tipo entero 8 bits, que almacenará el número correspondiente del mensaje
-                /* 8 bits int variable, which will store the corresponding number of the message */  
-
-  Serial.println("[UDOTS] Mensaje recibido!");
-
-  // Copiar el mensaje entrante al buffer, para posteriormente convertirlo a número
-  /* Copy the incoming message to the buffer, to later convert it to number */
-  for (uint8_t i = 0; i < length; i++) {
-    buffer[i] = (char)payload[i];
-  }
-  buffer[length] = '\0';
-
-  duty = atoi(buffer);  // Convertir mensaje de tipo texto, a número decimal
-                        /* Convert text message, to decimal number */
-  
-  // Sentencia simple para revisar si el mensaje que llegó, corresponde a cierto tópico
-  /* Simple way to check if the received message, corresponds to a topic */
-  if (strstr(topic, VAR_LED_R) != NULL)
-  {    
-    Serial.printf("[INFO] Led Rojo = %u\n\n", duty);
-    ledcWrite(LED_R_CHANNEL, duty); // Cambiar ciclo de trabajo del canal LED R
-                                    /* Change duty cycle of channel LED R */
-  }
-
-  if (strstr(topic, VAR_LED_G) != NULL)
-  {
-    Serial.printf("[INFO] Led Verde = %u\n\n", duty);
-    ledcWrite(LED_G_CHANNEL, duty); // Cambiar ciclo de trabajo del canal LED G
-                                    /* Change duty cycle of channel LED G */
-  }
-
-  if (strstr(topic, VAR_LED_B) != NULL)
-  {
-    Serial.printf("[INFO] Led Azul = %u\n\n", duty);
-    ledcWrite(LED_B_CHANNEL, duty); // Cambiar ciclo de trabajo del canal LED B
-                                    /* Change duty cycle of channel LED B */
-  }
+  // Función vacia. Los mensajes de las variables suscritas llegan a sus handlers
+  /* Empty function. Messages of the subscribed variables arrive to their handlers */
+}
+
+// Cada handler recibe el valor ya convertido a entero (0 a 255 desde el Widget Deslizador)
+/* Each handler receives the value already converted to integer (0 to 255 from the Slider Widget) */
+void ledRojo(int32_t duty) {
+  Serial.printf("[INFO] Led Rojo = %d\n\n", duty);
+  ledcWrite(LED_R_CHANNEL, duty); // Cambiar ciclo de trabajo del canal LED R
+                                  /* Change duty cycle of channel LED R */
+}
+
+void ledVerde(int32_t duty) {
+  Serial.printf("[INFO] Led Verde = %d\n\n", duty);
+  ledcWrite(LED_G_CHANNEL, duty); // Cambiar ciclo de trabajo del canal LED G
+                                  /* Change duty cycle of channel LED G */
+}
+
+void ledAzul(int32_t duty) {
+  Serial.printf("[INFO] Led Azul = %d\n\n", duty);
+  ledcWrite(LED_B_CHANNEL, duty); // Cambiar ciclo de trabajo del canal LED B
+                                  /* Change duty cycle of channel LED B */
 }
 // * ---------------------------------------------------------------------------
 
 // ANCHOR Callbacks WiFi
 // * ---------------------------------------------------------------------------
 void callbackWifiConectado(WiFiEvent_t event) {
-  wifi_on = true;
   digitalWrite(LED_WIFI, HIGH);
   Serial.print("[WIFI] WiFi Conectado. IP: ");
   Serial.println(WiFi.localIP());
 }
 
 void callbackWifiDesconectado(WiFiEvent_t event) {
-  wifi_on = false;
   digitalWrite(LED_WIFI, LOW);
   Serial.print("[WIFI] WiFi Desconectado!");
 }
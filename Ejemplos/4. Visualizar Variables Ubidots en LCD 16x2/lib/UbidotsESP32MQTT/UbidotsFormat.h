@@ -0,0 +1,28 @@
+/**
+ * @file UbidotsFormat.h
+ */
+
+#ifndef UbidotsFormat_H
+#define UbidotsFormat_H
+
+#include <Arduino.h>
+
+#define FORMAT_MAX_DECIMALS   9   //!< Máxima cantidad de decimales de ubidotsFormatFixed()
+#define FORMAT_FIXED_SIZE     32  //!< Tamaño mínimo del buffer de ubidotsFormatFixed()
+
+/**
+ * @brief Escribir un float con una cantidad fija de decimales, sin usar printf.
+ *
+ * Entrega el mismo texto que snprintf("%.*f"): el valor exacto del float se escala por
+ * 10^decimals con aritmética entera, se redondea al par más cercano y se escribe de a dos dígitos
+ * por tabla. No escribe el caracter nulo.
+ *
+ * @param value Valor a escribir
+ * @param decimals Cantidad de decimales (0 a FORMAT_MAX_DECIMALS)
+ * @param text Buffer de al menos FORMAT_FIXED_SIZE caracteres
+ * @return Largo del texto escrito, o 0 si el valor no se puede escribir de esta forma (NaN,
+ *         infinito, o demasiado grande para los decimales pedidos); en ese caso, usar snprintf
+ */
+size_t ubidotsFormatFixed(float value, uint8_t decimals, char* text);
+
+#endif
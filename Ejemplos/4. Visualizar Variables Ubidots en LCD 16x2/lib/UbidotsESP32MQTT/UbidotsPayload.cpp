@@ -0,0 +1,361 @@
+/**
+ * @file UbidotsPayload.cpp
+ */
+
+#include "UbidotsPayload.h"
+#include "UbidotsFormat.h"
+#include <stdio.h>
+#include <string.h>
+
+PayloadWriter::PayloadWriter() {
+  _length = 0;
+  _overflow = false;
+}
+
+bool PayloadWriter::append(const char* text) {
+  return append(text, strlen(text));
+}
+
+bool PayloadWriter::append(const char* text, size_t length) {
+  if (_overflow || !write(text, length)) {
+    _overflow = true;
+    return false;
+  }
+
+  _length += length;
+  return true;
+}
+
+bool PayloadWriter::append(char c) {
+  return append(&c, 1);
+}
+
+bool PayloadWriter::appendUInt(uint32_t value) {
+  char digits[10];
+  uint8_t n = sizeof(digits);
+
+  do {
+    digits[--n] = '0' + (value % 10);
+    value /= 10;
+  } while (value != 0);
+
+  return append(digits + n, sizeof(digits) - n);
+}
+
+bool PayloadWriter::appendEscaped(const char* text) {
+  static const char HEX_DIGITS[] = "0123456789abcdef";
+  const char* run = text;
+
+  // Los tramos sin caracteres especiales se agregan de una vez
+  for (; *text != '\0'; text++) {
+    uint8_t c = *text;
+
+    if (c >= 0x20 && c != '"' && c != '\\') {
+      continue;
+    }
+
+    append(run, text - run);
+    run = text + 1;
+
+    if (c == '"' || c == '\\') {
+      append('\\');
+      append((char)c);
+    } else if (c == '\n') {
+      append("\\n");
+    } else if (c == '\r') {
+      append("\\r");
+    } else if (c == '\t') {
+      append("\\t");
+    } else {
+      char escape[6] = { '\\', 'u', '0', '0', HEX_DIGITS[c >> 4], HEX_DIGITS[c & 0x0F] };
+      append(escape, sizeof(escape));
+    }
+  }
+
+  return append(run, text - run);
+}
+
+bool PayloadWriter::appendFloat(float value, uint8_t decimals) {
+  // Suficiente para FLT_MAX (39 dígitos) más signo, punto y FORMAT_MAX_DECIMALS decimales
+  char text[52];
+
+  if (decimals > FORMAT_MAX_DECIMALS) {
+    decimals = FORMAT_MAX_DECIMALS;
+  }
+
+  size_t fixed = ubidotsFormatFixed(value, decimals, text);
+
+  if (fixed > 0) {
+    return append(text, fixed);
+  }
+
+  // NaN, infinito o valores enormes: poco comunes en telemetría, se dejan a printf
+  int n = snprintf(text, sizeof(text), "%.*f", decimals, value);
+
+  if (n < 0 || (size_t)n >= sizeof(text)) {
+    _overflow = true;
+    return false;
+  }
+
+  return append(text, n);
+}
+
+size_t PayloadWriter::length() const {
+  return _length;
+}
+
+bool PayloadWriter::overflowed() const {
+  return _overflow;
+}
+
+PayloadBuffer::PayloadBuffer(char* buffer, size_t size) {
+  _buffer = buffer;
+  _size = size;
+
+  if (size > 0) {
+    _buffer[0] = '\0';
+  } else {
+    append("", 1);  // Sin espacio ni para el caracter nulo: marcar desborde
+  }
+}
+
+const char* PayloadBuffer::c_str() const {
+  return _buffer;
+}
+
+bool PayloadBuffer::write(const char* data, size_t length) {
+  size_t used = this->length();
+
+  if (used + length >= _size) {
+    return false;
+  }
+
+  memcpy(_buffer + used, data, length);
+  _buffer[used + length] = '\0';
+  return true;
+}
+
+bool PayloadCounter::write(const char* /* data */, size_t /* length */) {
+  return true;
+}
+
+PayloadStream::PayloadStream(Print& out) : _out(out) {
+  _used = 0;
+}
+
+bool PayloadStream::flush() {
+  if (_used == 0) {
+    return true;
+  }
+
+  size_t sent = _out.write((const uint8_t*)_chunk, _used);
+  bool ok = (sent == _used);
+  _used = 0;
+  return ok;
+}
+
+bool PayloadStream::write(const char* data, size_t length) {
+  while (length > 0) {
+    size_t n = PAYLOAD_CHUNK_SIZE - _used;
+
+    if (n > length) {
+      n = length;
+    }
+
+    memcpy(_chunk + _used, data, n);
+    _used += n;
+    data += n;
+    length -= n;
+
+    if (_used == PAYLOAD_CHUNK_SIZE && !flush()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static void appendContextEntry(PayloadWriter& writer, const ContextEntry& entry) {
+  writer.append('"');
+  writer.appendEscaped(entry._key);
+  writer.append("\": ");
+
+  if (entry._type == CONTEXT_NUMBER) {
+    writer.appendFloat(entry._number, entry._decimals);
+  } else {
+    writer.append('"');
+    writer.appendEscaped(entry._text);
+    writer.append('"');
+  }
+}
+
+void appendValueEnd(PayloadWriter& writer, uint32_t timestamp, const char* context,
+                    const ContextEntry* entries, uint8_t entryCount) {
+  if (timestamp != 0) {
+    writer.append(", \"timestamp\": ");
+    writer.appendUInt(timestamp);
+    writer.append("000");  // Ubidots espera el timestamp en milisegundos
+  }
+
+  if (context != NULL || entryCount > 0) {
+    writer.append(", \"context\": {");
+
+    if (context != NULL) {
+      writer.append(context);
+    }
+
+    for (uint8_t e = 0; e < entryCount; e++) {
+      if (e > 0 || context != NULL) {
+        writer.append(", ");
+      }
+      appendContextEntry(writer, entries[e]);
+    }
+
+    writer.append('}');
+  }
+
+  writer.append("}]");
+}
+
+size_t buildPayload(const Value* values, uint16_t count, PayloadWriter& writer) {
+  writer.append('{');
+
+  for (uint16_t i = 0; i < count; i++) {
+    const Value* v = values + i;
+
+    if (i > 0) {
+      writer.append(", ");
+    }
+
+    writer.append('"');
+    writer.append(v->_variableLabel);
+    writer.append("\": [{\"value\": ");
+    writer.appendFloat(v->_value, 2);
+    appendValueEnd(writer, v->_timestamp, v->_context, v->_entries, v->_entryCount);
+  }
+
+  writer.append('}');
+  return writer.overflowed() ? 0 : writer.length();
+}
+
+uint16_t fitPayload(const Value* values, uint16_t count, size_t maxLength, size_t* length) {
+  size_t total = 2;  // "{}"
+  uint16_t n = 0;
+
+  while (n < count) {
+    PayloadCounter counter;
+    // Cada valor aporta su fragmento (sin las llaves) más el separador ", "
+    size_t next = total + buildPayload(values + n, 1, counter) - 2 + (n > 0 ? 2 : 0);
+
+    if (next > maxLength && n > 0) {
+      break;
+    }
+
+    total = next;
+    n++;
+  }
+
+  *length = total;
+  return n;
+}
+
+bool sameDevice(const char* a, const char* b) {
+  return a == b || (a != NULL && b != NULL && strcmp(a, b) == 0);
+}
+
+static void appendSeriesHeader(PayloadWriter& writer, const char* label) {
+  writer.append('"');
+  writer.append(label);
+  writer.append("\": [");
+}
+
+static void appendSample(PayloadWriter& writer, const Sample& sample) {
+  char millis[3];
+
+  millis[0] = '0' + sample._millis / 100;
+  millis[1] = '0' + (sample._millis / 10) % 10;
+  millis[2] = '0' + sample._millis % 10;
+
+  writer.append("{\"value\": ");
+  writer.appendFloat(sample._value, 2);
+  writer.append(", \"timestamp\": ");
+  writer.appendUInt(sample._timestamp);
+  writer.append(millis, 3);
+  writer.append('}');
+}
+
+size_t buildSeriesPayload(SeriesCursor from, SeriesCursor to, PayloadWriter& writer) {
+  bool first = true;
+
+  writer.append('{');
+
+  for (SampleSeries* s = from._series; s != NULL; s = s->next()) {
+    uint16_t begin = (s == from._series) ? from._sample : 0;
+    uint16_t end = (s == to._series) ? to._sample : s->count();
+
+    if (begin < end) {
+      if (!first) {
+        writer.append(", ");
+      }
+      first = false;
+
+      appendSeriesHeader(writer, s->label());
+
+      for (uint16_t i = begin; i < end; i++) {
+        if (i > begin) {
+          writer.append(", ");
+        }
+        appendSample(writer, s->at(i));
+      }
+
+      writer.append(']');
+    }
+
+    if (s == to._series) {
+      break;
+    }
+  }
+
+  writer.append('}');
+  return writer.overflowed() ? 0 : writer.length();
+}
+
+uint16_t fitSeriesPayload(SeriesCursor from, size_t maxLength, SeriesCursor* to, size_t* length) {
+  size_t total = 2;  // "{}"
+  uint16_t n = 0;
+
+  for (SampleSeries* s = from._series; s != NULL; s = s->next()) {
+    uint16_t begin = (s == from._series) ? from._sample : 0;
+
+    for (uint16_t i = begin; i < s->count(); i++) {
+      PayloadCounter counter;
+      appendSample(counter, s->at(i));
+      size_t next = total + counter.length();
+
+      if (i == begin) {
+        // Primera muestra de la serie: se agrega el encabezado, el cierre "]" y el separador
+        PayloadCounter header;
+        appendSeriesHeader(header, s->label());
+        next += header.length() + 1 + (n > 0 ? 2 : 0);
+
+      } else {
+        next += 2;
+      }
+
+      if (next > maxLength && n > 0) {
+        to->_series = s;
+        to->_sample = i;
+        *length = total;
+        return n;
+      }
+
+      total = next;
+      n++;
+    }
+  }
+
+  to->_series = NULL;
+  to->_sample = 0;
+  *length = total;
+  return n;
+}
@@ -0,0 +1,93 @@
+/**
+ * @file UbidotsSeries.h
+ */
+
+#ifndef UbidotsSeries_H
+#define UbidotsSeries_H
+
+#include <Arduino.h>
+
+typedef struct Sample {
+  float _value;
+  uint32_t _timestamp;  // Unix Timestamp en segundos
+  uint16_t _millis;     // Milisegundos dentro del segundo (0 a 999)
+} Sample;
+
+/**
+ * @brief Serie de muestras con timestamp para una variable de Ubidots.
+ *
+ * Las muestras se guardan en un buffer circular: registrar una muestra sólo copia 12 bytes, y si
+ * la serie está llena se descarta la muestra más antigua. Al publicar, todas las muestras de la
+ * serie se envían como un único arreglo de la variable: "var": [{...}, {...}].
+ */
+class SampleSeries {
+  public:
+    /**
+     * @brief Construir una nueva serie.
+     *
+     * @param variableLabel Nombre de la variable
+     * @param capacity Cantidad máxima de muestras entre publicaciones
+     */
+    SampleSeries(const char* variableLabel, uint16_t capacity);
+    ~SampleSeries();
+
+    /**
+     * @brief Registrar una muestra.
+     *
+     * @param value Valor numérico
+     * @param timestamp Valor Unix Timestamp en segundos
+     * @param millis Milisegundos dentro del segundo (0 a 999; desde 1000, los segundos completos
+     * se suman al timestamp)
+     */
+    void record(float value, uint32_t timestamp, uint16_t millis = 0);
+
+    /**
+     * @brief Descartar todas las muestras registradas.
+     */
+    void clear();
+
+    /**
+     * @brief Descartar las muestras más antiguas.
+     *
+     * @param count Cantidad de muestras a descartar (si supera las registradas, se vacía la serie)
+     */
+    void discard(uint16_t count);
+
+    /**
+     * @brief Cantidad de muestras registradas.
+     */
+    uint16_t count() const;
+
+    /**
+     * @brief Cantidad de muestras descartadas por llenarse la serie.
+     */
+    uint32_t dropped() const;
+
+    /**
+     * @brief Obtener una muestra, en orden de registro (0 es la más antigua).
+     */
+    const Sample& at(uint16_t index) const;
+
+    /**
+     * @brief Nombre de la variable.
+     */
+    const char* label() const;
+
+    /**
+     * @brief Siguiente serie registrada en el cliente, o NULL.
+     */
+    SampleSeries* next() const;
+
+  private:
+    friend class Ubidots;
+
+    const char* _variableLabel;
+    Sample* _samples;
+    uint16_t _capacity;
+    uint16_t _head;
+    uint16_t _count;
+    uint32_t _dropped;
+    SampleSeries* _next;
+};
+
+#endif
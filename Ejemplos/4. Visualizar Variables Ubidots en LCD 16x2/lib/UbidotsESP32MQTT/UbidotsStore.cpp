@@ -0,0 +1,366 @@
+/**
+ * @file UbidotsStore.cpp
+ */
+
+#include "UbidotsStore.h"
+#include <string.h>
+
+#define DEVICE_TABLE_GROWTH   4
+
+ValueStore::ValueStore() {
+  _values = NULL;
+  _details = NULL;
+  _queuedAt = NULL;
+  _entries = NULL;
+  _devices = NULL;
+  _count = 0;
+  _capacity = 0;
+  _entryCount = 0;
+  _maxEntries = 0;
+  _deviceCount = 0;
+  _deviceCapacity = 0;
+}
+
+ValueStore::~ValueStore() {
+  free(_values);
+  free(_details);
+  free(_queuedAt);
+  free(_entries);
+  free(_devices);
+}
+
+bool ValueStore::begin(uint16_t capacity, uint16_t maxEntries) {
+  _values = (StoredValue *)malloc(capacity*sizeof(StoredValue));
+  _capacity = (_values != NULL) ? capacity : 0;
+  _maxEntries = maxEntries;
+  return _values != NULL;
+}
+
+bool ValueStore::add(uint8_t labelId, float value, const char* deviceLabel,
+                     const ValueDetail* detail) {
+  if (_count >= _capacity) {
+    return false;
+  }
+
+  uint8_t device = findDevice(deviceLabel);
+
+  if (deviceLabel != NULL && device == DEVICE_NONE) {
+    return false;
+  }
+
+  StoredValue* v = _values + _count;
+  v->_value = value;
+  v->_labelId = labelId;
+  v->_device = device;
+  v->_flags = 0;
+
+  if (detail != NULL) {
+    ValueDetail* d = reserveDetail(_count);
+
+    if (d == NULL) {
+      return false;
+    }
+
+    *d = *detail;
+    d->_entries = NULL;
+    d->_entryCount = 0;
+  }
+
+  _count++;
+  return true;
+}
+
+ContextEntry* ValueStore::addEntry(const char* key) {
+  if (_count == 0 || _entryCount >= _maxEntries) {
+    return NULL;
+  }
+
+  if (_entries == NULL) {
+    _entries = (ContextEntry *)malloc(_maxEntries*sizeof(ContextEntry));
+
+    if (_entries == NULL) {
+      return NULL;
+    }
+  }
+
+  ValueDetail* d = reserveDetail(_count - 1);
+
+  // Las entradas de cada valor son consecutivas en el buffer, y el detalle guarda cuántas son
+  if (d == NULL || d->_entryCount == 0xFF) {
+    return NULL;
+  }
+
+  if (d->_entryCount == 0) {
+    d->_entries = _entries + _entryCount;
+  }
+
+  ContextEntry* entry = _entries + _entryCount;
+  entry->_key = key;
+  _entryCount++;
+  d->_entryCount++;
+  return entry;
+}
+
+void ValueStore::removeLast() {
+  if (_count == 0) {
+    return;
+  }
+
+  _count--;
+
+  // Las entradas del último valor son las últimas del buffer
+  if (_values[_count]._flags & VALUE_DETAIL) {
+    _entryCount -= _details[_count]._entryCount;
+  }
+}
+
+uint16_t ValueStore::freeEntries() const {
+  return _maxEntries - _entryCount;
+}
+
+ValueDetail* ValueStore::reserveDetail(uint16_t index) {
+  if (_details == NULL) {
+    _details = (ValueDetail *)malloc(_capacity*sizeof(ValueDetail));
+
+    if (_details == NULL) {
+      return NULL;
+    }
+  }
+
+  ValueDetail* d = _details + index;
+
+  if (!(_values[index]._flags & VALUE_DETAIL)) {
+    memset(d, 0, sizeof(ValueDetail));
+    _values[index]._flags |= VALUE_DETAIL;
+  }
+
+  return d;
+}
+
+void ValueStore::queue(uint16_t first, uint16_t end, const char* deviceLabel, uint32_t now) {
+  uint8_t device = findDevice(deviceLabel);
+
+  for (uint16_t i = first; i < end; i++) {
+    if (_values[i]._device == DEVICE_NONE) {
+      _values[i]._device = device;
+    }
+
+    if (_queuedAt != NULL) {
+      _queuedAt[i] = now;
+    }
+  }
+}
+
+bool ValueStore::trackQueueTime() {
+  if (_queuedAt == NULL && _capacity > 0) {
+    _queuedAt = (uint32_t *)calloc(_capacity, sizeof(uint32_t));
+  }
+
+  return _queuedAt != NULL;
+}
+
+uint8_t ValueStore::findDevice(const char* deviceLabel) {
+  if (deviceLabel == NULL) {
+    return DEVICE_NONE;
+  }
+
+  for (uint8_t i = 0; i < _deviceCount; i++) {
+    if (sameDevice(_devices[i], deviceLabel)) {
+      return i;
+    }
+  }
+
+  if (_deviceCount >= MAX_DEVICES) {
+    return DEVICE_NONE;
+  }
+
+  if (_deviceCount == _deviceCapacity) {
+    uint8_t capacity = _deviceCapacity + DEVICE_TABLE_GROWTH;
+    const char** devices = (const char**)realloc(_devices, capacity*sizeof(const char*));
+
+    if (devices == NULL) {
+      return DEVICE_NONE;
+    }
+
+    _devices = devices;
+    _deviceCapacity = capacity;
+  }
+
+  _devices[_deviceCount] = deviceLabel;
+  return _deviceCount++;
+}
+
+uint16_t ValueStore::next(uint16_t first, uint16_t end, uint8_t device) const {
+  while (first < end && (_values[first]._device != device ||
+                         (_values[first]._flags & (VALUE_DONE | VALUE_HELD)))) {
+    first++;
+  }
+
+  return first;
+}
+
+void ValueStore::mark(uint16_t first, uint16_t end, uint8_t device, uint16_t count,
+                      uint8_t flags) {
+  for (uint16_t i = next(first, end, device); i < end && count > 0; i = next(i + 1, end, device)) {
+    _values[i]._flags |= flags;
+    count--;
+  }
+}
+
+uint16_t ValueStore::compact(uint16_t end) {
+  uint8_t map[MAX_DEVICES];
+  uint16_t kept = 0;
+  uint16_t keptQueue = 0;
+  uint16_t entries = 0;
+
+  memset(map, DEVICE_NONE, sizeof(map));
+
+  for (uint16_t i = 0; i < _count; i++) {
+    StoredValue v = _values[i];
+
+    if (v._flags & VALUE_DONE) {
+      continue;
+    }
+
+    v._flags &= ~VALUE_HELD;
+
+    if (v._flags & VALUE_DETAIL) {
+      ValueDetail d = _details[i];
+
+      // Los valores no se reordenan, así que sus entradas tampoco: basta moverlas hacia el inicio
+      if (d._entryCount > 0 && d._entries != _entries + entries) {
+        memmove(_entries + entries, d._entries, d._entryCount*sizeof(ContextEntry));
+        d._entries = _entries + entries;
+      }
+      entries += d._entryCount;
+      _details[kept] = d;
+    }
+
+    if (_queuedAt != NULL) {
+      _queuedAt[kept] = _queuedAt[i];
+    }
+
+    if (v._device != DEVICE_NONE) {
+      map[v._device] = 0;
+    }
+
+    _values[kept++] = v;
+    keptQueue += (i < end);
+  }
+
+  // Los dispositivos sin valores salen de la tabla; el resto mantiene su orden
+  uint8_t devices = 0;
+
+  for (uint8_t d = 0; d < _deviceCount; d++) {
+    if (map[d] != DEVICE_NONE) {
+      _devices[devices] = _devices[d];
+      map[d] = devices++;
+    }
+  }
+
+  for (uint16_t i = 0; i < kept; i++) {
+    if (_values[i]._device != DEVICE_NONE) {
+      _values[i]._device = map[_values[i]._device];
+    }
+  }
+
+  _count = kept;
+  _entryCount = entries;
+  _deviceCount = devices;
+  return keptQueue;
+}
+
+const StoredValue& ValueStore::at(uint16_t index) const {
+  return _values[index];
+}
+
+const ValueDetail* ValueStore::detail(uint16_t index) const {
+  return (_values[index]._flags & VALUE_DETAIL) ? _details + index : NULL;
+}
+
+const char* ValueStore::label(const LabelTable& labels, uint16_t index) const {
+  const StoredValue& v = _values[index];
+  return (v._labelId != LABEL_NONE) ? labels.label(v._labelId) : _details[index]._variableLabel;
+}
+
+const char* ValueStore::device(uint8_t device) const {
+  return (device != DEVICE_NONE) ? _devices[device] : NULL;
+}
+
+uint32_t ValueStore::queuedAt(uint16_t index) const {
+  return (_queuedAt != NULL) ? _queuedAt[index] : 0;
+}
+
+uint16_t ValueStore::count() const {
+  return _count;
+}
+
+uint16_t ValueStore::capacity() const {
+  return _capacity;
+}
+
+static void appendStoredValue(PayloadWriter& writer, const ValueStore& store,
+                              const LabelTable& labels, uint16_t index) {
+  const StoredValue& v = store.at(index);
+  const ValueDetail* d = store.detail(index);
+
+  if (v._labelId != LABEL_NONE) {
+    writer.append(labels.fragment(v._labelId), labels.fragmentLength(v._labelId));
+  } else {
+    writer.append('"');
+    writer.append(d->_variableLabel);
+    writer.append("\": [{\"value\": ");
+  }
+
+  writer.appendFloat(v._value, 2);
+
+  if (d != NULL) {
+    appendValueEnd(writer, d->_timestamp, d->_context, d->_entries, d->_entryCount);
+  } else {
+    writer.append("}]");
+  }
+}
+
+size_t buildStorePayload(const ValueStore& store, const LabelTable& labels, uint16_t first,
+                         uint16_t end, uint8_t device, uint16_t count, PayloadWriter& writer) {
+  uint16_t n = 0;
+
+  writer.append('{');
+
+  for (uint16_t i = store.next(first, end, device); i < end && n < count;
+       i = store.next(i + 1, end, device)) {
+    if (n > 0) {
+      writer.append(", ");
+    }
+
+    appendStoredValue(writer, store, labels, i);
+    n++;
+  }
+
+  writer.append('}');
+  return writer.overflowed() ? 0 : writer.length();
+}
+
+uint16_t fitStorePayload(const ValueStore& store, const LabelTable& labels, uint16_t first,
+                         uint16_t end, uint8_t device, size_t maxLength, size_t* length) {
+  size_t total = 2;  // "{}"
+  uint16_t n = 0;
+
+  for (uint16_t i = store.next(first, end, device); i < end; i = store.next(i + 1, end, device)) {
+    PayloadCounter counter;
+    appendStoredValue(counter, store, labels, i);
+
+    // Cada valor aporta su fragmento más el separador ", "
+    size_t next = total + counter.length() + (n > 0 ? 2 : 0);
+
+    if (next > maxLength && n > 0) {
+      break;
+    }
+
+    total = next;
+    n++;
+  }
+
+  *length = total;
+  return n;
+}
@@ -76,8 +76,6 @@
 
 #include <Arduino.h>            // Incluirla siempre al utilizar PlatformIO
                                 // Always include it when using PlatformIO
-#include "delayMillis.h"        // Para utilizar Delays no-bloqueantes
-                                // Non-blocking Delays
 #include "UbidotsESP32MQTT.h"   // Libreria de Ubidots MQTT
                                 // Ubidots MQTT Library
 #include "LiquidCrystal_I2C.h"  // Libreria para manipular LCD con adaptador I2C
@@ -117,10 +115,6 @@
 /* Main Constructor, pass Ubidots Token as a parameter */
 Ubidots ubidots(TOKEN);
 
-// Delay para reconexión WiFi
-/* Delay for WiFi reconnection */
-DelayMillis t_reconexion;
-
 // NOTE Config. LCD
 // Constructor para el lcd, pasa como parámetro la dirección I2C, filas y columnas
 // La dirección suele ser 0x27 o 0x3F, ya que se utiliza el mismo chip para la mayoría de pantallas
@@ -131,11 +125,6 @@ DelayMillis t_reconexion;
 LiquidCrystal_I2C lcd(0x27, 16, 2);
 /* -------------------------------------------------------------------------- */
 
-/* ------------------ Variables Globales (Global Variables) ----------------- */
-bool wifi_on = false; // Indica si hay conexión activa a WiFi
-                      /* Indicates WiFi connection */
-/* -------------------------------------------------------------------------- */
-
 /* -------------- Declaracion Funciones (Function Declarations) ------------- */
 void callback(char* topic, uint8_t* payload, unsigned int length);  // Callback de Ubidots
                                                                     /* Ubidots Callback */
@@ -175,11 +164,6 @@ void setup() {
   /* Wait 2 seconds to open terminal */
   delay(2000);
 
-  // Iniciar delays
-  /* Start delays */
-  t_reconexion.empezar(3000); // Intentar reconectar cada 3s en caso de que no haya conexión
-                              /* Try to reconnect every 3s if there are no connection */
-
   // Asociar Callbacks del WiFi
   /* Associate WiFi Callbacks */
   WiFi.onEvent(callbackWifiConectado, SYSTEM_EVENT_STA_GOT_IP);
@@ -191,35 +175,24 @@ void setup() {
   /* Configure Ubidots client */
   ubidots.setDebug(true);   // Setear a TRUE para visualizar información útil
                             /* Set to TRUE to display useful info */
+  ubidots.setConnectTimeout(1000, 1); // Si el servidor no responde, loop() espera a lo más 1 s
+                                      /* If the server does not respond, loop() waits 1 s at most */
   ubidots.begin(callback);  // Iniciar Servidor y asociar Callback para recibir paquetes
                             /* Start Server and associate Callback to receive packages */
   ubidots.wifiConnection(SSID, PASS); // Iniciar conexión WiFi
                                       /* Start WiFi connection */
+
+  // Registrar suscripciones una sola vez. loop() se encarga de conectar, reconectar y renovarlas
+  /** Register subscriptions only once. loop() takes care of connecting, reconnecting and renewing
+   * them */
+  ubidots.ubidotsSubscribe(DISPOSITIVO, VAR_INPUT_1);
+  ubidots.ubidotsSubscribe(DISPOSITIVO, VAR_INPUT_2);
 }
 // * ---------------------------------------------------------------------------
 
 // ANCHOR loop()
 // * ---------------------------------------------------------------------------
 void loop() {
-  // Revisar si el cliente MQTT y el WiFi se encuentran conectados
-  /* Check if the MQTT client and WiFi are connected */
-  if (!ubidots.connected() && wifi_on == true) {
-    
-    // Intentar reconectar cliente MQTT cada cierto tiempo de reintento (t_reconexion)
-    /* Try to reconnect MQTT client every t_reconexion time */
-    if (t_reconexion.finalizado()) {
-      ubidots.reconnect();
-      t_reconexion.repetir(); // Reiniciar tiempo *Restart time*
-    }
-  
-    // Suscribirse, si el cliente se conectó
-    /* Subscribe, if the client is connected */
-    if (ubidots.connected()) {
-      ubidots.ubidotsSubscribe(DISPOSITIVO, VAR_INPUT_1);
-      ubidots.ubidotsSubscribe(DISPOSITIVO, VAR_INPUT_2);
-    }
-  }
-
   // loop() debe ser llamado constantemente para verificar conexión al servidor y revisar mensajes
   // entrantes (mensajes de un Subscribe)
   /* loop() must be constantly called to verify server connection and check incoming messages */
@@ -305,14 +278,12 @@ void callback(char* topic, uint8_t* payload, unsigned int length) {
 // ANCHOR Callbacks WiFi
 // * ---------------------------------------------------------------------------
 void callbackWifiConectado(WiFiEvent_t event) {
-  wifi_on = true;
   digitalWrite(LED_WIFI, HIGH);
   Serial.print("[WIFI] WiFi Conectado. IP: ");
   Serial.println(WiFi.localIP());
 }
 
 void callbackWifiDesconectado(WiFiEvent_t event) {
-  wifi_on = false;
   digitalWrite(LED_WIFI, LOW);
   Serial.print("[WIFI] WiFi Desconectado!");
 }
@@ -0,0 +1,120 @@
+/**
+ * @file UbidotsBatchClient.cpp
+ */
+
+#include "UbidotsBatchClient.h"
+#include <string.h>
+
+BatchClient::BatchClient(Client& client) : _client(client) {
+  _used = 0;
+  _batching = false;
+  _failed = false;
+}
+
+void BatchClient::beginBatch() {
+  _batching = true;
+  _failed = false;
+}
+
+bool BatchClient::endBatch() {
+  bool ok = send() && !_failed;
+
+  _batching = false;
+  _failed = false;
+  return ok;
+}
+
+bool BatchClient::send() {
+  if (_used == 0) {
+    return true;
+  }
+
+  size_t sent = _client.write(_buffer, _used);
+  bool ok = (sent == _used);
+
+  _used = 0;
+  if (!ok) {
+    _failed = true;
+  }
+
+  return ok;
+}
+
+int BatchClient::connect(IPAddress ip, uint16_t port) {
+  return _client.connect(ip, port);
+}
+
+int BatchClient::connect(const char* host, uint16_t port) {
+  return _client.connect(host, port);
+}
+
+size_t BatchClient::write(uint8_t data) {
+  return write(&data, 1);
+}
+
+size_t BatchClient::write(const uint8_t* buffer, size_t size) {
+  if (!_batching) {
+    return _client.write(buffer, size);
+  }
+
+  // Después de una falla, el resto del lote se descarta
+  if (_failed) {
+    return 0;
+  }
+
+  size_t written = 0;
+
+  while (written < size) {
+    size_t n = BATCH_BUFFER_SIZE - _used;
+
+    if (n > size - written) {
+      n = size - written;
+    }
+
+    memcpy(_buffer + _used, buffer + written, n);
+    _used += n;
+    written += n;
+
+    if (_used == BATCH_BUFFER_SIZE && !send()) {
+      return 0;
+    }
+  }
+
+  return written;
+}
+
+int BatchClient::available() {
+  return _client.available();
+}
+
+int BatchClient::read() {
+  return _client.read();
+}
+
+int BatchClient::read(uint8_t* buffer, size_t size) {
+  return _client.read(buffer, size);
+}
+
+int BatchClient::peek() {
+  return _client.peek();
+}
+
+void BatchClient::flush() {
+  send();
+  _client.flush();
+}
+
+void BatchClient::stop() {
+  // Lo acumulado pertenece a una conexión que se cierra
+  _used = 0;
+  _batching = false;
+  _client.stop();
+}
+
+uint8_t BatchClient::connected() {
+  return _client.connected();
+}
+
+BatchClient::operator bool() {
+  return (bool)_client;
+}
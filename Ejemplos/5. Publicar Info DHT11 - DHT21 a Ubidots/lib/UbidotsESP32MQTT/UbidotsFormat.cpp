@@ -0,0 +1,123 @@
+/**
+ * @file UbidotsFormat.cpp
+ */
+
+#include "UbidotsFormat.h"
+#include <string.h>
+
+static const char DIGIT_PAIRS[] =
+  "00010203040506070809"
+  "10111213141516171819"
+  "20212223242526272829"
+  "30313233343536373839"
+  "40414243444546474849"
+  "50515253545556575859"
+  "60616263646566676869"
+  "70717273747576777879"
+  "80818283848586878889"
+  "90919293949596979899";
+
+static const uint32_t POW5[FORMAT_MAX_DECIMALS + 1] = {
+  1, 5, 25, 125, 625, 3125, 15625, 78125, 390625, 1953125
+};
+
+// Escribe los dígitos de value hacia atrás, terminando en end. Retorna el inicio
+static char* writeDigits(uint64_t value, char* end) {
+  // Mientras no quepa en 32 bits se divide en 64 bits, que en el ESP32 es más lento
+  while (value > 0xFFFFFFFFULL) {
+    uint32_t pair = (uint32_t)(value % 100);
+    value /= 100;
+    end -= 2;
+    memcpy(end, DIGIT_PAIRS + pair * 2, 2);
+  }
+
+  uint32_t small = (uint32_t)value;
+
+  while (small >= 100) {
+    uint32_t pair = small % 100;
+    small /= 100;
+    end -= 2;
+    memcpy(end, DIGIT_PAIRS + pair * 2, 2);
+  }
+
+  if (small >= 10) {
+    end -= 2;
+    memcpy(end, DIGIT_PAIRS + small * 2, 2);
+  } else {
+    *--end = '0' + small;
+  }
+
+  return end;
+}
+
+size_t ubidotsFormatFixed(float value, uint8_t decimals, char* text) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+
+  bool negative = (bits >> 31) != 0;
+  int32_t exponent = (bits >> 23) & 0xFF;
+  uint32_t mantissa = bits & 0x7FFFFF;
+
+  if (exponent == 0xFF || decimals > FORMAT_MAX_DECIMALS) {
+    return 0;
+  }
+
+  if (exponent == 0) {
+    exponent = -149;            // Subnormal
+  } else {
+    mantissa |= 0x800000;
+    exponent -= 150;
+  }
+
+  // value * 10^decimals = mantissa * 5^decimals * 2^(exponent + decimals), exacto en 64 bits
+  uint64_t scaled = (uint64_t)mantissa * POW5[decimals];
+  int32_t shift = exponent + decimals;
+
+  if (shift >= 0) {
+    if (shift >= 64 || scaled > (0xFFFFFFFFFFFFFFFFULL >> shift)) {
+      return 0;
+    }
+    scaled <<= shift;
+
+  } else if (shift <= -64) {
+    scaled = 0;                 // scaled < 2^45, menos de la mitad de la unidad
+
+  } else {
+    uint64_t remainder = scaled & ((1ULL << -shift) - 1);
+    uint64_t half = 1ULL << (-shift - 1);
+
+    scaled >>= -shift;
+
+    // Redondeo al par más cercano, igual que printf
+    if (remainder > half || (remainder == half && (scaled & 1))) {
+      scaled++;
+    }
+  }
+
+  char digits[24];
+  char* end = digits + sizeof(digits);
+  char* start = writeDigits(scaled, end);
+
+  // Al menos un dígito entero antes del punto
+  while (end - start < decimals + 1) {
+    *--start = '0';
+  }
+
+  size_t integerDigits = (end - start) - decimals;
+  size_t n = 0;
+
+  if (negative) {
+    text[n++] = '-';
+  }
+
+  memcpy(text + n, start, integerDigits);
+  n += integerDigits;
+
+  if (decimals > 0) {
+    text[n++] = '.';
+    memcpy(text + n, start + integerDigits, decimals);
+    n += decimals;
+  }
+
+  return n;
+}
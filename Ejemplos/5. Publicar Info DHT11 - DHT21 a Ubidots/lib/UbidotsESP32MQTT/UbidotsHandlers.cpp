@@ -0,0 +1,151 @@
+/**
+ * @file UbidotsHandlers.cpp
+ */
+
+#include "UbidotsHandlers.h"
+#include "UbidotsParse.h"
+#include <stdio.h>
+#include <string.h>
+
+#define LV_TOPIC_FORMAT   "/v1.6/devices/%s/%s/lv"  // Debe coincidir con FIRST_PART_TOPIC
+
+HandlerRegistry::HandlerRegistry() {
+  _handlers = NULL;
+}
+
+HandlerRegistry::~HandlerRegistry() {
+  while (_handlers != NULL) {
+    VariableHandler* next = _handlers->_next;
+    free(_handlers->_topic);
+    free(_handlers);
+    _handlers = next;
+  }
+}
+
+VariableHandler* HandlerRegistry::add(const char* deviceLabel, const char* variableLabel,
+                                      FloatHandler handler) {
+  VariableHandler* h = create(deviceLabel, variableLabel);
+
+  if (h != NULL) {
+    h->_floatHandler = handler;
+    h->_intHandler = NULL;
+  }
+
+  return h;
+}
+
+VariableHandler* HandlerRegistry::add(const char* deviceLabel, const char* variableLabel,
+                                      IntHandler handler) {
+  VariableHandler* h = create(deviceLabel, variableLabel);
+
+  if (h != NULL) {
+    h->_intHandler = handler;
+    h->_floatHandler = NULL;
+  }
+
+  return h;
+}
+
+VariableHandler* HandlerRegistry::add(const char* deviceLabel, const char* variableLabel) {
+  return create(deviceLabel, variableLabel);
+}
+
+VariableHandler* HandlerRegistry::create(const char* deviceLabel, const char* variableLabel) {
+  int length = snprintf(NULL, 0, LV_TOPIC_FORMAT, deviceLabel, variableLabel);
+  VariableHandler* h = (VariableHandler *)malloc(sizeof(VariableHandler));
+
+  if (h == NULL || length <= 0 || length > 0xFFFF) {
+    free(h);
+    return NULL;
+  }
+
+  h->_topic = (char *)malloc(length + 1);
+
+  if (h->_topic == NULL) {
+    free(h);
+    return NULL;
+  }
+
+  snprintf(h->_topic, length + 1, LV_TOPIC_FORMAT, deviceLabel, variableLabel);
+  h->_length = length;
+  h->_hash = topicHash(h->_topic, length);
+
+  // Una variable ya registrada conserva su registro (y su handler, si lo tiene)
+  VariableHandler* existing = find(h->_topic, length, h->_hash);
+
+  if (existing != NULL) {
+    free(h->_topic);
+    free(h);
+    return existing;
+  }
+
+  h->_floatHandler = NULL;
+  h->_intHandler = NULL;
+
+  // Se agrega al final, para suscribirse en el mismo orden de registro
+  VariableHandler** last = &_handlers;
+  while (*last != NULL) {
+    last = &(*last)->_next;
+  }
+  h->_next = NULL;
+  *last = h;
+
+  return h;
+}
+
+VariableHandler* HandlerRegistry::find(const char* topic, size_t length, uint32_t hash) const {
+  for (VariableHandler* h = _handlers; h != NULL; h = h->_next) {
+    if (h->_hash == hash && h->_length == length && memcmp(h->_topic, topic, length) == 0) {
+      return h;
+    }
+  }
+
+  return NULL;
+}
+
+bool HandlerRegistry::dispatch(const char* topic, const uint8_t* payload, unsigned int length) {
+  size_t topicLength = strlen(topic);
+  VariableHandler* h = find(topic, topicLength, topicHash(topic, topicLength));
+
+  // Tópicos sin handler (ver add() sin handler) quedan para el callback general
+  if (h == NULL || (h->_intHandler == NULL && h->_floatHandler == NULL)) {
+    return false;
+  }
+
+  // Ubidots envía el valor como texto, por ejemplo "255" o "21.50"; se convierte sin copiarlo
+  if (h->_intHandler != NULL) {
+    int32_t value;
+
+    if (!ubidotsParseInt(payload, length, &value)) {
+      return false;
+    }
+
+    h->_intHandler(value);
+
+  } else {
+    float value;
+
+    if (!ubidotsParseFloat(payload, length, &value)) {
+      return false;
+    }
+
+    h->_floatHandler(value);
+  }
+
+  return true;
+}
+
+VariableHandler* HandlerRegistry::first() const {
+  return _handlers;
+}
+
+uint32_t topicHash(const char* topic, size_t length) {
+  uint32_t hash = 2166136261u;
+
+  for (size_t i = 0; i < length; i++) {
+    hash ^= (uint8_t)topic[i];
+    hash *= 16777619u;
+  }
+
+  return hash;
+}
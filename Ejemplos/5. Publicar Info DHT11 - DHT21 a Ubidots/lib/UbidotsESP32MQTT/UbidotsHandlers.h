@@ -0,0 +1,102 @@
+/**
+ * @file UbidotsHandlers.h
+ */
+
+#ifndef UbidotsHandlers_H
+#define UbidotsHandlers_H
+
+#include <Arduino.h>
+
+typedef void (*FloatHandler)(float value);      //!< Handler que recibe el valor como decimal
+typedef void (*IntHandler)(int32_t value);      //!< Handler que recibe el valor como entero
+
+/**
+ * @brief Handler asociado al tópico "/lv" de una variable.
+ *
+ * El tópico completo, su largo y su hash se calculan una sola vez al registrarlo.
+ */
+typedef struct VariableHandler {
+  char* _topic;
+  uint16_t _length;
+  uint32_t _hash;
+  FloatHandler _floatHandler;
+  IntHandler _intHandler;
+  struct VariableHandler* _next;
+} VariableHandler;
+
+/**
+ * @brief Registro de handlers por variable para mensajes entrantes de Ubidots.
+ *
+ * Un mensaje entrante se dirige a su handler comparando hash y largo del tópico (y, sólo si
+ * coinciden, su contenido), en vez de buscar cada nombre de variable dentro del tópico.
+ */
+class HandlerRegistry {
+  public:
+    HandlerRegistry();
+    ~HandlerRegistry();
+
+    /**
+     * @brief Registrar un handler que recibe el valor como decimal. Si la variable ya estaba
+     * registrada, se reemplaza su handler.
+     *
+     * @param deviceLabel Nombre del dispositivo
+     * @param variableLabel Nombre de la variable
+     * @param handler Función a llamar con cada valor recibido
+     * @return VariableHandler* Handler registrado, o NULL si no hay memoria
+     */
+    VariableHandler* add(const char* deviceLabel, const char* variableLabel, FloatHandler handler);
+
+    /**
+     * @brief Registrar un handler que recibe el valor como entero. Si la variable ya estaba
+     * registrada, se reemplaza su handler.
+     *
+     * @param deviceLabel Nombre del dispositivo
+     * @param variableLabel Nombre de la variable
+     * @param handler Función a llamar con cada valor recibido
+     * @return VariableHandler* Handler registrado, o NULL si no hay memoria
+     */
+    VariableHandler* add(const char* deviceLabel, const char* variableLabel, IntHandler handler);
+
+    /**
+     * @brief Registrar un tópico sin handler. Sus mensajes no se dirigen (dispatch() retorna
+     * false), pero se incluye en first() para renovar su suscripción.
+     *
+     * @param deviceLabel Nombre del dispositivo
+     * @param variableLabel Nombre de la variable
+     * @return VariableHandler* Registro del tópico, o NULL si no hay memoria
+     */
+    VariableHandler* add(const char* deviceLabel, const char* variableLabel);
+
+    /**
+     * @brief Dirigir un mensaje entrante a su handler.
+     *
+     * @param topic Tópico del mensaje
+     * @param payload Contenido del mensaje (texto, no terminado en '\0')
+     * @param length Largo del contenido
+     * @return true El mensaje tenía un handler registrado
+     * @return false No hay handler para el tópico, o el contenido no es un número válido
+     */
+    bool dispatch(const char* topic, const uint8_t* payload, unsigned int length);
+
+    /**
+     * @brief Primer handler registrado, o NULL. Sirve para recorrer los tópicos registrados.
+     */
+    VariableHandler* first() const;
+
+  private:
+    VariableHandler* create(const char* deviceLabel, const char* variableLabel);
+    VariableHandler* find(const char* topic, size_t length, uint32_t hash) const;
+
+    VariableHandler* _handlers;
+};
+
+/**
+ * @brief Hash FNV-1a de 32 bits de un tópico.
+ *
+ * @param topic Tópico
+ * @param length Largo del tópico
+ * @return Hash del tópico
+ */
+uint32_t topicHash(const char* topic, size_t length);
+
+#endif
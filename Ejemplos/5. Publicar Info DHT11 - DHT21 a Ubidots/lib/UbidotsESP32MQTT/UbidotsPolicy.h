@@ -0,0 +1,110 @@
+/**
+ * @file UbidotsPolicy.h
+ */
+
+#ifndef UbidotsPolicy_H
+#define UbidotsPolicy_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Política de publicación por excepción para una variable de Ubidots.
+ *
+ * Al registrarla en el cliente (Ubidots::addPolicy()), cada add() de la variable se evalúa y sólo
+ * se agrega al buffer si pasa la política:
+ * - Intervalo mínimo: nunca se envía antes de que transcurra este tiempo desde el último envío.
+ * - Heartbeat: se envía siempre que transcurra este tiempo sin enviar, aunque no haya cambios.
+ * - Banda muerta: en otro caso, sólo se envía si el valor cambió más que la banda (absoluta, o
+ *   relativa al último valor enviado). Sin banda configurada, todo valor pasa.
+ */
+class PublishPolicy {
+  public:
+    /**
+     * @brief Construir una nueva política, sin restricciones.
+     *
+     * @param variableLabel Nombre de la variable
+     */
+    PublishPolicy(const char* variableLabel);
+
+    /**
+     * @brief Establecer una banda muerta absoluta.
+     *
+     * @param deadband Cambio mínimo, en las unidades de la variable
+     * @return PublishPolicy& La misma política
+     */
+    PublishPolicy& setDeadband(float deadband);
+
+    /**
+     * @brief Establecer una banda muerta relativa al último valor enviado.
+     *
+     * @param fraction Cambio mínimo como fracción del último valor (0.01 = 1%)
+     * @return PublishPolicy& La misma política
+     */
+    PublishPolicy& setRelativeDeadband(float fraction);
+
+    /**
+     * @brief Establecer el intervalo mínimo entre envíos.
+     *
+     * @param interval Intervalo en milisegundos
+     * @return PublishPolicy& La misma política
+     */
+    PublishPolicy& setMinInterval(uint32_t interval);
+
+    /**
+     * @brief Establecer el tiempo máximo sin enviar (heartbeat).
+     *
+     * @param interval Intervalo en milisegundos (0 para desactivar)
+     * @return PublishPolicy& La misma política
+     */
+    PublishPolicy& setHeartbeat(uint32_t interval);
+
+    /**
+     * @brief Evaluar un nuevo valor. Si pasa, se toma como el último valor enviado.
+     *
+     * @param value Valor numérico
+     * @param now Tiempo actual en milisegundos (millis())
+     * @return true El valor debe enviarse
+     * @return false El valor se descarta
+     */
+    bool evaluate(float value, uint32_t now);
+
+    /**
+     * @brief Cantidad de valores que pasaron la política y entraron al buffer.
+     *
+     * Un valor que pasa aún puede esperar por el límite de envío, o guardarse en el journal si no
+     * hay conexión: no es lo mismo que un valor enviado.
+     */
+    uint32_t passed() const;
+
+    /**
+     * @brief Cantidad de valores descartados por la política.
+     */
+    uint32_t suppressed() const;
+
+    /**
+     * @brief Nombre de la variable.
+     */
+    const char* label() const;
+
+    /**
+     * @brief Siguiente política registrada en el cliente, o NULL.
+     */
+    PublishPolicy* next() const;
+
+  private:
+    friend class Ubidots;
+
+    const char* _variableLabel;
+    float _deadband;
+    float _relativeDeadband;
+    uint32_t _minInterval;
+    uint32_t _heartbeat;
+    float _lastValue;
+    uint32_t _lastTime;
+    bool _hasLast;
+    uint32_t _passed;
+    uint32_t _suppressed;
+    PublishPolicy* _next;
+};
+
+#endif
@@ -25,7 +25,6 @@
 
 #include "DHT.h"
 
-#define MIN_INTERVAL 2000 /**< min interval value */
 #define TIMEOUT                                                                \
   UINT32_MAX /**< Used programmatically for timeout.                           \
                    Not a timeout duration. Type: uint32_t. */
@@ -39,10 +38,12 @@
  *  @param  count
  *          number of sensors
  */
-DHT::DHT(uint8_t pin, uint8_t type, uint8_t count) {
+DHT::DHT(uint8_t pin, uint8_t type, uint8_t count) : _pinEdges(pin) {
   (void)count; // Workaround to avoid compiler warning.
   _pin = pin;
   _type = type;
+  _async.setSource(&_pinEdges);
+  _callback = NULL;
 #ifdef __AVR
   _bit = digitalPinToBitMask(pin);
   _port = digitalPinToPort(pin);
@@ -84,41 +85,12 @@ void DHT::begin(uint8_t usec) {
  */
 float DHT::readTemperature(bool S, bool force) {
   float f = NAN;
+  int16_t t;
+  uint16_t h;
 
-  if (read(force)) {
-    switch (_type) {
-    case DHT11:
-      f = data[2];
-      if (data[3] & 0x80) {
-        f = -1 - f;
-      }
-      f += (data[3] & 0x0f) * 0.1;
-      if (S) {
-        f = convertCtoF(f);
-      }
-      break;
-    case DHT12:
-      f = data[2];
-      f += (data[3] & 0x0f) * 0.1;
-      if (data[2] & 0x80) {
-        f *= -1;
-      }
-      if (S) {
-        f = convertCtoF(f);
-      }
-      break;
-    case DHT22:
-    case DHT21:
-      f = ((word)(data[2] & 0x7F)) << 8 | data[3];
-      f *= 0.1;
-      if (data[2] & 0x80) {
-        f *= -1;
-      }
-      if (S) {
-        f = convertCtoF(f);
-      }
-      break;
-    }
+  if (read(force) && decodeTenths(&t, &h)) {
+    // Fahrenheit in hundredths: t * 1.8 + 32 is exact in integers
+    f = S ? (t * 18 + 3200) / 100.0f : t / 10.0f;
   }
   return f;
 }
@@ -147,22 +119,81 @@ float DHT::convertFtoC(float f) { return (f - 32) * 0.55555; }
  */
 float DHT::readHumidity(bool force) {
   float f = NAN;
-  if (read(force)) {
-    switch (_type) {
-    case DHT11:
-    case DHT12:
-      f = data[0] + data[1] * 0.1;
-      break;
-    case DHT22:
-    case DHT21:
-      f = ((word)data[0]) << 8 | data[1];
-      f *= 0.1;
-      break;
-    }
+  int16_t t;
+  uint16_t h;
+
+  if (read(force) && decodeTenths(&t, &h)) {
+    f = h / 10.0f;
   }
   return f;
 }
 
+/*!
+ *  @brief  Read every value from a single acquisition. Temperature and
+ *          humidity are decoded from the raw bytes in integers; floats are
+ *          only used for the results.
+ *  @param  measurement
+ *          temperature (C and F), humidity, heat index, dew point and the
+ *          time of the acquisition
+ *  @param  force
+ *          true if in force mode
+ *  @return true if the sensor was read; measurement is unchanged otherwise
+ */
+bool DHT::readAll(DHTMeasurement &measurement, bool force) {
+  int16_t t;
+  uint16_t h;
+
+  if (!read(force) || !decodeTenths(&t, &h)) {
+    return false;
+  }
+
+  measurement.temperature = t / 10.0f;
+  measurement.fahrenheit = (t * 18 + 3200) / 100.0f;
+  measurement.humidity = h / 10.0f;
+  measurement.heatIndex =
+      computeHeatIndex(measurement.temperature, measurement.humidity, false);
+  measurement.dewPoint =
+      computeDewPoint(measurement.temperature, measurement.humidity);
+  measurement.timestamp = _lastreadtime;
+  return true;
+}
+
+/*!
+ *  @brief  Decode the last frame in integers
+ *  @param  temperature
+ *          temperature, in tenths of Celsius
+ *  @param  humidity
+ *          relative humidity, in tenths of percent
+ *  @return false if the sensor type is unknown
+ */
+bool DHT::decodeTenths(int16_t *temperature, uint16_t *humidity) {
+  switch (_type) {
+  case DHT11:
+    *temperature = data[2] * 10 + (data[3] & 0x0f);
+    if (data[3] & 0x80) {
+      *temperature = -10 - data[2] * 10 + (data[3] & 0x0f);
+    }
+    *humidity = data[0] * 10 + data[1];
+    return true;
+  case DHT12:
+    *temperature = data[2] * 10 + (data[3] & 0x0f);
+    if (data[2] & 0x80) {
+      *temperature = -*temperature;
+    }
+    *humidity = data[0] * 10 + data[1];
+    return true;
+  case DHT22:
+  case DHT21:
+    *temperature = ((word)(data[2] & 0x7F)) << 8 | data[3];
+    if (data[2] & 0x80) {
+      *temperature = -*temperature;
+    }
+    *humidity = ((word)data[0]) << 8 | data[1];
+    return true;
+  }
+  return false;
+}
+
 /*!
  *  @brief  Compute Heat Index
  *          Simplified version that reads temp and humidity from sensor
@@ -172,15 +203,18 @@ float DHT::readHumidity(bool force) {
  *	@return float heat index
  */
 float DHT::computeHeatIndex(bool isFahrenheit) {
-  float hi = computeHeatIndex(readTemperature(isFahrenheit), readHumidity(),
-                              isFahrenheit);
-  return hi;
+  DHTMeasurement m;
+  if (!readAll(m)) {
+    return NAN;
+  }
+  return isFahrenheit ? computeHeatIndex(m.fahrenheit, m.humidity) : m.heatIndex;
 }
 
 /*!
  *  @brief  Compute Heat Index
  *  				Using both Rothfusz and Steadman's equations
- *					(http://www.wpc.ncep.noaa.gov/html/heatindex_equation.shtml)
+ *					(http://www.wpc.ncep.noaa.gov/html/heatindex_equation.shtml),
+ *					in single precision (see DHTKernels.h)
  *  @param  temperature
  *          temperature in selected scale
  *  @param  percentHumidity
@@ -191,34 +225,20 @@ float DHT::computeHeatIndex(bool isFahrenheit) {
  */
 float DHT::computeHeatIndex(float temperature, float percentHumidity,
                             bool isFahrenheit) {
-  float hi;
-
-  if (!isFahrenheit)
-    temperature = convertCtoF(temperature);
-
-  hi = 0.5 * (temperature + 61.0 + ((temperature - 68.0) * 1.2) +
-              (percentHumidity * 0.094));
-
-  if (hi > 79) {
-    hi = -42.379 + 2.04901523 * temperature + 10.14333127 * percentHumidity +
-         -0.22475541 * temperature * percentHumidity +
-         -0.00683783 * pow(temperature, 2) +
-         -0.05481717 * pow(percentHumidity, 2) +
-         0.00122874 * pow(temperature, 2) * percentHumidity +
-         0.00085282 * temperature * pow(percentHumidity, 2) +
-         -0.00000199 * pow(temperature, 2) * pow(percentHumidity, 2);
-
-    if ((percentHumidity < 13) && (temperature >= 80.0) &&
-        (temperature <= 112.0))
-      hi -= ((13.0 - percentHumidity) * 0.25) *
-            sqrt((17.0 - abs(temperature - 95.0)) * 0.05882);
-
-    else if ((percentHumidity > 85.0) && (temperature >= 80.0) &&
-             (temperature <= 87.0))
-      hi += ((percentHumidity - 85.0) * 0.1) * ((87.0 - temperature) * 0.2);
-  }
+  return dhtHeatIndex(temperature, percentHumidity, isFahrenheit);
+}
 
-  return isFahrenheit ? hi : convertFtoC(hi);
+/*!
+ *  @brief  Compute Dew Point with the Magnus formula
+ *          (Alduchov and Eskridge coefficients, -40 to 50 C)
+ *  @param  temperature
+ *          temperature in Celsius
+ *  @param  percentHumidity
+ *          humidity in percent
+ *	@return float dew point in Celsius
+ */
+float DHT::computeDewPoint(float temperature, float percentHumidity) {
+  return dhtDewPoint(temperature, percentHumidity);
 }
 
 /*!
@@ -235,6 +255,9 @@ bool DHT::read(bool force) {
   if (!force && ((currenttime - _lastreadtime) < MIN_INTERVAL)) {
     return _lastresult; // return last correct measurement
   }
+  if (_async.busy()) {
+    return _lastresult; // the line is in use by startRead()
+  }
   _lastreadtime = currenttime;
 
   // Reset 40 bits of received data to zero.
@@ -266,7 +289,7 @@ bool DHT::read(bool force) {
     break;
   }
 
-  uint32_t cycles[80];
+  uint32_t cycles[DHT_FRAME_PULSES];
   {
     // End the start signal by setting data line high for 40 microseconds.
     pinMode(_pin, INPUT_PULLUP);
@@ -307,26 +330,16 @@ bool DHT::read(bool force) {
     }
   } // Timing critical code is now complete.
 
-  // Inspect pulses and determine which ones are 0 (high state cycle count < low
-  // state cycle count), or 1 (high state cycle count > low state cycle count).
-  for (int i = 0; i < 40; ++i) {
-    uint32_t lowCycles = cycles[2 * i];
-    uint32_t highCycles = cycles[2 * i + 1];
-    if ((lowCycles == TIMEOUT) || (highCycles == TIMEOUT)) {
-      DEBUG_PRINTLN(F("DHT timeout waiting for pulse."));
-      _lastresult = false;
-      return _lastresult;
-    }
-    data[i / 8] <<= 1;
-    // Now compare the low and high cycle times to see if the bit is a 0 or 1.
-    if (highCycles > lowCycles) {
-      // High cycles are greater than 50us low cycle count, must be a 1.
-      data[i / 8] |= 1;
-    }
-    // Else high cycles are less than (or equal to, a weird case) the 50us low
-    // cycle count so this must be a zero.  Nothing needs to be changed in the
-    // stored data.
+  // Inspect pulses and determine which ones are 0 or 1, and check the
+  // checksum. See dhtDecodeFrame().
+  DHTFrame frame;
+  DHTStatus status = dhtDecodeFrame(cycles, DHT_FRAME_PULSES, &frame);
+  if (status == DHT_TIMEOUT) {
+    DEBUG_PRINTLN(F("DHT timeout waiting for pulse."));
+    _lastresult = false;
+    return _lastresult;
   }
+  memcpy(data, frame.data, sizeof(data));
 
   DEBUG_PRINTLN(F("Received from DHT:"));
   DEBUG_PRINT(data[0], HEX);
@@ -342,7 +355,7 @@ bool DHT::read(bool force) {
   DEBUG_PRINTLN((data[0] + data[1] + data[2] + data[3]) & 0xFF, HEX);
 
   // Check we read 40 bits and that the checksum matches.
-  if (data[4] == ((data[0] + data[1] + data[2] + data[3]) & 0xFF)) {
+  if (status == DHT_OK) {
     _lastresult = true;
     return _lastresult;
   } else {
@@ -352,6 +365,149 @@ bool DHT::read(bool force) {
   }
 }
 
+/*!
+ *  @brief  Start a read without blocking. The start signal and the frame are
+ *          handled by poll(), and the data line edges are timestamped by an
+ *          interrupt, so interrupts are never disabled.
+ *  @param  force
+ *          true to start even if the last read was less than two seconds ago
+ *  @return true if the read was started
+ */
+bool DHT::startRead(bool force) {
+  uint32_t currenttime = millis();
+  if (!force && ((currenttime - _lastreadtime) < MIN_INTERVAL)) {
+    return false;
+  }
+
+  // Same start signal length as read()
+  uint32_t startMicros = (_type == DHT22 || _type == DHT21) ? 1100 : 20000;
+  if (!_async.start(startMicros)) {
+    return false;
+  }
+
+  _lastreadtime = currenttime;
+  return true;
+}
+
+/*!
+ *  @brief  Advance the read started by startRead(). Call it often (from
+ *          loop()). When the read ends, its result is used by
+ *          readTemperature() and readHumidity() for the next two seconds, and
+ *          the callback set with onRead() is called.
+ *  @return DHT_BUSY while the read is in progress, then its result
+ */
+DHTStatus DHT::poll() {
+  if (!_async.busy()) {
+    return _async.status();
+  }
+
+  DHTStatus status = _async.poll();
+  if (status == DHT_BUSY) {
+    return status;
+  }
+
+  memcpy(data, _async.data(), sizeof(data));
+  _lastresult = (status == DHT_OK);
+  DEBUG_PRINT(F("DHT asynchronous read: "));
+  DEBUG_PRINTLN(status);
+
+  if (_callback != NULL) {
+    _callback(*this, status);
+  }
+  return status;
+}
+
+/*!
+ *  @brief  Set the function called when an asynchronous read ends
+ *  @param  callback
+ *          function, or NULL
+ */
+void DHT::onRead(DHTReadCallback callback) { _callback = callback; }
+
+/*!
+ *  @brief  Use another data line for asynchronous reads (for example, a
+ *          synthetic one in tests)
+ *  @param  source
+ *          data line, or NULL to use the sensor pin again
+ */
+void DHT::setEdgeSource(DHTEdgeSource *source) {
+  _async.setSource(source != NULL ? source : &_pinEdges);
+}
+
+#if !defined(ESP32) && !defined(ESP8266)
+DHTPinEdges *DHTPinEdges::_capturing = NULL;
+#endif
+
+/*!
+ *  @brief  Instantiates the data line of a sensor
+ *  @param  pin
+ *          pin number that sensor is connected
+ */
+DHTPinEdges::DHTPinEdges(uint8_t pin) {
+  _pin = pin;
+  _edges = NULL;
+}
+
+/*!
+ *  @brief  Pull the data line low
+ */
+void DHTPinEdges::startSignal() {
+  pinMode(_pin, OUTPUT);
+  digitalWrite(_pin, LOW);
+}
+
+/*!
+ *  @brief  Release the data line, then record its edges from the pin change
+ *          interrupt. The interrupt is attached after the release, so the
+ *          rising edge of the release itself is not recorded.
+ *  @param  edges
+ *          buffer for the edges
+ */
+void DHTPinEdges::capture(DHTEdgeBuffer *edges) {
+  _edges = edges;
+  pinMode(_pin, INPUT_PULLUP);
+#if defined(ESP32) || defined(ESP8266)
+  attachInterruptArg(digitalPinToInterrupt(_pin), onEdge, this, CHANGE);
+#else
+  _capturing = this;
+  attachInterrupt(digitalPinToInterrupt(_pin), onEdge, CHANGE);
+#endif
+}
+
+/*!
+ *  @brief  Stop recording edges. The line stays released.
+ */
+void DHTPinEdges::stop() {
+  detachInterrupt(digitalPinToInterrupt(_pin));
+  pinMode(_pin, INPUT_PULLUP);
+  _edges = NULL;
+}
+
+/*!
+ *  @brief  Current time
+ *  @return time in microseconds
+ */
+uint32_t DHTPinEdges::micros() { return ::micros(); }
+
+/*!
+ *  @brief  Pin change interrupt: timestamp the edge
+ *  @param  arg
+ *          line that changed
+ */
+void DHT_ISR_ATTR DHTPinEdges::onEdge(void *arg) {
+  DHTEdgeBuffer *edges = ((DHTPinEdges *)arg)->_edges;
+  if (edges != NULL) {
+    edges->record(::micros());
+  }
+}
+
+#if !defined(ESP32) && !defined(ESP8266)
+/*!
+ *  @brief  Pin change interrupt for cores without interrupt arguments
+ */
+void DHT_ISR_ATTR DHTPinEdges::onEdge() { onEdge(_capturing); }
+#endif
+
 // Expect the signal line to be at the specified level for a period of time and
 // return a count of loop cycles spent at that level (this cycle count can be
 // used to compare the relative time of two pulses).  If more than a millisecond
@@ -0,0 +1,138 @@
+/*!
+ *  @file DHTEdges.h
+ *
+ *  Interrupt-driven acquisition of DHT frames. The data line edges are
+ *  timestamped by an interrupt into a fixed buffer and the frame is decoded
+ *  once it is complete, so interrupts are never masked and the caller is never
+ *  blocked.
+ *
+ *  This file does not depend on Arduino: the line is reached through
+ *  DHTEdgeSource, so the state machine also runs on a PC with synthetic edges.
+ *
+ *  MIT license, all text above must be included in any redistribution
+ */
+
+#ifndef DHT_EDGES_H
+#define DHT_EDGES_H
+
+#include "DHTFrame.h"
+
+/*!
+ *  Edges of a complete frame: the sensor response (low, high), then the
+ *  falling edge that starts bit 0, one rising and one falling edge per bit, and
+ *  the rising edge that ends the frame.
+ */
+#define DHT_EDGE_COUNT 84
+#define DHT_FRAME_TIMEOUT 10000 /**< Max. time for a frame, in microseconds */
+
+/*!
+ *  @brief  Edge timestamps written by the interrupt handler
+ */
+class DHTEdgeBuffer {
+public:
+  DHTEdgeBuffer() { clear(); }
+
+  /*!
+   *  @brief  Discard all the edges
+   */
+  void clear() { count = 0; }
+
+  /*!
+   *  @brief  Store an edge. Called from the interrupt handler, so it only
+   *          stores the time; edges beyond DHT_EDGE_COUNT are ignored.
+   *  @param  micros
+   *          time of the edge, in microseconds
+   */
+  void record(uint32_t micros) {
+    uint8_t n = count;
+    if (n < DHT_EDGE_COUNT) {
+      time[n] = micros;
+      count = n + 1;
+    }
+  }
+
+  volatile uint32_t time[DHT_EDGE_COUNT]; /**< Edge times, in microseconds */
+  volatile uint8_t count;                 /**< Edges stored */
+};
+
+/*!
+ *  @brief  Access to the data line. DHTPinEdges (DHT.h) uses a GPIO and its
+ *          edge interrupt; tests provide synthetic edge streams.
+ */
+class DHTEdgeSource {
+public:
+  virtual ~DHTEdgeSource() {}
+
+  /*!
+   *  @brief  Pull the data line low (start signal)
+   */
+  virtual void startSignal() = 0;
+
+  /*!
+   *  @brief  Release the data line and record every following edge
+   *  @param  edges
+   *          buffer for the edges
+   */
+  virtual void capture(DHTEdgeBuffer *edges) = 0;
+
+  /*!
+   *  @brief  Stop recording edges and leave the data line released
+   */
+  virtual void stop() = 0;
+
+  /*!
+   *  @brief  Current time
+   *  @return time in microseconds
+   */
+  virtual uint32_t micros() = 0;
+};
+
+/*!
+ *  @brief  Non-blocking state machine for one DHT read: start signal, edge
+ *          capture and decoding.
+ */
+class DHTAsyncReader {
+public:
+  DHTAsyncReader();
+
+  void setSource(DHTEdgeSource *source);
+  bool start(uint32_t startMicros);
+  DHTStatus poll();
+  void cancel();
+
+  /*!
+   *  @brief  Whether a read is in progress
+   *  @return true while the start signal or the frame are in progress
+   */
+  bool busy() const { return _status == DHT_BUSY; }
+
+  /*!
+   *  @brief  Status of the last read
+   *  @return status
+   */
+  DHTStatus status() const { return _status; }
+
+  /*!
+   *  @brief  Bytes of the last frame (valid when status() is DHT_OK)
+   *  @return 5 bytes: humidity, temperature and checksum
+   */
+  const uint8_t *data() const { return _frame.data; }
+
+  /*!
+   *  @brief  Last decoded frame, with the margin of each bit
+   *  @return frame
+   */
+  const DHTFrame &frame() const { return _frame; }
+
+private:
+  DHTStatus decode();
+
+  DHTEdgeSource *_source;
+  DHTEdgeBuffer _edges;
+  uint32_t _since, _startMicros;
+  bool _capturing;
+  DHTStatus _status;
+  DHTFrame _frame;
+};
+
+#endif
@@ -0,0 +1,52 @@
+/*!
+ *  @file DHTFrame.h
+ *
+ *  Hardware-free decoding of DHT frames: bit classification and checksum
+ *  validation from the measured pulse lengths, with no GPIO access, so it can
+ *  be reused by every acquisition method and tested on a PC.
+ *
+ *  MIT license, all text above must be included in any redistribution
+ */
+
+#ifndef DHT_FRAME_H
+#define DHT_FRAME_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define DHT_FRAME_BITS 40   /**< Data bits in a frame */
+#define DHT_FRAME_PULSES 80 /**< One low and one high pulse per bit */
+#define DHT_PULSE_TIMEOUT                                                      \
+  UINT32_MAX /**< Pulse length of a pulse that never ended */
+
+/*!
+ *  @brief  Result of a read
+ */
+typedef enum DHTStatus {
+  DHT_IDLE,        /**< No read was started */
+  DHT_BUSY,        /**< Start signal or frame in progress */
+  DHT_OK,          /**< Frame received and checksum valid */
+  DHT_TIMEOUT,     /**< The sensor did not send a complete frame */
+  DHT_CHECKSUM,    /**< Frame received but the checksum does not match */
+  DHT_NOT_STARTED, /**< The read could not start because the sensor was busy
+                        with a read started elsewhere */
+} DHTStatus;
+
+/*!
+ *  @brief  Decoded frame
+ */
+typedef struct DHTFrame {
+  uint8_t data[5];   /**< Humidity, temperature and checksum bytes */
+  DHTStatus status;  /**< DHT_OK, DHT_CHECKSUM or DHT_TIMEOUT */
+  uint16_t margin[DHT_FRAME_BITS]; /**< Distance of each high pulse to the
+                                        0/1 threshold (saturated) */
+  uint16_t minMargin; /**< Smallest margin: how close the frame was to a
+                           misread bit */
+  uint8_t weakestBit; /**< Bit with the smallest margin (0 is the MSB of
+                           data[0]) */
+} DHTFrame;
+
+DHTStatus dhtDecodeFrame(const uint32_t *pulses, size_t count,
+                         DHTFrame *frame);
+
+#endif
@@ -0,0 +1,26 @@
+/*!
+ *  @file DHTKernels.h
+ *
+ *  Float-only heat index and dew point, for one sample or for arrays of
+ *  samples. They do not depend on Arduino, so they can also be used to
+ *  process stored samples on a PC.
+ *
+ *  MIT license, all text above must be included in any redistribution
+ */
+
+#ifndef DHT_KERNELS_H
+#define DHT_KERNELS_H
+
+#include <stddef.h>
+
+float dhtHeatIndex(float temperature, float percentHumidity,
+                   bool isFahrenheit = true);
+void dhtHeatIndexBatch(const float *temperature, const float *percentHumidity,
+                       float *heatIndex, size_t count,
+                       bool isFahrenheit = true);
+
+float dhtDewPoint(float temperature, float percentHumidity);
+void dhtDewPointBatch(const float *temperature, const float *percentHumidity,
+                      float *dewPoint, size_t count);
+
+#endif
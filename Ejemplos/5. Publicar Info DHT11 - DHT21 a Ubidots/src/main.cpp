@@ -88,9 +88,9 @@
 /* Main Constructor, pass Ubidots Token as a parameter */
 Ubidots ubidots(TOKEN);
 
-// Delays para Envío de Paquetes, y reconexión WiFi
-/* Delays for Sending Packages, and WiFi reconnection */
-DelayMillis t_envio, t_reconexion;
+// Delay para Envío de Paquetes
+/* Delay for Sending Packages */
+DelayMillis t_envio;
 
 // NOTE Config. DHT
 // Constructor DHT, pasa como parámetro el Pin de Datos, y el tipo de sensor DHT
@@ -100,16 +100,23 @@ DelayMillis t_envio, t_reconexion;
  * The library has compatibility for DHT11, DHT12, DHT21 and DHT22
  */
 DHT dht(DHT_DATA, DHT11);
-/* -------------------------------------------------------------------------- */
 
-/* ------------------ Variables Globales (Global Variables) ----------------- */
-bool wifi_on = false; // Indica si hay conexión activa a WiFi
-                      /* Indicates WiFi connection */
+// NOTE Políticas de publicación
+// La temperatura y la humedad cambian lentamente. Sólo se envían si cambian más que la banda
+// muerta, o si pasan 5 minutos sin enviar (heartbeat)
+/**
+ * Temperature and humidity change slowly. They are only sent if they change more than the
+ * deadband, or if 5 minutes pass without sending (heartbeat)
+ */
+PublishPolicy p_temperatura(VAR_TEMPERATURA);
+PublishPolicy p_humedad(VAR_HUMEDAD);
 /* -------------------------------------------------------------------------- */
 
 /* -------------- Declaracion Funciones (Function Declarations) ------------- */
 void callback(char* topic, uint8_t* payload, unsigned int length);  // Callback de Ubidots
                                                                     /* Ubidots Callback */
+void lecturaDHT(DHT& sensor, DHTStatus estado); // Se ejecuta al terminar una lectura del DHT
+                                                /* DHT read finished Callback */
 void callbackWifiConectado(WiFiEvent_t event);    // Se ejecuta cuando WiFi asoció dirección IP
                                                   /* WiFi connected Callback */
 void callbackWifiDesconectado(WiFiEvent_t event); // Se ejecuta cuando WiFi se desconecta
@@ -127,9 +134,10 @@ void setup() {
   /* Configure Initial State of the Pins */
   digitalWrite(LED_WIFI, LOW);
 
-  // Iniciar sensor DHT
-  /* Start DHT sensor */
+  // Iniciar sensor DHT, y asociar la función que recibe cada lectura
+  /* Start DHT sensor, and associate the function that receives each read */
   dht.begin();
+  dht.onRead(lecturaDHT);
 
   // Iniciar Puerto Serial
   /* Start Serial Port */
@@ -143,8 +151,6 @@ void setup() {
   /* Start delays */
   t_envio.empezar(10000);     // Enviar cada 10s a Ubidots
                               /* Send every 10s to Ubidots */
-  t_reconexion.empezar(3000); // Intentar reconectar cada 3s en caso de que no haya conexión
-                              /* Try to reconnect every 3s if there are no connection */
 
   // Asociar Callbacks del WiFi
   /* Associate WiFi Callbacks */
@@ -157,60 +163,41 @@ void setup() {
   /* Configure Ubidots client */
   ubidots.setDebug(true);   // Setear a TRUE para visualizar información útil
                             /* Set to TRUE to display useful info */
+  ubidots.setConnectTimeout(1000, 1); // Si el servidor no responde, loop() espera a lo más 1 s
+                                      /* If the server does not respond, loop() waits 1 s at most */
   ubidots.begin(callback);  // Iniciar Servidor y asociar Callback para recibir paquetes
                             /* Start Server and associate Callback to receive packages */
   ubidots.wifiConnection(SSID, PASS); // Iniciar conexión WiFi
                                       /* Start WiFi connection */
+
+  // Configurar y registrar políticas de publicación
+  /* Configure and register publish policies */
+  p_temperatura.setDeadband(0.5).setHeartbeat(300000);  // 0.5[°C], 5 min
+  p_humedad.setDeadband(2.0).setHeartbeat(300000);      // 2[%], 5 min
+  ubidots.addPolicy(&p_temperatura);
+  ubidots.addPolicy(&p_humedad);
 }
 // * ---------------------------------------------------------------------------
 
 // ANCHOR loop()
 // * ---------------------------------------------------------------------------
 void loop() {
-  // Revisar si el cliente MQTT y el WiFi se encuentran conectados
-  /* Check if the MQTT client and WiFi are connected */
-  if (!ubidots.connected() && wifi_on == true) {
-    
-    // Intentar reconectar cliente MQTT cada cierto tiempo de reintento (t_reconexion)
-    /* Try to reconnect MQTT client every t_reconexion time */
-    if (t_reconexion.finalizado()) {
-      ubidots.reconnect();
-      t_reconexion.repetir(); // Reiniciar tiempo *Restart time*
-    }
-  }
-
-  // Si el cliente se encuentra conectado, y el tiempo de envío ha finalizado, publicar variable/s a
-  // Ubidots y reiniciar tiempo
-  /* If the client is connected, and the send time has finished, publish variables to Ubidots */
+  // Si el cliente se encuentra conectado, y el tiempo de envío ha finalizado, iniciar una lectura
+  // del sensor y reiniciar tiempo. La lectura no bloquea: los datos llegan a lecturaDHT()
+  /**
+   * If the client is connected, and the send time has finished, start a sensor read and restart
+   * time. The read does not block: the data arrive at lecturaDHT()
+   */
   if (ubidots.connected() && t_envio.finalizado()) {
-    float temp = dht.readTemperature(); // Leer temperatura sensor
-                                        /* Read sensor temperature */
-    float hum  = dht.readHumidity();    // Leer humedad sensor
-                                        /* Read sensor relative humidity */
-
-    // Revisar si alguna de las variables no es un número (isnan), y arrojar error...
-    /* Check if any of the variables is not a number (isnan), and throw error... */
-    if (isnan(temp) || isnan(hum)) {
-      Serial.println("[ERROR] No se pudo leer el sensor DHT!");      
-    }
-
-    // ...de lo contrario, enviar variables a Ubidots
-    /* ...otherwise send variables to Ubidots */
-    else {
-      ubidots.add(VAR_TEMPERATURA, temp); // Añadir variable al buffer
-                                          /* Add variable to buffer */
-      ubidots.add(VAR_HUMEDAD, hum);      // Añadir variable al buffer
-                                          /* Add variable to buffer */
-
-      Serial.println("[INFO] Enviando datos...");
-      ubidots.ubidotsPublish(DISPOSITIVO);  // Publicar variable al dispositivo en Ubidots
-                                            /* Publish variable to device on Ubidots */
-      Serial.println("[INFO] Datos enviados\n");
-    }
-
+    dht.startRead();  // Iniciar lectura del sensor
+                      /* Start sensor read */
     t_envio.repetir(); // Reiniciar tiempo *Restart time*
   }
 
+  // poll() avanza la lectura en curso, y al terminar llama a lecturaDHT()
+  /* poll() advances the read in progress, and calls lecturaDHT() when it ends */
+  dht.poll();
+
   // loop() debe ser llamado constantemente para verificar conexión al servidor y revisar mensajes
   // entrantes (mensajes de un Subscribe)
   /* loop() must be constantly called to verify server connection and check incoming messages */
@@ -218,6 +205,44 @@ void loop() {
 }
 // * ---------------------------------------------------------------------------
 
+// ANCHOR Lectura DHT
+// * ---------------------------------------------------------------------------
+void lecturaDHT(DHT& sensor, DHTStatus estado) {
+  // Revisar si la lectura falló, y arrojar error...
+  /* Check if the read failed, and throw error... */
+  if (estado != DHT_OK) {
+    Serial.println("[ERROR] No se pudo leer el sensor DHT!");
+    return;
+  }
+
+  // ...de lo contrario, enviar variables a Ubidots. readAll() entrega todos los valores de la
+  // lectura recién terminada (temperatura, humedad, índice de calor, punto de rocío)
+  /**
+   * ...otherwise send variables to Ubidots. readAll() returns every value of the read that just
+   * ended (temperature, humidity, heat index, dew point)
+   */
+  DHTMeasurement medicion;
+  sensor.readAll(medicion);
+
+  // Añadir variables al buffer. Sólo se agregan si pasan su política de publicación
+  /* Add variables to buffer. They are only added if they pass their publish policy */
+  ubidots.add(VAR_TEMPERATURA, medicion.temperature);
+  ubidots.add(VAR_HUMEDAD, medicion.humidity);
+
+  Serial.println("[INFO] Enviando datos...");
+  ubidots.ubidotsPublish(DISPOSITIVO);  // Publicar variable al dispositivo en Ubidots
+                                        /* Publish variable to device on Ubidots */
+  Serial.println("[INFO] Datos enviados");
+
+  // Mostrar cuántos valores pasaron y cuántos se descartaron por cada política
+  /* Display how many values passed and how many were suppressed by each policy */
+  Serial.printf("[INFO] Temperatura: %u aceptados, %u descartados\n",
+                p_temperatura.passed(), p_temperatura.suppressed());
+  Serial.printf("[INFO] Humedad: %u aceptados, %u descartados\n\n",
+                p_humedad.passed(), p_humedad.suppressed());
+}
+// * ---------------------------------------------------------------------------
+
 // ANCHOR Callback Ubidots
 // * ---------------------------------------------------------------------------
 void callback(char* topic, uint8_t* payload, unsigned int length) {
@@ -229,14 +254,12 @@ void callback(char* topic, uint8_t* payload, unsigned int length) {
 // ANCHOR Callbacks WiFi
 // * ---------------------------------------------------------------------------
 void callbackWifiConectado(WiFiEvent_t event) {
-  wifi_on = true;
   digitalWrite(LED_WIFI, HIGH);
   Serial.print("[WIFI] WiFi Conectado. IP: ");
   Serial.println(WiFi.localIP());
 }
 
 void callbackWifiDesconectado(WiFiEvent_t event) {
-  wifi_on = false;
   digitalWrite(LED_WIFI, LOW);
   Serial.print("[WIFI] WiFi Desconectado!");
 }
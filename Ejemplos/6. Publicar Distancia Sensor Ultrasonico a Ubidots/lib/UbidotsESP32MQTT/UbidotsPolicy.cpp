@@ -0,0 +1,87 @@
+/**
+ * @file UbidotsPolicy.cpp
+ */
+
+#include "UbidotsPolicy.h"
+
+PublishPolicy::PublishPolicy(const char* variableLabel) {
+  _variableLabel = variableLabel;
+  _deadband = 0;
+  _relativeDeadband = 0;
+  _minInterval = 0;
+  _heartbeat = 0;
+  _lastValue = 0;
+  _lastTime = 0;
+  _hasLast = false;
+  _passed = 0;
+  _suppressed = 0;
+  _next = NULL;
+}
+
+PublishPolicy& PublishPolicy::setDeadband(float deadband) {
+  _deadband = deadband;
+  return *this;
+}
+
+PublishPolicy& PublishPolicy::setRelativeDeadband(float fraction) {
+  _relativeDeadband = fraction;
+  return *this;
+}
+
+PublishPolicy& PublishPolicy::setMinInterval(uint32_t interval) {
+  _minInterval = interval;
+  return *this;
+}
+
+PublishPolicy& PublishPolicy::setHeartbeat(uint32_t interval) {
+  _heartbeat = interval;
+  return *this;
+}
+
+bool PublishPolicy::evaluate(float value, uint32_t now) {
+  bool pass = true;
+
+  if (_hasLast) {
+    uint32_t elapsed = now - _lastTime;
+
+    if (elapsed < _minInterval) {
+      pass = false;
+
+    } else if (_heartbeat == 0 || elapsed < _heartbeat) {
+      float threshold = fabsf(_lastValue) * _relativeDeadband;
+
+      if (_deadband > threshold) {
+        threshold = _deadband;
+      }
+
+      pass = (threshold <= 0) || (fabsf(value - _lastValue) >= threshold);
+    }
+  }
+
+  if (!pass) {
+    _suppressed++;
+    return false;
+  }
+
+  _lastValue = value;
+  _lastTime = now;
+  _hasLast = true;
+  _passed++;
+  return true;
+}
+
+uint32_t PublishPolicy::passed() const {
+  return _passed;
+}
+
+uint32_t PublishPolicy::suppressed() const {
+  return _suppressed;
+}
+
+const char* PublishPolicy::label() const {
+  return _variableLabel;
+}
+
+PublishPolicy* PublishPolicy::next() const {
+  return _next;
+}
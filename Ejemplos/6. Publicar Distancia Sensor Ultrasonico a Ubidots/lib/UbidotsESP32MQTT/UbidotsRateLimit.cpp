@@ -0,0 +1,70 @@
+/**
+ * @file UbidotsRateLimit.cpp
+ */
+
+#include "UbidotsRateLimit.h"
+
+RateLimit::RateLimit() {
+  _deviceLabel = NULL;
+  _rate = 0;
+  _tokens = 1;
+  _burst = 1;
+  _last = 0;
+  _started = false;
+  _next = NULL;
+}
+
+RateLimit::RateLimit(const char* deviceLabel) : RateLimit() {
+  _deviceLabel = deviceLabel;
+}
+
+RateLimit& RateLimit::setRate(float perSecond) {
+  _rate = (perSecond > 0) ? perSecond : 0;
+  return *this;
+}
+
+RateLimit& RateLimit::setBurst(uint16_t burst) {
+  _burst = (burst > 0) ? burst : 1;
+  _tokens = _burst;
+  return *this;
+}
+
+bool RateLimit::ready(uint32_t now) {
+  if (_rate == 0) {
+    return true;
+  }
+
+  if (_started) {
+    _tokens += (now - _last) * _rate / 1000;
+
+    if (_tokens > _burst) {
+      _tokens = _burst;
+    }
+  }
+
+  _last = now;
+  _started = true;
+  return _tokens >= 1;
+}
+
+void RateLimit::consume() {
+  if (_rate != 0) {
+    _tokens -= 1;
+  }
+}
+
+uint32_t RateLimit::wait() const {
+  if (_rate == 0 || _tokens >= 1) {
+    return 0;
+  }
+
+  return (uint32_t)ceilf((1 - _tokens) * 1000 / _rate);
+}
+
+const char* RateLimit::label() const {
+  return _deviceLabel;
+}
+
+RateLimit* RateLimit::next() const {
+  return _next;
+}
@@ -0,0 +1,148 @@
+/**
+ * @file UbidotsSampler.h
+ */
+
+#ifndef UbidotsSampler_H
+#define UbidotsSampler_H
+
+#include <Arduino.h>
+
+#define AGGREGATE_CONTEXT_ENTRIES  4  //!< Entradas de contexto de un resumen: min, max, sd y n
+
+/**
+ * @brief Función que entrega una lectura del sensor (NAN si la lectura falló).
+ */
+typedef float (*SampleSource)(void);
+
+/**
+ * @brief Resumen de la ventana de un Sampler, listo para Ubidots::add(const SampleAggregate&).
+ */
+typedef struct SampleAggregate {
+  const char* _variableLabel;
+  uint16_t _count;      // Muestras en la ventana (0 si no hay)
+  float _mean;
+  float _min;
+  float _max;
+  float _variance;      // Varianza muestral (0 con menos de 2 muestras)
+} SampleAggregate;
+
+/**
+ * @brief Muestreo a tasa fija de una variable, con estadísticas de una ventana deslizante.
+ *
+ * poll() lee la fuente cada intervalo, sin acumular deriva, y guarda la lectura en un buffer
+ * circular con las últimas muestras. Al entrar cada muestra se actualizan en tiempo constante el
+ * mínimo y el máximo (colas monótonas) y la media y la varianza (Welford, quitando la muestra
+ * que sale de la ventana). Por ejemplo, con un intervalo de 100 ms y una ventana de 100 muestras,
+ * cada publicación cada 10 s resume las 100 lecturas del sensor en un solo valor.
+ */
+class Sampler {
+  public:
+    /**
+     * @brief Construir un nuevo muestreo.
+     *
+     * @param variableLabel Nombre de la variable
+     * @param source Función que lee el sensor, o NULL para registrar las muestras con record()
+     * @param interval Intervalo de muestreo en milisegundos
+     * @param window Cantidad de muestras de la ventana
+     */
+    Sampler(const char* variableLabel, SampleSource source, uint32_t interval, uint16_t window);
+    ~Sampler();
+
+    /**
+     * @brief Leer la fuente si corresponde. Se llama en cada loop().
+     *
+     * Las lecturas ocurren cada intervalo desde la primera llamada. Si loop() se atrasa más de un
+     * intervalo, las lecturas perdidas no se recuperan (ver missed()).
+     *
+     * @param now Tiempo actual en milisegundos (millis())
+     * @return true Se leyó la fuente
+     * @return false Aún no corresponde leer, o no hay fuente
+     */
+    bool poll(uint32_t now);
+
+    /**
+     * @brief Registrar una muestra. Si la ventana está llena, sale la muestra más antigua.
+     *
+     * @param value Valor numérico (NAN cuenta como lectura fallida y no entra a la ventana)
+     * @return true Muestra registrada
+     * @return false Lectura fallida
+     */
+    bool record(float value);
+
+    /**
+     * @brief Vaciar la ventana y los contadores.
+     */
+    void reset();
+
+    /**
+     * @brief Resumen de la ventana actual.
+     */
+    SampleAggregate aggregate() const;
+
+    /**
+     * @brief Cantidad de muestras en la ventana.
+     */
+    uint16_t count() const;
+
+    /**
+     * @brief Media de la ventana (0 si está vacía).
+     */
+    float mean() const;
+
+    /**
+     * @brief Varianza muestral de la ventana (0 con menos de 2 muestras).
+     */
+    float variance() const;
+
+    /**
+     * @brief Menor muestra de la ventana (0 si está vacía).
+     */
+    float minimum() const;
+
+    /**
+     * @brief Mayor muestra de la ventana (0 si está vacía).
+     */
+    float maximum() const;
+
+    /**
+     * @brief Cantidad de lecturas fallidas (NAN).
+     */
+    uint32_t failures() const;
+
+    /**
+     * @brief Cantidad de lecturas perdidas por llamar a poll() con atraso.
+     */
+    uint32_t missed() const;
+
+    /**
+     * @brief Nombre de la variable.
+     */
+    const char* label() const;
+
+  private:
+    void push(uint16_t* queue, uint16_t front, uint16_t& size, uint16_t slot, bool keepMax);
+    void refresh();
+
+    const char* _variableLabel;
+    SampleSource _source;
+    uint32_t _interval;
+    uint32_t _nextRead;
+    bool _started;
+    float* _values;       // Ventana, en orden de llegada desde _head
+    uint16_t* _maxQueue;  // Posiciones de la ventana con valores decrecientes
+    uint16_t* _minQueue;  // Posiciones de la ventana con valores crecientes
+    uint16_t _capacity;
+    uint16_t _head;
+    uint16_t _count;
+    uint16_t _maxFront;
+    uint16_t _maxSize;
+    uint16_t _minFront;
+    uint16_t _minSize;
+    uint16_t _sinceRefresh;
+    float _mean;
+    float _m2;            // Suma de los cuadrados de las desviaciones
+    uint32_t _failures;
+    uint32_t _missed;
+};
+
+#endif
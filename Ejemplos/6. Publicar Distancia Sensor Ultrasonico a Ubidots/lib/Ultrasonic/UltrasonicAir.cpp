@@ -0,0 +1,83 @@
+/*
+ * UltrasonicAir.cpp
+ *
+ * Speed of sound lookup table and fixed point distance.
+ *
+ * Released into the MIT License.
+ */
+
+#include "UltrasonicAir.h"
+
+#if defined(__AVR__)
+  #include <avr/pgmspace.h>
+  #define SOUND_READ(i) pgm_read_word(SOUND + (i))
+#else
+  #ifndef PROGMEM
+    #define PROGMEM
+  #endif
+  #define SOUND_READ(i) SOUND[i]
+#endif
+
+/*
+ * Speed of sound in dry air, 331.3 * sqrt(1 + T / 273.15) m/s, for each
+ * degree from ULTRASONIC_AIR_MIN to ULTRASONIC_AIR_MAX, as tenths of a
+ * millimetre per microsecond of echo (there and back) in Q14.
+ */
+static const uint16_t SOUND[ULTRASONIC_AIR_MAX - ULTRASONIC_AIR_MIN + 1] PROGMEM = {
+  25074, 25128, 25182, 25235, 25288, 25342, 25395, 25448, 25501, 25554,
+  25606, 25659, 25711, 25764, 25816, 25868, 25920, 25972, 26024, 26076,
+  26128, 26179, 26231, 26282, 26333, 26384, 26435, 26486, 26537, 26588,
+  26639, 26689, 26740, 26790, 26840, 26891, 26941, 26991, 27041, 27090,
+  27140, 27190, 27239, 27289, 27338, 27387, 27437, 27486, 27535, 27584,
+  27632, 27681, 27730, 27778, 27827, 27875, 27924, 27972, 28020, 28068,
+  28116, 28164, 28212, 28260, 28307, 28355, 28402, 28450, 28497, 28544,
+  28592, 28639, 28686, 28733, 28780, 28826, 28873, 28920, 28966, 29013,
+  29059, 29106, 29152, 29198, 29244, 29290, 29336, 29382, 29428, 29474,
+  29520, 29565, 29611, 29656, 29702, 29747, 29793, 29838, 29883, 29928,
+  29973, 30018, 30063, 30108, 30152, 30197, 30242, 30286, 30331, 30375,
+  30420, 30464, 30508, 30552, 30596, 30640, 30684, 30728, 30772, 30816,
+  30860, 30903, 30947, 30990, 31034, 31077
+};
+
+UltrasonicAir::UltrasonicAir(float temperature, float humidity) {
+  tenths = 200;
+  relative = 0;
+  scale = SOUND_READ(20 - ULTRASONIC_AIR_MIN);
+  set(temperature, humidity);
+}
+
+/*
+ * Update the snapshot. temperature is in Celsius and humidity in percent;
+ * both are clamped to the range of the table. Returns false (and keeps
+ * the previous values) if the temperature is not a number, e.g. after a
+ * failed sensor read; a humidity that is not a number counts as dry air.
+ */
+bool UltrasonicAir::set(float temperature, float humidity) {
+  if (temperature != temperature)
+    return false;
+
+  if (temperature < ULTRASONIC_AIR_MIN)
+    temperature = ULTRASONIC_AIR_MIN;
+  if (temperature > ULTRASONIC_AIR_MAX)
+    temperature = ULTRASONIC_AIR_MAX;
+  if (!(humidity > 0))
+    humidity = 0;
+  if (humidity > 100)
+    humidity = 100;
+
+  tenths = temperature * 10 + (temperature < 0 ? -0.5f : 0.5f);
+  relative = humidity + 0.5f;
+
+  // Interpolate between the two closest degrees
+  uint16_t offset = tenths - ULTRASONIC_AIR_MIN * 10;
+  uint8_t i = offset / 10;
+  uint8_t fraction = offset % 10;
+  uint16_t low = SOUND_READ(i);
+  uint16_t high = fraction > 0 ? SOUND_READ(i + 1) : low;
+  scale = low + ((high - low) * fraction + 5) / 10;
+
+  // Water vapour is lighter than air: about +0.0124 m/s per %RH, that is
+  // close to one unit of the factor per %RH
+  scale += (relative * 1016U + 500) / 1000;
+  return true;
+}
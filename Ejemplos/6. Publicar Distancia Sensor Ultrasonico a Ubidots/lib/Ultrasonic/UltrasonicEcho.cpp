@@ -0,0 +1,79 @@
+/*
+ * UltrasonicEcho.cpp
+ *
+ * Non-blocking ranging with interrupt timestamped echo edges.
+ *
+ * Released into the MIT License.
+ */
+
+#include "UltrasonicEcho.h"
+
+UltrasonicEcho::UltrasonicEcho() {
+  source = NULL;
+  state = ULTRASONIC_IDLE;
+  since = 0;
+  timeout = 0;
+  length = 0;
+}
+
+void UltrasonicEcho::setSource(UltrasonicEdgeSource *edgeSource) {
+  cancel();
+  source = edgeSource;
+}
+
+/*
+ * Send the trigger pulse and start recording the echo edges. The echo
+ * is collected by the following calls to poll(). Returns false if a
+ * measurement is already in progress or there is no sensor.
+ */
+bool UltrasonicEcho::start(unsigned long timeOut) {
+  if (source == NULL || state == ULTRASONIC_BUSY)
+    return false;
+
+  edges.clear();
+  source->trigger();
+  source->capture(&edges);
+  since = source->micros();
+  timeout = timeOut;
+  state = ULTRASONIC_BUSY;
+  return true;
+}
+
+/*
+ * Never blocks. Like the blocking read(), it waits up to timeout for the
+ * echo to start and up to timeout for it to end: a missing echo gives a
+ * duration of 0 and an echo longer than the timeout gives the timeout.
+ */
+UltrasonicStatus UltrasonicEcho::poll() {
+  if (state != ULTRASONIC_BUSY)
+    return state;
+
+  uint8_t count = edges.count;
+  unsigned long now = source->micros();
+
+  if (count == 2) {
+    length = edges.fall - edges.rise;
+    state = ULTRASONIC_OK;
+  } else if (count == 0 && now - since > timeout) {
+    length = 0;
+    state = ULTRASONIC_TIMEOUT;
+  } else if (count == 1 && now - edges.rise > timeout) {
+    length = timeout;
+    state = ULTRASONIC_TIMEOUT;
+  } else {
+    return ULTRASONIC_BUSY;
+  }
+
+  source->stop();
+  return state;
+}
+
+/*
+ * Abort the measurement in progress.
+ */
+void UltrasonicEcho::cancel() {
+  if (state == ULTRASONIC_BUSY) {
+    source->stop();
+    state = ULTRASONIC_IDLE;
+  }
+}
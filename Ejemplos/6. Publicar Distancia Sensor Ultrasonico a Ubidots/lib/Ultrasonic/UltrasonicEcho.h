@@ -0,0 +1,89 @@
+/*
+ * UltrasonicEcho.h
+ *
+ * Non-blocking ranging: the echo pin edges are timestamped by an
+ * interrupt and poll() turns them into a pulse length, so the caller
+ * never waits for the echo.
+ *
+ * This file does not depend on Arduino: the sensor is reached through
+ * UltrasonicEdgeSource, so the state machine also runs on a PC with
+ * synthetic edges.
+ *
+ * Released into the MIT License.
+ */
+
+#ifndef UltrasonicEcho_h
+#define UltrasonicEcho_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+enum UltrasonicStatus {
+  ULTRASONIC_IDLE,    // No measurement started
+  ULTRASONIC_BUSY,    // Waiting for the echo
+  ULTRASONIC_OK,      // Echo received
+  ULTRASONIC_TIMEOUT  // No echo, or echo longer than the timeout
+};
+
+/*
+ * Rising and falling edge of the echo pulse, written by the interrupt
+ * handler. Edges before the rise and after the fall are ignored.
+ */
+class UltrasonicEchoEdges {
+  public:
+    UltrasonicEchoEdges() { clear(); }
+    void clear() { count = 0; }
+    void record(unsigned long micros, bool high) {
+      if (high && count == 0) {
+        rise = micros;
+        count = 1;
+      } else if (!high && count == 1) {
+        fall = micros;
+        count = 2;
+      }
+    }
+
+    volatile unsigned long rise;
+    volatile unsigned long fall;
+    volatile uint8_t count;
+};
+
+/*
+ * Access to the sensor. UltrasonicPinEdges (Ultrasonic.h) uses the
+ * trigger and echo pins and the echo pin change interrupt; tests provide
+ * synthetic echoes.
+ */
+class UltrasonicEdgeSource {
+  public:
+    virtual ~UltrasonicEdgeSource() {}
+    virtual void trigger() = 0;                           // Send the trigger pulse
+    virtual void capture(UltrasonicEchoEdges *edges) = 0; // Record the echo edges
+    virtual void stop() = 0;                              // Stop recording
+    virtual unsigned long micros() = 0;                   // Current time
+};
+
+/*
+ * State machine for one measurement: trigger, then wait for both edges
+ * of the echo without blocking.
+ */
+class UltrasonicEcho {
+  public:
+    UltrasonicEcho();
+    void setSource(UltrasonicEdgeSource *source);
+    bool start(unsigned long timeOut);
+    UltrasonicStatus poll();
+    void cancel();
+    bool busy() const {return state == ULTRASONIC_BUSY;}
+    UltrasonicStatus status() const {return state;}
+    unsigned long duration() const {return length;}
+
+  private:
+    UltrasonicEdgeSource *source;
+    UltrasonicEchoEdges edges;
+    UltrasonicStatus state;
+    unsigned long since;
+    unsigned long timeout;
+    unsigned long length;
+};
+
+#endif // UltrasonicEcho_h
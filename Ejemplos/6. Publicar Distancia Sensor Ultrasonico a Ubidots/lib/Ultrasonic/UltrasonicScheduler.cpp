@@ -0,0 +1,171 @@
+/*
+ * UltrasonicScheduler.cpp
+ *
+ * Crosstalk-free round-robin measurement of several ultrasonic sensors.
+ *
+ * Released into the MIT License.
+ */
+
+#if ARDUINO >= 100
+  #include <Arduino.h>
+#else
+  #include <WProgram.h>
+#endif
+
+#include "UltrasonicScheduler.h"
+
+UltrasonicScheduler::UltrasonicScheduler(uint8_t maxSensors) {
+  sensors = (Ultrasonic **)malloc(maxSensors * sizeof(Ultrasonic *));
+  filters = (UltrasonicFilter **)malloc(maxSensors * sizeof(UltrasonicFilter *));
+  readings = (UltrasonicReading *)malloc(maxSensors * sizeof(UltrasonicReading));
+  capacity = (sensors != NULL && filters != NULL && readings != NULL) ? maxSensors : 0;
+  order = NULL;
+  orderLength = 0;
+  sensorCount = 0;
+  next = 0;
+  inFlight = -1;
+  guard = 10000UL;
+  lastEnd = 0;
+  started = 0;
+}
+
+UltrasonicScheduler::~UltrasonicScheduler() {
+  for (uint8_t i = 0; i < sensorCount; i++) {
+    delete sensors[i];
+    delete filters[i];
+  }
+  free(sensors);
+  free(filters);
+  free(readings);
+  free(order);
+}
+
+/*
+ * Add a sensor, with its own filter. Call it before begin(). Returns the
+ * index of the sensor, or -1 if the scheduler is full.
+ */
+int8_t UltrasonicScheduler::add(uint8_t trigPin, uint8_t echoPin, unsigned long timeOut) {
+  if (sensorCount >= capacity)
+    return -1;
+
+  Ultrasonic *sensor = new Ultrasonic(trigPin, echoPin, timeOut);
+  UltrasonicFilter *filter = new UltrasonicFilter();
+  if (sensor == NULL || filter == NULL) {
+    delete sensor;
+    delete filter;
+    return -1;
+  }
+  sensor->setFilter(filter);
+
+  UltrasonicReading *r = readings + sensorCount;
+  r->distance = 0;
+  r->timestamp = 0;
+  r->status = ULTRASONIC_IDLE;
+  r->measurements = 0;
+  r->failures = 0;
+
+  sensors[sensorCount] = sensor;
+  filters[sensorCount] = filter;
+  return sensorCount++;
+}
+
+/*
+ * Fire the sensors in this order, e.g. {0, 1, 0, 2} to measure sensor 0
+ * twice as often. Returns false (and keeps the previous order) if an
+ * index is not a sensor already added.
+ */
+bool UltrasonicScheduler::setOrder(const uint8_t *list, uint8_t length) {
+  if (length == 0)
+    return false;
+
+  for (uint8_t i = 0; i < length; i++) {
+    if (list[i] >= sensorCount)
+      return false;
+  }
+
+  uint8_t *copy = (uint8_t *)malloc(length);
+  if (copy == NULL)
+    return false;
+
+  memcpy(copy, list, length);
+  free(order);
+  order = copy;
+  orderLength = length;
+  next = 0;
+  return true;
+}
+
+/*
+ * Start the schedule. guardMicros is the quiet time left after each
+ * measurement before the next sensor is fired.
+ */
+void UltrasonicScheduler::begin(unsigned long guardMicros) {
+  guard = guardMicros;
+  next = 0;
+  inFlight = -1;
+  lastEnd = micros() - guard;
+  started = millis();
+}
+
+/*
+ * Advance the schedule. Call it often (from loop()): it polls the sensor
+ * being measured and fires the next one once the guard has elapsed, and
+ * never waits for an echo.
+ */
+void UltrasonicScheduler::loop() {
+  if (inFlight >= 0) {
+    Ultrasonic *sensor = sensors[inFlight];
+    UltrasonicStatus status = sensor->poll();
+    if (status == ULTRASONIC_BUSY)
+      return;
+
+    UltrasonicReading *r = readings + inFlight;
+    r->status = status;
+    r->measurements++;
+    if (status == ULTRASONIC_OK) {
+      r->distance = filters[inFlight]->distance();
+      r->timestamp = millis();
+    } else {
+      r->failures++;
+    }
+    inFlight = -1;
+    lastEnd = micros();
+  }
+
+  if (sensorCount == 0 || micros() - lastEnd < guard)
+    return;
+
+  uint8_t i = order != NULL ? order[next] : next;
+  uint8_t length = order != NULL ? orderLength : sensorCount;
+  next = (next + 1) % length;
+
+  if (sensors[i]->trigger()) {
+    inFlight = i;
+    readings[i].status = ULTRASONIC_BUSY;
+  } else {
+    // The echo pin has no interrupt: the sensor cannot be measured here
+    readings[i].status = ULTRASONIC_TIMEOUT;
+    readings[i].measurements++;
+    readings[i].failures++;
+    lastEnd = micros();
+  }
+}
+
+/*
+ * Measurements per second achieved for sensor i since begin().
+ */
+float UltrasonicScheduler::rate(uint8_t i) {
+  unsigned long elapsed = millis() - started;
+  return elapsed > 0 ? readings[i].measurements * 1000.0 / elapsed : 0;
+}
+
+/*
+ * Use the speed of sound of this snapshot for every sensor and filter
+ * (NULL to go back to the fixed scale of read()).
+ */
+void UltrasonicScheduler::setAir(const UltrasonicAir *air) {
+  for (uint8_t i = 0; i < sensorCount; i++) {
+    sensors[i]->setAir(air);
+    filters[i]->setAir(air);
+  }
+}
@@ -0,0 +1,59 @@
+/*
+ * UltrasonicScheduler.h
+ *
+ * Fires several ultrasonic sensors one at a time, in a configurable
+ * order, leaving a guard interval after each echo so the ping of one
+ * sensor is not heard by the next one (crosstalk). Echoes are captured
+ * with trigger() and poll(), so loop() never waits for them, and each
+ * sensor has its own UltrasonicFilter.
+ *
+ * Released into the MIT License.
+ */
+
+#ifndef UltrasonicScheduler_h
+#define UltrasonicScheduler_h
+
+#include "Ultrasonic.h"
+
+/*
+ * Last result of a sensor, in the shared table
+ */
+struct UltrasonicReading {
+  uint32_t distance;         // Filtered distance, in tenths of a millimetre (0 if none)
+  unsigned long timestamp;   // millis() of the last echo received (0 if none)
+  UltrasonicStatus status;   // Result of the last measurement
+  uint32_t measurements;     // Measurements done
+  uint32_t failures;         // Measurements without echo
+};
+
+class UltrasonicScheduler {
+  public:
+    UltrasonicScheduler(uint8_t capacity = 4);
+    ~UltrasonicScheduler();
+    int8_t add(uint8_t trigPin, uint8_t echoPin, unsigned long timeOut = 20000UL);
+    bool setOrder(const uint8_t *sensors, uint8_t length);
+    void begin(unsigned long guardMicros = 10000UL);
+    void loop();
+    float rate(uint8_t i);
+    void setAir(const UltrasonicAir *air);
+    uint8_t count() const {return sensorCount;}
+    Ultrasonic &sensor(uint8_t i) {return *sensors[i];}
+    UltrasonicFilter &filter(uint8_t i) {return *filters[i];}
+    const UltrasonicReading &reading(uint8_t i) const {return readings[i];}
+
+  private:
+    Ultrasonic **sensors;
+    UltrasonicFilter **filters;
+    UltrasonicReading *readings;
+    uint8_t *order;            // Sensors to fire, in turn (NULL: in the order added)
+    uint8_t orderLength;
+    uint8_t capacity;
+    uint8_t sensorCount;
+    uint8_t next;              // Position in the order
+    int8_t inFlight;           // Sensor being measured, or -1
+    unsigned long guard;       // Quiet time after each measurement, in microseconds
+    unsigned long lastEnd;     // micros() when the last measurement ended
+    unsigned long started;     // millis() of begin()
+};
+
+#endif // UltrasonicScheduler_h
@@ -101,23 +101,43 @@
 #define ECHO 23 // Pin ECHO del sensor
 /* -------------------------------------------------------------------------- */
 
+// NOTE Temperatura del aire
+/* -------------------------------------------------------------------------- */
+// La velocidad del sonido depende de la temperatura del aire (~0.6 m/s por °C). Ajustarla a la del
+// lugar de la medición, o actualizarla con aire.set() si se dispone de un sensor (p. ej. DHT22).
+/* The speed of sound depends on the air temperature (~0.6 m/s per °C). Set it to the temperature
+   where the sensor measures, or update it with aire.set() if a sensor (e.g. DHT22) is available. */
+#define TEMPERATURA_AIRE 20.0 // °C
+/* -------------------------------------------------------------------------- */
+
 /* ---------------------------- Objetos (Objects) --------------------------- */
 // Constructor principal, pasa como parámetro el Token de Ubidots
 /* Main Constructor, pass Ubidots Token as a parameter */
 Ubidots ubidots(TOKEN);
 
-// Delays para Envío de Paquetes, reconexión WiFi y lectura sensor
-/* Delays for Sending Packages, WiFi reconnection and reading sensor */
-DelayMillis t_envio, t_reconexion, t_lectura;
+// Delays para Envío de Paquetes y lectura sensor
+/* Delays for Sending Packages and reading sensor */
+DelayMillis t_envio, t_lectura;
 
 // Constructor sensor ultrasónico, pasan como parámetros los pines
 /* Ultrasonic sensor constructor, pass the pins as parameters */
 Ultrasonic ultrasonic(TRIG, ECHO);
+
+// Filtro de los ecos: mediana de los últimos 5, descarta los valores muy alejados de ella (picos
+// típicos del HC-SR04) y suaviza el resultado
+/* Echo filter: median of the last 5, discards values far from it (typical HC-SR04 spikes) and
+   smooths the result */
+UltrasonicFilter filtro;
+
+// Velocidad del sonido según la temperatura del aire, compartida por el sensor y el filtro
+/* Speed of sound for the air temperature, shared by the sensor and the filter */
+UltrasonicAir aire(TEMPERATURA_AIRE);
 /* -------------------------------------------------------------------------- */
 
 /* ------------------ Variables Globales (Global Variables) ----------------- */
-bool wifi_on = false; // Indica si hay conexión activa a WiFi
-                      /* Indicates WiFi connection */
+// La medición no bloquea: trigger() dispara el sensor y poll() avisa cuando llegó el eco
+/* Measuring does not block: trigger() fires the sensor and poll() tells when the echo arrived */
+bool midiendo = false;
 /* -------------------------------------------------------------------------- */
 
 /* -------------- Declaracion Funciones (Function Declarations) ------------- */
@@ -152,11 +172,18 @@ void setup() {
   /* Start delays */
   t_envio.empezar(10000);     // Enviar cada 10s a Ubidots
                               /* Send every 10s to Ubidots */
-  t_reconexion.empezar(3000); // Intentar reconectar cada 3s en caso de que no haya conexión
-                              /* Try to reconnect every 3s if there are no connection */
   t_lectura.empezar(500);     // Leer cada 500ms el sensor ultrasónico
                               /* Read every 500ms the ultrasonic sensor */
 
+  // Cada eco medido pasa por el filtro
+  /* Every measured echo goes through the filter */
+  ultrasonic.setFilter(&filtro);
+
+  // Compensar las distancias con la temperatura del aire
+  /* Compensate the distances with the air temperature */
+  ultrasonic.setAir(&aire);
+  filtro.setAir(&aire);
+
   // Asociar Callbacks del WiFi
   /* Associate WiFi Callbacks */
   WiFi.onEvent(callbackWifiConectado, SYSTEM_EVENT_STA_GOT_IP);
@@ -168,6 +195,8 @@ void setup() {
   /* Configure Ubidots client */
   ubidots.setDebug(true);   // Setear a TRUE para visualizar información útil
                             /* Set to TRUE to display useful info */
+  ubidots.setConnectTimeout(1000, 1); // Si el servidor no responde, loop() espera a lo más 1 s
+                                      /* If the server does not respond, loop() waits 1 s at most */
   ubidots.begin(callback);  // Iniciar Servidor y asociar Callback para recibir paquetes
                             /* Start Server and associate Callback to receive packages */
   ubidots.wifiConnection(SSID, PASS); // Iniciar conexión WiFi
@@ -178,44 +207,54 @@ void setup() {
 // ANCHOR loop()
 // * ---------------------------------------------------------------------------
 void loop() {
-  // Revisar si el cliente MQTT y el WiFi se encuentran conectados
-  /* Check if the MQTT client and WiFi are connected */
-  if (!ubidots.connected() && wifi_on == true) {
-    
-    // Intentar reconectar cliente MQTT cada cierto tiempo de reintento (t_reconexion)
-    /* Try to reconnect MQTT client every t_reconexion time */
-    if (t_reconexion.finalizado()) {
-      ubidots.reconnect();
-      t_reconexion.repetir(); // Reiniciar tiempo *Restart time*
-    }
-  }
-
   // Si el cliente se encuentra conectado, y el tiempo de envío ha finalizado, publicar variable/s a
   // Ubidots y reiniciar tiempo
   /* If the client is connected, and the send time has finished, publish variables to Ubidots */
   if (ubidots.connected() && t_envio.finalizado()) {    
-    uint16_t distancia = ultrasonic.read();
-    
-    ubidots.add(VAR_DISTANCIA, distancia);  // Añadir variable al buffer
-                                            /* Add variable to buffer */
-
-    Serial.println("[INFO] Enviando datos...");
-    ubidots.ubidotsPublish(DISPOSITIVO);    // Publicar variable al dispositivo en Ubidots
-                                            /* Publish variable to device on Ubidots */
-    Serial.println("[INFO] Datos enviados\n");
+    // Sin ningún eco todavía, el filtro no tiene distancia y no se publica nada
+    /* With no echo yet, the filter has no distance and nothing is published */
+    if (filtro.count() > 0) {
+      // Distancia filtrada, en cm (el filtro la entrega en décimas de mm)
+      /* Filtered distance, in cm (the filter gives it in tenths of a mm) */
+      float distancia = filtro.distance() / 100.0;
+
+      ubidots.add(VAR_DISTANCIA, distancia);  // Añadir variable al buffer
+                                              /* Add variable to buffer */
+
+      Serial.println("[INFO] Enviando datos...");
+      ubidots.ubidotsPublish(DISPOSITIVO);    // Publicar variable al dispositivo en Ubidots
+                                              /* Publish variable to device on Ubidots */
+      Serial.println("[INFO] Datos enviados\n");
+    }
 
     t_envio.repetir(); // Reiniciar tiempo *Restart time*
   }
 
-  // Mostrar distancia por el monitor serial
-  /* Display distance on the serial monitor */
-  if (t_lectura.finalizado()) {
-    Serial.print("Distancia: ");
-    Serial.println(ultrasonic.read());
-
+  // Disparar una medición; el eco se mide por interrupción sin detener el loop
+  /* Trigger a measurement; the echo is timed by an interrupt without stopping the loop */
+  if (!midiendo && t_lectura.finalizado()) {
+    midiendo = ultrasonic.trigger();
     t_lectura.repetir();
   }
 
+  // Cuando llega el eco (ya filtrado), mostrar la distancia por el monitor serial
+  /* When the echo arrives (already filtered), display the distance on the serial monitor */
+  if (midiendo) {
+    UltrasonicStatus estado = ultrasonic.poll();
+
+    if (estado == ULTRASONIC_OK) {
+      Serial.print("Distancia: ");
+      Serial.print(ultrasonic.distance());
+      Serial.print(" cm, filtrada: ");
+      Serial.print(filtro.distance() / 100.0);
+      Serial.println(" cm");
+    } else if (estado == ULTRASONIC_TIMEOUT) {
+      Serial.println("[INFO] Sin eco del sensor");
+    }
+
+    midiendo = estado == ULTRASONIC_BUSY;
+  }
+
   // loop() debe ser llamado constantemente para verificar conexión al servidor y revisar mensajes
   // entrantes (mensajes de un Subscribe)
   /* loop() must be constantly called to verify server connection and check incoming messages */
@@ -234,14 +273,12 @@ void callback(char* topic, uint8_t* payload, unsigned int length) {
 // ANCHOR Callbacks WiFi
 // * ---------------------------------------------------------------------------
 void callbackWifiConectado(WiFiEvent_t event) {
-  wifi_on = true;
   digitalWrite(LED_WIFI, HIGH);
   Serial.print("[WIFI] WiFi Conectado. IP: ");
   Serial.println(WiFi.localIP());
 }
 
 void callbackWifiDesconectado(WiFiEvent_t event) {
-  wifi_on = false;
   digitalWrite(LED_WIFI, LOW);
   Serial.print("[WIFI] WiFi Desconectado!");
 }
@@ -19,6 +19,8 @@
 #define DHT_H
 
 #include "Arduino.h"
+#include "DHTEdges.h"
+#include "DHTKernels.h"
 
 /* Uncomment to enable printing out nice debug messages. */
 //#define DHT_DEBUG
@@ -47,6 +49,59 @@
 #define DHT21 21  /**< DHT TYPE 21 */
 #define AM2301 21 /**< AM2301 */
 
+#define MIN_INTERVAL 2000 /**< min interval value */
+
+/* Interrupt handlers must be in IRAM on ESP boards. */
+#if defined(ESP32)
+#define DHT_ISR_ATTR IRAM_ATTR
+#elif defined(ESP8266)
+#define DHT_ISR_ATTR ICACHE_RAM_ATTR
+#else
+#define DHT_ISR_ATTR
+#endif
+
+class DHT;
+
+/*!
+ *  @brief  Called when an asynchronous read ends
+ */
+typedef void (*DHTReadCallback)(DHT &sensor, DHTStatus status);
+
+/*!
+ *  @brief  Result of DHT::readAll(): every value from a single acquisition
+ */
+typedef struct DHTMeasurement {
+  float temperature; /**< Temperature, in Celsius */
+  float fahrenheit;  /**< Temperature, in Fahrenheit */
+  float humidity;    /**< Relative humidity, in percent */
+  float heatIndex;   /**< Heat index, in Celsius */
+  float dewPoint;    /**< Dew point, in Celsius */
+  uint32_t timestamp; /**< millis() when the sensor was read */
+} DHTMeasurement;
+
+/*!
+ *  @brief  Data line on a GPIO, with its edges timestamped by the pin change
+ *          interrupt
+ */
+class DHTPinEdges : public DHTEdgeSource {
+public:
+  DHTPinEdges(uint8_t pin);
+  void startSignal();
+  void capture(DHTEdgeBuffer *edges);
+  void stop();
+  uint32_t micros();
+
+private:
+  static void onEdge(void *arg);
+#if !defined(ESP32) && !defined(ESP8266)
+  static void onEdge();
+  static DHTPinEdges *_capturing; // No interrupt argument: one line at a time
+#endif
+
+  uint8_t _pin;
+  DHTEdgeBuffer *volatile _edges;
+};
+
 /*!
  *  @brief  Class that stores state and functions for DHT
  */
@@ -61,7 +116,13 @@ public:
   float computeHeatIndex(float temperature, float percentHumidity,
                          bool isFahrenheit = true);
   float readHumidity(bool force = false);
+  float computeDewPoint(float temperature, float percentHumidity);
+  bool readAll(DHTMeasurement &measurement, bool force = false);
   bool read(bool force = false);
+  bool startRead(bool force = false);
+  DHTStatus poll();
+  void onRead(DHTReadCallback callback);
+  void setEdgeSource(DHTEdgeSource *source);
 
 private:
   uint8_t data[5];
@@ -75,8 +136,12 @@ private:
   uint32_t _lastreadtime, _maxcycles;
   bool _lastresult;
   uint8_t pullTime; // Time (in usec) to pull up data line before reading
+  DHTPinEdges _pinEdges;
+  DHTAsyncReader _async;
+  DHTReadCallback _callback;
 
   uint32_t expectPulse(bool level);
+  bool decodeTenths(int16_t *temperature, uint16_t *humidity);
 };
 
 /*!
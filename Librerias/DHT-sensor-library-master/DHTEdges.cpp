@@ -0,0 +1,116 @@
+/*!
+ *  @file DHTEdges.cpp
+ *
+ *  Interrupt-driven acquisition of DHT frames.
+ *
+ *  MIT license, all text above must be included in any redistribution
+ */
+
+#include "DHTEdges.h"
+
+/*!
+ *  @brief  Instantiates a reader without a line. setSource() must be called
+ *          before start().
+ */
+DHTAsyncReader::DHTAsyncReader() {
+  _source = NULL;
+  _since = 0;
+  _startMicros = 0;
+  _capturing = false;
+  _status = DHT_IDLE;
+  _frame.data[0] = _frame.data[1] = _frame.data[2] = _frame.data[3] =
+      _frame.data[4] = 0;
+  _frame.status = DHT_IDLE;
+}
+
+/*!
+ *  @brief  Set the data line used by the following reads
+ *  @param  source
+ *          data line (GPIO or synthetic)
+ */
+void DHTAsyncReader::setSource(DHTEdgeSource *source) {
+  cancel();
+  _source = source;
+}
+
+/*!
+ *  @brief  Send the start signal. The frame is captured by the following calls
+ *          to poll().
+ *  @param  startMicros
+ *          time the line is held low, in microseconds
+ *  @return false if a read is already in progress or there is no line
+ */
+bool DHTAsyncReader::start(uint32_t startMicros) {
+  if (_source == NULL || _status == DHT_BUSY) {
+    return false;
+  }
+
+  _source->startSignal();
+  _since = _source->micros();
+  _startMicros = startMicros;
+  _capturing = false;
+  _status = DHT_BUSY;
+  return true;
+}
+
+/*!
+ *  @brief  Advance the read. Never blocks: it ends the start signal when it is
+ *          due and decodes the frame once all its edges have arrived.
+ *  @return DHT_BUSY while the read is in progress, then its result
+ */
+DHTStatus DHTAsyncReader::poll() {
+  if (_status != DHT_BUSY) {
+    return _status;
+  }
+
+  uint32_t now = _source->micros();
+
+  if (!_capturing) {
+    if (now - _since < _startMicros) {
+      return DHT_BUSY;
+    }
+
+    _edges.clear();
+    _capturing = true;
+    _since = now;
+    _source->capture(&_edges);
+    return DHT_BUSY;
+  }
+
+  if (_edges.count < DHT_EDGE_COUNT && now - _since < DHT_FRAME_TIMEOUT) {
+    return DHT_BUSY;
+  }
+
+  _source->stop();
+  _capturing = false;
+
+  // The edge that ends the frame is not needed to decode bit 39
+  _status = (_edges.count >= DHT_EDGE_COUNT - 1) ? decode() : DHT_TIMEOUT;
+  return _status;
+}
+
+/*!
+ *  @brief  Abort the read in progress and release the line
+ */
+void DHTAsyncReader::cancel() {
+  if (_status == DHT_BUSY) {
+    _source->stop();
+    _capturing = false;
+    _status = DHT_IDLE;
+  }
+}
+
+/*!
+ *  @brief  Decode the captured edges with dhtDecodeFrame()
+ *  @return DHT_OK or DHT_CHECKSUM
+ */
+DHTStatus DHTAsyncReader::decode() {
+  uint32_t pulses[DHT_FRAME_PULSES];
+
+  // Edges 0 and 1 are the response; edge 2 starts the low pulse of bit 0
+  for (int i = 0; i < DHT_FRAME_PULSES; ++i) {
+    pulses[i] = _edges.time[3 + i] - _edges.time[2 + i];
+  }
+
+  return dhtDecodeFrame(pulses, DHT_FRAME_PULSES, &_frame);
+}
@@ -0,0 +1,79 @@
+/*!
+ *  @file DHTFrame.cpp
+ *
+ *  Hardware-free decoding of DHT frames.
+ *
+ *  MIT license, all text above must be included in any redistribution
+ */
+
+#include "DHTFrame.h"
+
+/*!
+ *  @brief  Decode a frame from its pulse lengths.
+ *
+ *  Each bit is sent as a ~50 us low pulse followed by a ~28 us (0) or ~70 us
+ *  (1) high pulse. The lengths may be in any unit (microseconds, or loop
+ *  cycles as measured by DHT::read()), so the 0/1 threshold is the average
+ *  length of the 40 low pulses: a single disturbed low pulse does not flip its
+ *  bit, as it would when comparing each high pulse with its own low pulse.
+ *
+ *  @param  pulses
+ *          pulse lengths: low and high pulse of bit 0, then of bit 1, etc.
+ *  @param  count
+ *          pulses available (a truncated frame has less than 80)
+ *  @param  frame
+ *          decoded bytes, status and margins
+ *  @return DHT_OK, DHT_CHECKSUM, or DHT_TIMEOUT if the frame is incomplete
+ */
+DHTStatus dhtDecodeFrame(const uint32_t *pulses, size_t count,
+                         DHTFrame *frame) {
+  frame->data[0] = frame->data[1] = frame->data[2] = frame->data[3] =
+      frame->data[4] = 0;
+  frame->minMargin = 0;
+  frame->weakestBit = 0;
+
+  if (count < DHT_FRAME_PULSES) {
+    frame->status = DHT_TIMEOUT;
+    return frame->status;
+  }
+
+  // Pulses are shorter than the read timeout (1 ms), so the sums fit in 32 bits
+  uint32_t lowTotal = 0;
+  for (int i = 0; i < DHT_FRAME_BITS; ++i) {
+    if (pulses[2 * i] == DHT_PULSE_TIMEOUT ||
+        pulses[2 * i + 1] == DHT_PULSE_TIMEOUT) {
+      frame->status = DHT_TIMEOUT;
+      return frame->status;
+    }
+    lowTotal += pulses[2 * i];
+  }
+
+  // Twice the threshold, so the comparison stays in integers
+  uint32_t threshold2 = lowTotal / (DHT_FRAME_BITS / 2);
+  frame->minMargin = UINT16_MAX;
+
+  for (int i = 0; i < DHT_FRAME_BITS; ++i) {
+    uint32_t high2 = pulses[2 * i + 1] * 2;
+    uint32_t margin2;
+
+    frame->data[i / 8] <<= 1;
+    if (high2 > threshold2) {
+      frame->data[i / 8] |= 1;
+      margin2 = high2 - threshold2;
+    } else {
+      margin2 = threshold2 - high2;
+    }
+
+    uint16_t margin = (margin2 / 2 > UINT16_MAX) ? UINT16_MAX : margin2 / 2;
+    frame->margin[i] = margin;
+    if (margin < frame->minMargin) {
+      frame->minMargin = margin;
+      frame->weakestBit = i;
+    }
+  }
+
+  uint8_t sum = frame->data[0] + frame->data[1] + frame->data[2] +
+                frame->data[3];
+  frame->status = (frame->data[4] == sum) ? DHT_OK : DHT_CHECKSUM;
+  return frame->status;
+}
@@ -0,0 +1,205 @@
+/*!
+ *  @file DHTKernels.cpp
+ *
+ *  Float-only heat index and dew point.
+ *
+ *  MIT license, all text above must be included in any redistribution
+ */
+
+#include "DHTKernels.h"
+#include <math.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* Rothfusz regression, grouped by powers of the humidity and each group in
+ * Horner form on the temperature (Fahrenheit):
+ *   HI = A(T) + RH * (B(T) + RH * C(T)) */
+#define HI_A0 -42.379f
+#define HI_A1 2.04901523f
+#define HI_A2 -0.00683783f
+#define HI_B0 10.14333127f
+#define HI_B1 -0.22475541f
+#define HI_B2 0.00122874f
+#define HI_C0 -0.05481717f
+#define HI_C1 0.00085282f
+#define HI_C2 -0.00000199f
+
+#define F_TO_C 0.55555f /**< Same factor as DHT::convertFtoC() */
+
+/* Magnus formula (Alduchov and Eskridge coefficients) */
+#define MAGNUS_B 17.625f
+#define MAGNUS_C 243.04f
+
+/*!
+ *  @brief  Heat index in Fahrenheit. Same equations as
+ *          DHT::computeHeatIndex() (Steadman, then Rothfusz with its
+ *          adjustments above 79 F), in single precision and without pow().
+ */
+static inline float heatIndexF(float t, float rh) {
+  // 0.5 * (T + 61 + (T - 68) * 1.2 + RH * 0.094)
+  float hi = 1.1f * t - 10.3f + 0.047f * rh;
+
+  if (hi > 79) {
+    float a = HI_A0 + t * (HI_A1 + t * HI_A2);
+    float b = HI_B0 + t * (HI_B1 + t * HI_B2);
+    float c = HI_C0 + t * (HI_C1 + t * HI_C2);
+    hi = a + rh * (b + rh * c);
+
+    if ((rh < 13) && (t >= 80) && (t <= 112)) {
+      hi -= ((13 - rh) * 0.25f) * sqrtf((17 - fabsf(t - 95)) * 0.05882f);
+    } else if ((rh > 85) && (t >= 80) && (t <= 87)) {
+      hi += ((rh - 85) * 0.1f) * ((87 - t) * 0.2f);
+    }
+  }
+
+  return hi;
+}
+
+/*!
+ *  @brief  Compute Heat Index in single precision
+ *  @param  temperature
+ *          temperature in selected scale
+ *  @param  percentHumidity
+ *          humidity in percent
+ *  @param  isFahrenheit
+ *          true if fahrenheit, false if celcius
+ *  @return heat index in the same scale
+ */
+float dhtHeatIndex(float temperature, float percentHumidity,
+                   bool isFahrenheit) {
+  if (isFahrenheit) {
+    return heatIndexF(temperature, percentHumidity);
+  }
+  return (heatIndexF(temperature * 1.8f + 32, percentHumidity) - 32) * F_TO_C;
+}
+
+/*!
+ *  @brief  Compute Heat Index for arrays of samples. On x86 four samples are
+ *          computed at a time with SSE2, evaluating every branch and keeping
+ *          the one that applies; elsewhere it is a loop over dhtHeatIndex().
+ *  @param  temperature
+ *          temperatures in selected scale
+ *  @param  percentHumidity
+ *          humidities in percent
+ *  @param  heatIndex
+ *          results, in the same scale (may be one of the inputs)
+ *  @param  count
+ *          number of samples
+ *  @param  isFahrenheit
+ *          true if fahrenheit, false if celcius
+ */
+void dhtHeatIndexBatch(const float *temperature, const float *percentHumidity,
+                       float *heatIndex, size_t count, bool isFahrenheit) {
+  size_t i = 0;
+
+#if defined(__SSE2__)
+  const __m128 signMask = _mm_set1_ps(-0.0f);
+  const __m128 zero = _mm_setzero_ps();
+
+  for (; i + 4 <= count; i += 4) {
+    __m128 t = _mm_loadu_ps(temperature + i);
+    __m128 rh = _mm_loadu_ps(percentHumidity + i);
+
+    if (!isFahrenheit) {
+      t = _mm_add_ps(_mm_mul_ps(t, _mm_set1_ps(1.8f)), _mm_set1_ps(32));
+    }
+
+    __m128 simple =
+        _mm_add_ps(_mm_sub_ps(_mm_mul_ps(_mm_set1_ps(1.1f), t),
+                              _mm_set1_ps(10.3f)),
+                   _mm_mul_ps(_mm_set1_ps(0.047f), rh));
+
+    __m128 a = _mm_add_ps(
+        _mm_set1_ps(HI_A0),
+        _mm_mul_ps(t, _mm_add_ps(_mm_set1_ps(HI_A1),
+                                 _mm_mul_ps(t, _mm_set1_ps(HI_A2)))));
+    __m128 b = _mm_add_ps(
+        _mm_set1_ps(HI_B0),
+        _mm_mul_ps(t, _mm_add_ps(_mm_set1_ps(HI_B1),
+                                 _mm_mul_ps(t, _mm_set1_ps(HI_B2)))));
+    __m128 c = _mm_add_ps(
+        _mm_set1_ps(HI_C0),
+        _mm_mul_ps(t, _mm_add_ps(_mm_set1_ps(HI_C1),
+                                 _mm_mul_ps(t, _mm_set1_ps(HI_C2)))));
+    __m128 hi = _mm_add_ps(
+        a, _mm_mul_ps(rh, _mm_add_ps(b, _mm_mul_ps(rh, c))));
+
+    // Dry adjustment: RH < 13 and 80 <= T <= 112
+    __m128 dry = _mm_and_ps(
+        _mm_cmplt_ps(rh, _mm_set1_ps(13)),
+        _mm_and_ps(_mm_cmpge_ps(t, _mm_set1_ps(80)),
+                   _mm_cmple_ps(t, _mm_set1_ps(112))));
+    __m128 distance =
+        _mm_andnot_ps(signMask, _mm_sub_ps(t, _mm_set1_ps(95)));
+    __m128 root = _mm_sqrt_ps(_mm_max_ps(
+        _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(17), distance),
+                   _mm_set1_ps(0.05882f)),
+        zero));
+    __m128 dryAdjust = _mm_mul_ps(
+        _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(13), rh), _mm_set1_ps(0.25f)),
+        root);
+
+    // Humid adjustment: RH > 85 and 80 <= T <= 87
+    __m128 humid = _mm_and_ps(
+        _mm_cmpgt_ps(rh, _mm_set1_ps(85)),
+        _mm_and_ps(_mm_cmpge_ps(t, _mm_set1_ps(80)),
+                   _mm_cmple_ps(t, _mm_set1_ps(87))));
+    __m128 humidAdjust = _mm_mul_ps(
+        _mm_mul_ps(_mm_sub_ps(rh, _mm_set1_ps(85)), _mm_set1_ps(0.1f)),
+        _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(87), t), _mm_set1_ps(0.2f)));
+
+    hi = _mm_sub_ps(hi, _mm_and_ps(dry, dryAdjust));
+    hi = _mm_add_ps(hi, _mm_and_ps(humid, humidAdjust));
+
+    // Rothfusz only where the simple formula is above 79 F
+    __m128 rothfusz = _mm_cmpgt_ps(simple, _mm_set1_ps(79));
+    hi = _mm_or_ps(_mm_and_ps(rothfusz, hi), _mm_andnot_ps(rothfusz, simple));
+
+    if (!isFahrenheit) {
+      hi = _mm_mul_ps(_mm_sub_ps(hi, _mm_set1_ps(32)), _mm_set1_ps(F_TO_C));
+    }
+
+    _mm_storeu_ps(heatIndex + i, hi);
+  }
+#endif
+
+  for (; i < count; i++) {
+    heatIndex[i] =
+        dhtHeatIndex(temperature[i], percentHumidity[i], isFahrenheit);
+  }
+}
+
+/*!
+ *  @brief  Compute Dew Point with the Magnus formula
+ *          (Alduchov and Eskridge coefficients, -40 to 50 C)
+ *  @param  temperature
+ *          temperature in Celsius
+ *  @param  percentHumidity
+ *          humidity in percent
+ *  @return dew point in Celsius
+ */
+float dhtDewPoint(float temperature, float percentHumidity) {
+  float gamma = logf(percentHumidity * 0.01f) +
+                MAGNUS_B * temperature / (MAGNUS_C + temperature);
+  return MAGNUS_C * gamma / (MAGNUS_B - gamma);
+}
+
+/*!
+ *  @brief  Compute Dew Point for arrays of samples
+ *  @param  temperature
+ *          temperatures in Celsius
+ *  @param  percentHumidity
+ *          humidities in percent
+ *  @param  dewPoint
+ *          results, in Celsius (may be one of the inputs)
+ *  @param  count
+ *          number of samples
+ */
+void dhtDewPointBatch(const float *temperature, const float *percentHumidity,
+                      float *dewPoint, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    dewPoint[i] = dhtDewPoint(temperature[i], percentHumidity[i]);
+  }
+}
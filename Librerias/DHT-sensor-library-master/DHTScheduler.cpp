@@ -0,0 +1,135 @@
+/*!
+ *  @file DHTScheduler.cpp
+ *
+ *  Round-robin reading of several DHT sensors.
+ *
+ *  MIT license, all text above must be included in any redistribution
+ */
+
+#include "DHTScheduler.h"
+
+/*!
+ *  @brief  Instantiates a scheduler without sensors
+ *  @param  capacity
+ *          maximum number of sensors
+ */
+DHTScheduler::DHTScheduler(uint8_t capacity) {
+  _sensors = (DHT **)malloc(capacity * sizeof(DHT *));
+  _readings = (DHTReading *)malloc(capacity * sizeof(DHTReading));
+  _capacity = (_sensors != NULL && _readings != NULL) ? capacity : 0;
+  _count = 0;
+  _next = 0;
+  _inFlight = -1;
+  _slot = MIN_INTERVAL;
+  _nextStart = 0;
+}
+
+DHTScheduler::~DHTScheduler() {
+  for (uint8_t i = 0; i < _count; i++) {
+    delete _sensors[i];
+  }
+  free(_sensors);
+  free(_readings);
+}
+
+/*!
+ *  @brief  Add a sensor. Call it before begin().
+ *  @param  pin
+ *          pin number that sensor is connected
+ *  @param  type
+ *          type of sensor
+ *  @return index of the sensor, or -1 if the scheduler is full
+ */
+int8_t DHTScheduler::add(uint8_t pin, uint8_t type) {
+  if (_count >= _capacity) {
+    return -1;
+  }
+
+  DHT *sensor = new DHT(pin, type);
+  if (sensor == NULL) {
+    return -1;
+  }
+
+  DHTReading *r = _readings + _count;
+  r->temperature = NAN;
+  r->humidity = NAN;
+  r->timestamp = 0;
+  r->status = DHT_IDLE;
+  r->failures = 0;
+
+  _sensors[_count] = sensor;
+  return _count++;
+}
+
+/*!
+ *  @brief  Set up the sensors and start the schedule
+ *  @param  interval
+ *          time between two reads of the same sensor, in ms. Values below
+ *          MIN_INTERVAL are raised to it.
+ */
+void DHTScheduler::begin(uint32_t interval) {
+  for (uint8_t i = 0; i < _count; i++) {
+    _sensors[i]->begin();
+  }
+
+  if (interval < MIN_INTERVAL) {
+    interval = MIN_INTERVAL;
+  }
+
+  // Each sensor gets an equal share of the interval
+  _slot = (_count > 0) ? interval / _count : interval;
+  _next = 0;
+  _inFlight = -1;
+  _nextStart = millis();
+}
+
+/*!
+ *  @brief  Advance the schedule. Call it often (from loop()): it polls the
+ *          read in flight and starts the next one when its turn comes, and
+ *          never waits for a sensor.
+ */
+void DHTScheduler::loop() {
+  if (_inFlight >= 0) {
+    DHT *sensor = _sensors[_inFlight];
+    DHTStatus status = sensor->poll();
+    if (status == DHT_BUSY) {
+      return;
+    }
+
+    DHTReading *r = _readings + _inFlight;
+    DHTMeasurement m;
+    r->status = status;
+    // The read just ended, so readAll() returns its data without a new read
+    if (status == DHT_OK && sensor->readAll(m)) {
+      r->temperature = m.temperature;
+      r->humidity = m.humidity;
+      r->timestamp = m.timestamp;
+    } else {
+      r->failures++;
+    }
+    _inFlight = -1;
+  }
+
+  uint32_t now = millis();
+  if (_count == 0 || (int32_t)(now - _nextStart) < 0) {
+    return;
+  }
+
+  // The scheduler keeps each sensor MIN_INTERVAL apart, so the read is forced
+  if (_sensors[_next]->startRead(true)) {
+    _inFlight = _next;
+    _readings[_next].status = DHT_BUSY;
+  } else {
+    // A read started outside the scheduler is still running: the sensor is
+    // fine, but the slot is lost, so it still counts as a failed read
+    _readings[_next].status = DHT_NOT_STARTED;
+    _readings[_next].failures++;
+  }
+  _next = (_next + 1) % _count;
+
+  // Keep the slots evenly spaced; after a long stall, start again from now
+  _nextStart += _slot;
+  if ((int32_t)(now - _nextStart) >= (int32_t)_slot) {
+    _nextStart = now + _slot;
+  }
+}
@@ -0,0 +1,74 @@
+/*!
+ *  @file DHTScheduler.h
+ *
+ *  Round-robin reading of several DHT sensors, one at a time, spread evenly
+ *  across the read interval.
+ *
+ *  MIT license, all text above must be included in any redistribution
+ */
+
+#ifndef DHT_SCHEDULER_H
+#define DHT_SCHEDULER_H
+
+#include "DHT.h"
+
+/*!
+ *  @brief  Last result of a sensor, in the shared snapshot table
+ */
+typedef struct DHTReading {
+  float temperature;  /**< Last valid temperature, in Celsius (NAN if none) */
+  float humidity;     /**< Last valid humidity, in percent (NAN if none) */
+  uint32_t timestamp; /**< millis() when the last valid read started (0 if
+                           none) */
+  DHTStatus status;   /**< Result of the last read (DHT_NOT_STARTED if its
+                           slot found the sensor busy) */
+  uint32_t failures;  /**< Reads that failed */
+} DHTReading;
+
+/*!
+ *  @brief  Owns several DHT sensors and reads them in turn with the
+ *          asynchronous API. Only one read is in flight at a time, and loop()
+ *          never waits for a sensor.
+ */
+class DHTScheduler {
+public:
+  DHTScheduler(uint8_t capacity = 8);
+  ~DHTScheduler();
+
+  int8_t add(uint8_t pin, uint8_t type);
+  void begin(uint32_t interval = MIN_INTERVAL);
+  void loop();
+
+  /*!
+   *  @brief  Number of sensors added
+   *  @return count
+   */
+  uint8_t count() const { return _count; }
+
+  /*!
+   *  @brief  Sensor added in position i
+   *  @param  i
+   *          index returned by add()
+   *  @return sensor
+   */
+  DHT &sensor(uint8_t i) { return *_sensors[i]; }
+
+  /*!
+   *  @brief  Last result of sensor i
+   *  @param  i
+   *          index returned by add()
+   *  @return reading
+   */
+  const DHTReading &reading(uint8_t i) const { return _readings[i]; }
+
+private:
+  DHT **_sensors;
+  DHTReading *_readings;
+  uint8_t _capacity, _count;
+  uint8_t _next;      // Next sensor to start
+  int8_t _inFlight;   // Sensor being read, or -1
+  uint32_t _slot;     // Time between two starts, in ms
+  uint32_t _nextStart;
+};
+
+#endif
@@ -0,0 +1,51 @@
+// Example reading several DHT sensors without blocking loop()
+// Written for the DHT sensor library, public domain
+
+// REQUIRES the following Arduino libraries:
+// - DHT Sensor Library: https://github.com/adafruit/DHT-sensor-library
+// - Adafruit Unified Sensor Lib: https://github.com/adafruit/Adafruit_Sensor
+
+#include "DHTScheduler.h"
+
+// One sensor per pin. Each one is read every 2 seconds, and the reads are
+// spread evenly across those 2 seconds, one at a time.
+const uint8_t pins[] = {13, 14, 16, 17, 18, 19, 23, 25};
+const uint8_t sensorCount = sizeof(pins);
+
+DHTScheduler scheduler(sensorCount);
+
+uint32_t lastPrint = 0;
+
+void setup() {
+  Serial.begin(9600);
+  Serial.println(F("DHT scheduler test!"));
+
+  for (uint8_t i = 0; i < sensorCount; i++) {
+    scheduler.add(pins[i], DHT22);
+  }
+  scheduler.begin(2000);
+}
+
+void loop() {
+  // Never waits for a sensor: the edges are captured by interrupts
+  scheduler.loop();
+
+  if (millis() - lastPrint < 5000) {
+    return;
+  }
+  lastPrint = millis();
+
+  for (uint8_t i = 0; i < scheduler.count(); i++) {
+    const DHTReading &r = scheduler.reading(i);
+    Serial.print(F("Sensor "));
+    Serial.print(i);
+    Serial.print(F(": "));
+    Serial.print(r.temperature);
+    Serial.print(F("°C "));
+    Serial.print(r.humidity);
+    Serial.print(F("%  age: "));
+    Serial.print(millis() - r.timestamp);
+    Serial.print(F(" ms  failures: "));
+    Serial.println(r.failures);
+  }
+}
@@ -0,0 +1,151 @@
+#include "DHTEdges.h"
+#include "SyntheticLine.h"
+#include "BDDTest.h"
+#include "trace.h"
+#include <string.h>
+
+#define START_DHT22 1100
+#define START_DHT11 20000
+
+// 65.2 %, -10.1 °C en formato DHT22
+static const uint8_t FRAME[5] = { 0x02, 0x8C, 0x80, 0x65, 0x73 };
+
+// Llama a poll() cada 10 us mientras la lectura siga en curso
+static DHTStatus run(DHTAsyncReader& reader, SyntheticLine& line, uint32_t limit = 100000) {
+    DHTStatus status = reader.poll();
+
+    for (uint32_t t = 0; status == DHT_BUSY && t < limit; t += 10) {
+        line.advance(10);
+        status = reader.poll();
+    }
+    return status;
+}
+
+
+int test_async_frame() {
+    IT("decodes a complete frame without blocking");
+    SyntheticLine line;
+    DHTAsyncReader reader;
+    line.setFrame(FRAME);
+    reader.setSource(&line);
+
+    IS_EQUAL(reader.poll(), DHT_IDLE);
+    IS_TRUE(reader.start(START_DHT22));
+    IS_TRUE(line.low);
+
+    // La señal de inicio dura lo pedido; recién entonces se libera la línea
+    line.advance(START_DHT22 - 10);
+    IS_EQUAL(reader.poll(), DHT_BUSY);
+    IS_TRUE(line.low);
+    line.advance(10);
+    IS_EQUAL(reader.poll(), DHT_BUSY);
+    IS_FALSE(line.low);
+
+    IS_EQUAL(run(reader, line), DHT_OK);
+    IS_TRUE(memcmp(reader.data(), FRAME, 5) == 0);
+    IS_EQUAL(line.stops, 1);
+    IS_FALSE(reader.busy());
+
+    END_IT
+}
+
+int test_async_jitter() {
+    IT("tolerates jitter in the pulse lengths");
+    SyntheticLine line;
+    DHTAsyncReader reader;
+    reader.setSource(&line);
+    srand(1);
+
+    for (int i = 0; i < 50; i++) {
+        line.setFrame(FRAME, 8);
+        IS_TRUE(reader.start(START_DHT11));
+        IS_EQUAL(run(reader, line), DHT_OK);
+        IS_TRUE(memcmp(reader.data(), FRAME, 5) == 0);
+    }
+
+    END_IT
+}
+
+int test_async_checksum() {
+    IT("reports a frame with a wrong checksum");
+    SyntheticLine line;
+    DHTAsyncReader reader;
+    uint8_t frame[5];
+    memcpy(frame, FRAME, 5);
+    frame[4] ^= 0x01;
+    line.setFrame(frame);
+    reader.setSource(&line);
+
+    IS_TRUE(reader.start(START_DHT22));
+    IS_EQUAL(run(reader, line), DHT_CHECKSUM);
+
+    END_IT
+}
+
+int test_async_timeout() {
+    IT("times out when the sensor does not answer or the frame is cut");
+    SyntheticLine line;
+    DHTAsyncReader reader;
+    reader.setSource(&line);
+
+    IS_TRUE(reader.start(START_DHT22));
+    IS_EQUAL(run(reader, line), DHT_TIMEOUT);
+    IS_EQUAL(line.stops, 1);
+
+    line.setFrame(FRAME);
+    line.frame.resize(40);
+    IS_TRUE(reader.start(START_DHT22));
+    IS_EQUAL(run(reader, line), DHT_TIMEOUT);
+    IS_EQUAL(line.stops, 2);
+
+    END_IT
+}
+
+int test_async_last_edge() {
+    IT("decodes a frame without its final edge once the frame time is over");
+    SyntheticLine line;
+    DHTAsyncReader reader;
+    line.setFrame(FRAME);
+    line.frame.pop_back();
+    reader.setSource(&line);
+
+    IS_TRUE(reader.start(START_DHT22));
+    IS_EQUAL(run(reader, line), DHT_OK);
+    IS_TRUE(memcmp(reader.data(), FRAME, 5) == 0);
+
+    END_IT
+}
+
+int test_async_busy() {
+    IT("refuses a second start while busy and releases the line on cancel");
+    SyntheticLine line;
+    DHTAsyncReader reader;
+    line.setFrame(FRAME);
+
+    IS_FALSE(reader.start(START_DHT22));
+    reader.setSource(&line);
+
+    IS_TRUE(reader.start(START_DHT22));
+    IS_FALSE(reader.start(START_DHT22));
+    IS_EQUAL(line.starts, 1);
+
+    reader.cancel();
+    IS_EQUAL(reader.status(), DHT_IDLE);
+    IS_EQUAL(line.stops, 1);
+    IS_TRUE(reader.start(START_DHT22));
+
+    END_IT
+}
+
+int main()
+{
+    SUITE("Async");
+    test_async_frame();
+    test_async_jitter();
+    test_async_checksum();
+    test_async_timeout();
+    test_async_last_edge();
+    test_async_busy();
+
+    FINISH
+}
@@ -0,0 +1,113 @@
+#include "DHT.h"
+#include "ClockedLine.h"
+#include "BDDTest.h"
+#include "trace.h"
+
+// Lectura asíncrona completa: avanza el reloj 10 us por llamada a poll()
+static DHTStatus acquire(DHT& dht) {
+    if (!dht.startRead(true)) {
+        return DHT_IDLE;
+    }
+
+    DHTStatus status = DHT_BUSY;
+    for (int i = 0; i < 10000 && status == DHT_BUSY; i++) {
+        hostMicros += 10;
+        status = dht.poll();
+    }
+    return status;
+}
+
+static bool near(float a, float b) {
+    return fabs(a - b) < 0.001f;
+}
+
+
+int test_dht_read_all_dht22() {
+    IT("returns every value of one DHT22 acquisition");
+    hostMicros = 5000000;
+    const uint8_t frame[5] = { 0x02, 0x8C, 0x80, 0x65, 0x73 };
+    ClockedLine line;
+    DHT dht(4, DHT22);
+    DHTMeasurement m;
+
+    line.setFrame(frame);
+    dht.setEdgeSource(&line);
+    dht.begin();
+
+    IS_EQUAL(acquire(dht), DHT_OK);
+    IS_TRUE(dht.readAll(m));
+    IS_EQUAL(line.starts, 1);
+
+    IS_TRUE(near(m.temperature, -10.1f));
+    IS_TRUE(near(m.fahrenheit, 13.82f));
+    IS_TRUE(near(m.humidity, 65.2f));
+    IS_TRUE(near(m.heatIndex, dht.computeHeatIndex(-10.1f, 65.2f, false)));
+    IS_TRUE(fabs(m.dewPoint - -15.395f) < 0.01f);
+    IS_EQUAL(m.timestamp, 5000);
+
+    // Las demás lecturas dentro de MIN_INTERVAL usan la misma adquisición
+    IS_TRUE(near(dht.readTemperature(), m.temperature));
+    IS_TRUE(near(dht.readTemperature(true), m.fahrenheit));
+    IS_TRUE(near(dht.readHumidity(), m.humidity));
+    IS_EQUAL(line.starts, 1);
+
+    END_IT
+}
+
+int test_dht_read_all_dht11() {
+    IT("decodes DHT11 frames, including negative temperatures");
+    hostMicros = 5000000;
+    const uint8_t positive[5] = { 55, 0, 21, 5, 81 };
+    const uint8_t negative[5] = { 55, 0, 5, 0x83, 0xBF };
+    ClockedLine line;
+    DHT dht(4, DHT11);
+    DHTMeasurement m;
+
+    dht.setEdgeSource(&line);
+    dht.begin();
+
+    line.setFrame(positive);
+    IS_EQUAL(acquire(dht), DHT_OK);
+    IS_TRUE(dht.readAll(m));
+    IS_TRUE(near(m.temperature, 21.5f));
+    IS_TRUE(near(m.fahrenheit, 70.7f));
+    IS_TRUE(near(m.humidity, 55.0f));
+
+    // Igual que la conversión original: -1 - 5 + 0.3
+    line.setFrame(negative);
+    IS_EQUAL(acquire(dht), DHT_OK);
+    IS_TRUE(dht.readAll(m));
+    IS_TRUE(near(m.temperature, -5.7f));
+
+    END_IT
+}
+
+int test_dht_read_all_failure() {
+    IT("leaves the measurement unchanged when the read fails");
+    hostMicros = 5000000;
+    ClockedLine line;
+    DHT dht(4, DHT22);
+    DHTMeasurement m;
+    m.temperature = 99;
+
+    dht.setEdgeSource(&line);
+    dht.begin();
+
+    IS_EQUAL(acquire(dht), DHT_TIMEOUT);
+    IS_FALSE(dht.readAll(m));
+    IS_TRUE(m.temperature == 99);
+    IS_TRUE(isnan(dht.readTemperature()));
+    IS_TRUE(isnan(dht.computeHeatIndex()));
+
+    END_IT
+}
+
+int main()
+{
+    SUITE("DHT");
+    test_dht_read_all_dht22();
+    test_dht_read_all_dht11();
+    test_dht_read_all_failure();
+
+    FINISH
+}
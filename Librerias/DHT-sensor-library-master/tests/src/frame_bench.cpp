@@ -0,0 +1,33 @@
+#include "DHTFrame.h"
+#include "SyntheticLine.h"
+#include <chrono>
+#include <iostream>
+
+#define FRAMES     64
+#define ITERATIONS 2000000
+
+int main()
+{
+    static uint32_t pulses[FRAMES][DHT_FRAME_PULSES];
+    DHTFrame frame;
+    uint32_t ok = 0;
+
+    // Tramas distintas, con jitter, para que el resultado no sea siempre el mismo
+    for (int f = 0; f < FRAMES; f++) {
+        uint8_t bytes[5] = { (uint8_t)f, (uint8_t)(f * 3), (uint8_t)(f >> 2), (uint8_t)(0xA5 ^ f), 0 };
+        bytes[4] = bytes[0] + bytes[1] + bytes[2] + bytes[3];
+        SyntheticLine::makePulses(bytes, pulses[f], 10);
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (long i = 0; i < ITERATIONS; i++) {
+        ok += dhtDecodeFrame(pulses[i % FRAMES], DHT_FRAME_PULSES, &frame) == DHT_OK;
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    double ns = std::chrono::duration<double, std::nano>(end - start).count() / ITERATIONS;
+    std::cout << "dhtDecodeFrame: " << ns << " ns/frame (" << 1e9 / ns << " frames/s, "
+              << ok << "/" << ITERATIONS << " ok)\n";
+
+    return 0;
+}
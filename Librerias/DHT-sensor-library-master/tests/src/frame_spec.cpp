@@ -0,0 +1,135 @@
+#include "DHTFrame.h"
+#include "SyntheticLine.h"
+#include "BDDTest.h"
+#include "trace.h"
+#include <string.h>
+
+// 40.0 %, 23.0 °C en formato DHT22
+static const uint8_t BYTES[5] = { 0x01, 0x90, 0x00, 0xE6, 0x77 };
+
+// La misma trama en ciclos del bucle de DHT::read() (no en us): bajo ~250, 0 ~135, 1 ~350
+static const uint32_t CYCLES[DHT_FRAME_PULSES] = {
+    248, 150, 242, 132, 258, 121, 240, 146, 255, 123,
+    249, 138, 239, 149, 254, 341, 239, 337, 251, 133,
+    240, 127, 240, 352, 251, 121, 256, 123, 245, 140,
+    258, 138, 239, 138, 256, 132, 239, 127, 239, 137,
+    242, 129, 251, 124, 255, 123, 256, 129, 255, 361,
+    259, 340, 241, 353, 256, 140, 244, 131, 241, 352,
+    260, 337, 256, 121, 257, 126, 253, 356, 255, 348,
+    262, 345, 252, 138, 252, 346, 247, 342, 243, 357,
+};
+
+
+int test_frame_cycles() {
+    IT("decodes a frame measured in loop cycles");
+    DHTFrame frame;
+
+    IS_EQUAL(dhtDecodeFrame(CYCLES, DHT_FRAME_PULSES, &frame), DHT_OK);
+    IS_EQUAL(frame.status, DHT_OK);
+    IS_TRUE(memcmp(frame.data, BYTES, 5) == 0);
+
+    END_IT
+}
+
+int test_frame_patterns() {
+    IT("decodes synthetic frames of every byte value");
+    uint32_t pulses[DHT_FRAME_PULSES];
+    DHTFrame frame;
+
+    for (int v = 0; v < 256; v++) {
+        uint8_t bytes[5] = { (uint8_t)v, (uint8_t)~v, (uint8_t)(v * 7), (uint8_t)(v >> 1), 0 };
+        bytes[4] = bytes[0] + bytes[1] + bytes[2] + bytes[3];
+
+        SyntheticLine::makePulses(bytes, pulses);
+        IS_EQUAL(dhtDecodeFrame(pulses, DHT_FRAME_PULSES, &frame), DHT_OK);
+        IS_TRUE(memcmp(frame.data, bytes, 5) == 0);
+    }
+
+    END_IT
+}
+
+int test_frame_margin() {
+    IT("reports the margin of each bit and the weakest one");
+    uint32_t pulses[DHT_FRAME_PULSES];
+    DHTFrame frame;
+
+    SyntheticLine::makePulses(BYTES, pulses);
+    IS_EQUAL(dhtDecodeFrame(pulses, DHT_FRAME_PULSES, &frame), DHT_OK);
+
+    // Umbral 50 us: un 0 (27 us) queda a 23 us, un 1 (70 us) a 20 us
+    IS_EQUAL(frame.margin[0], DHT_BIT_LOW - DHT_BIT_ZERO);
+    IS_EQUAL(frame.margin[7], DHT_BIT_ONE - DHT_BIT_LOW);
+    IS_EQUAL(frame.minMargin, DHT_BIT_ONE - DHT_BIT_LOW);
+    IS_EQUAL(frame.weakestBit, 7);
+
+    // Un pulso alto cercano al umbral es el más débil
+    pulses[2 * 20 + 1] = 45;
+    IS_EQUAL(dhtDecodeFrame(pulses, DHT_FRAME_PULSES, &frame), DHT_OK);
+    IS_EQUAL(frame.minMargin, 5);
+    IS_EQUAL(frame.weakestBit, 20);
+
+    END_IT
+}
+
+int test_frame_jitter() {
+    IT("decodes frames with jitter in every pulse");
+    uint32_t pulses[DHT_FRAME_PULSES];
+    DHTFrame frame;
+    srand(3);
+
+    for (int i = 0; i < 1000; i++) {
+        SyntheticLine::makePulses(BYTES, pulses, 12);
+        IS_EQUAL(dhtDecodeFrame(pulses, DHT_FRAME_PULSES, &frame), DHT_OK);
+        IS_TRUE(memcmp(frame.data, BYTES, 5) == 0);
+    }
+
+    END_IT
+}
+
+int test_frame_noise() {
+    IT("is not misled by a disturbed low pulse");
+    uint32_t pulses[DHT_FRAME_PULSES];
+    DHTFrame frame;
+
+    // Una interrupción alarga el pulso bajo de un 1; comparado con su propio pulso bajo, sería 0
+    SyntheticLine::makePulses(BYTES, pulses);
+    pulses[2 * 7] = 120;
+    IS_EQUAL(dhtDecodeFrame(pulses, DHT_FRAME_PULSES, &frame), DHT_OK);
+    IS_TRUE(memcmp(frame.data, BYTES, 5) == 0);
+
+    // Un pulso alto alterado cambia el bit, y el checksum lo detecta
+    SyntheticLine::makePulses(BYTES, pulses);
+    pulses[2 * 7 + 1] = DHT_BIT_ZERO;
+    IS_EQUAL(dhtDecodeFrame(pulses, DHT_FRAME_PULSES, &frame), DHT_CHECKSUM);
+
+    END_IT
+}
+
+int test_frame_truncated() {
+    IT("reports truncated frames and pulses that timed out");
+    uint32_t pulses[DHT_FRAME_PULSES];
+    DHTFrame frame;
+
+    SyntheticLine::makePulses(BYTES, pulses);
+    IS_EQUAL(dhtDecodeFrame(pulses, 79, &frame), DHT_TIMEOUT);
+    IS_EQUAL(dhtDecodeFrame(pulses, 0, &frame), DHT_TIMEOUT);
+
+    pulses[50] = DHT_PULSE_TIMEOUT;
+    IS_EQUAL(dhtDecodeFrame(pulses, DHT_FRAME_PULSES, &frame), DHT_TIMEOUT);
+    IS_EQUAL(frame.status, DHT_TIMEOUT);
+
+    END_IT
+}
+
+int main()
+{
+    SUITE("Frame");
+    test_frame_cycles();
+    test_frame_patterns();
+    test_frame_margin();
+    test_frame_jitter();
+    test_frame_noise();
+    test_frame_truncated();
+
+    FINISH
+}
@@ -0,0 +1,85 @@
+#include "DHTKernels.h"
+#include <math.h>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#define SAMPLES    4096
+#define ITERATIONS 2000
+
+// Implementación original de DHT::computeHeatIndex(), en °F (doble precisión y pow())
+static float referenceHeatIndex(float temperature, float percentHumidity) {
+    float hi = 0.5 * (temperature + 61.0 + ((temperature - 68.0) * 1.2) + (percentHumidity * 0.094));
+
+    if (hi > 79) {
+        hi = -42.379 + 2.04901523 * temperature + 10.14333127 * percentHumidity +
+             -0.22475541 * temperature * percentHumidity +
+             -0.00683783 * pow(temperature, 2) +
+             -0.05481717 * pow(percentHumidity, 2) +
+             0.00122874 * pow(temperature, 2) * percentHumidity +
+             0.00085282 * temperature * pow(percentHumidity, 2) +
+             -0.00000199 * pow(temperature, 2) * pow(percentHumidity, 2);
+
+        if ((percentHumidity < 13) && (temperature >= 80.0) && (temperature <= 112.0))
+            hi -= ((13.0 - percentHumidity) * 0.25) * sqrt((17.0 - fabs(temperature - 95.0)) * 0.05882);
+        else if ((percentHumidity > 85.0) && (temperature >= 80.0) && (temperature <= 87.0))
+            hi += ((percentHumidity - 85.0) * 0.1) * ((87.0 - temperature) * 0.2);
+    }
+    return hi;
+}
+
+static void report(const char* name, std::chrono::steady_clock::time_point start, float check) {
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count() / ((double)SAMPLES * ITERATIONS);
+    std::cout << name << ": " << ns << " ns/sample (" << 1e9 / ns << " samples/s, check " << check << ")\n";
+}
+
+int main()
+{
+    std::vector<float> t(SAMPLES), rh(SAMPLES), out(SAMPLES);
+    float check;
+
+    // Muestras repartidas en 60-110 °F y 0.1-100 %, para recorrer todas las ramas
+    for (int i = 0; i < SAMPLES; i++) {
+        t[i] = 60 + (i * 37 % 500) * 0.1f;
+        rh[i] = 0.1f + (i * 53 % 999) * 0.1f;
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    check = 0;
+    for (int k = 0; k < ITERATIONS; k++) {
+        for (int i = 0; i < SAMPLES; i++) {
+            out[i] = referenceHeatIndex(t[i], rh[i]);
+        }
+        check += out[k % SAMPLES];
+    }
+    report("original (double, pow)", start, check);
+
+    start = std::chrono::steady_clock::now();
+    check = 0;
+    for (int k = 0; k < ITERATIONS; k++) {
+        for (int i = 0; i < SAMPLES; i++) {
+            out[i] = dhtHeatIndex(t[i], rh[i]);
+        }
+        check += out[k % SAMPLES];
+    }
+    report("dhtHeatIndex", start, check);
+
+    start = std::chrono::steady_clock::now();
+    check = 0;
+    for (int k = 0; k < ITERATIONS; k++) {
+        dhtHeatIndexBatch(t.data(), rh.data(), out.data(), SAMPLES);
+        check += out[k % SAMPLES];
+    }
+    report("dhtHeatIndexBatch", start, check);
+
+    start = std::chrono::steady_clock::now();
+    check = 0;
+    for (int k = 0; k < ITERATIONS; k++) {
+        dhtDewPointBatch(t.data(), rh.data(), out.data(), SAMPLES);
+        check += out[k % SAMPLES];
+    }
+    report("dhtDewPointBatch", start, check);
+
+    return 0;
+}
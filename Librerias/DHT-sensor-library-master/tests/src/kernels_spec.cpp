@@ -0,0 +1,172 @@
+#include "DHTKernels.h"
+#include "BDDTest.h"
+#include "trace.h"
+#include <math.h>
+#include <vector>
+
+// Copia de la implementación original de DHT::computeHeatIndex() (doble precisión y pow()),
+// usada como referencia
+static float referenceHeatIndex(float temperature, float percentHumidity, bool isFahrenheit) {
+    float hi;
+
+    if (!isFahrenheit)
+        temperature = temperature * 1.8 + 32;
+
+    hi = 0.5 * (temperature + 61.0 + ((temperature - 68.0) * 1.2) +
+                (percentHumidity * 0.094));
+
+    if (hi > 79) {
+        hi = -42.379 + 2.04901523 * temperature + 10.14333127 * percentHumidity +
+             -0.22475541 * temperature * percentHumidity +
+             -0.00683783 * pow(temperature, 2) +
+             -0.05481717 * pow(percentHumidity, 2) +
+             0.00122874 * pow(temperature, 2) * percentHumidity +
+             0.00085282 * temperature * pow(percentHumidity, 2) +
+             -0.00000199 * pow(temperature, 2) * pow(percentHumidity, 2);
+
+        if ((percentHumidity < 13) && (temperature >= 80.0) &&
+            (temperature <= 112.0))
+            hi -= ((13.0 - percentHumidity) * 0.25) *
+                  sqrt((17.0 - fabs(temperature - 95.0)) * 0.05882);
+
+        else if ((percentHumidity > 85.0) && (temperature >= 80.0) &&
+                 (temperature <= 87.0))
+            hi += ((percentHumidity - 85.0) * 0.1) * ((87.0 - temperature) * 0.2);
+    }
+
+    return isFahrenheit ? hi : (hi - 32) * 0.55555;
+}
+
+// Rejilla de muestras: T de -40 a 140 °F cada 0.25, HR de 0 a 100 % cada 0.5
+static void grid(std::vector<float>& t, std::vector<float>& rh, float tMin, float tMax, float tStep) {
+    for (float x = tMin; x <= tMax; x += tStep) {
+        for (float h = 0; h <= 100; h += 0.5f) {
+            t.push_back(x);
+            rh.push_back(h);
+        }
+    }
+}
+
+
+int test_kernels_heat_index() {
+    IT("matches the original heat index within 0.01 F");
+    std::vector<float> t, rh;
+    grid(t, rh, -40, 140, 0.25f);
+
+    double maxError = 0;
+    for (size_t i = 0; i < t.size(); i++) {
+        double error = fabs(dhtHeatIndex(t[i], rh[i]) - referenceHeatIndex(t[i], rh[i], true));
+        if (error > maxError) {
+            maxError = error;
+        }
+    }
+    IS_TRUE(maxError < 0.01);
+
+    END_IT
+}
+
+int test_kernels_celsius() {
+    IT("matches the original heat index in Celsius");
+    std::vector<float> t, rh;
+    grid(t, rh, -40, 60, 0.1f);
+
+    double maxError = 0;
+    for (size_t i = 0; i < t.size(); i++) {
+        double error = fabs(dhtHeatIndex(t[i], rh[i], false) - referenceHeatIndex(t[i], rh[i], false));
+        if (error > maxError) {
+            maxError = error;
+        }
+    }
+    IS_TRUE(maxError < 0.01);
+
+    END_IT
+}
+
+int test_kernels_adjustments() {
+    IT("applies the dry and humid adjustments at their limits");
+    // Seco: HR < 13 y 80 <= T <= 112; húmedo: HR > 85 y 80 <= T <= 87
+    const float T[]  = { 80, 95, 112, 112.25f, 80, 87, 87.25f, 79.75f };
+    const float RH[] = { 12.5f, 0, 12.9f, 5, 85.5f, 100, 90, 100 };
+
+    for (int i = 0; i < 8; i++) {
+        IS_TRUE(fabs(dhtHeatIndex(T[i], RH[i]) - referenceHeatIndex(T[i], RH[i], true)) < 0.01);
+    }
+
+    END_IT
+}
+
+int test_kernels_batch() {
+    IT("computes the same values in batch as one by one");
+    std::vector<float> t, rh;
+    grid(t, rh, -40, 140, 0.25f);
+    // Un largo que no es múltiplo de 4, para recorrer también la cola escalar
+    t.resize(t.size() - 3);
+    rh.resize(rh.size() - 3);
+
+    std::vector<float> out(t.size());
+    for (int f = 0; f < 2; f++) {
+        bool isFahrenheit = f == 0;
+        dhtHeatIndexBatch(t.data(), rh.data(), out.data(), t.size(), isFahrenheit);
+
+        bool same = true;
+        for (size_t i = 0; i < t.size(); i++) {
+            same = same && fabs(out[i] - dhtHeatIndex(t[i], rh[i], isFahrenheit)) < 1e-4;
+        }
+        IS_TRUE(same);
+    }
+
+    // Salida sobre la entrada, y valores no válidos
+    float temp[5] = { 90, NAN, 70, 100, 85 };
+    float hum[5] = { 50, 50, NAN, 10, 90 };
+    float expected[5];
+    for (int i = 0; i < 5; i++) {
+        expected[i] = dhtHeatIndex(temp[i], hum[i]);
+    }
+    dhtHeatIndexBatch(temp, hum, temp, 5);
+    IS_TRUE(fabs(temp[0] - expected[0]) < 1e-4);
+    IS_TRUE(isnan(temp[1]));
+    IS_TRUE(isnan(temp[2]));
+    IS_TRUE(fabs(temp[3] - expected[3]) < 1e-4);
+    IS_TRUE(fabs(temp[4] - expected[4]) < 1e-4);
+
+    END_IT
+}
+
+int test_kernels_dew_point() {
+    IT("computes the Magnus dew point");
+    std::vector<float> t, rh;
+    grid(t, rh, -40, 50, 0.5f);
+    std::vector<float> out(t.size());
+    dhtDewPointBatch(t.data(), rh.data(), out.data(), t.size());
+
+    double maxError = 0;
+    for (size_t i = 0; i < t.size(); i++) {
+        if (rh[i] == 0) {
+            continue;
+        }
+        double gamma = log(rh[i] / 100.0) + 17.625 * t[i] / (243.04 + t[i]);
+        double error = fabs(out[i] - 243.04 * gamma / (17.625 - gamma));
+        if (error > maxError) {
+            maxError = error;
+        }
+    }
+    IS_TRUE(maxError < 0.01);
+
+    // Saturado: el punto de rocío es la temperatura
+    IS_TRUE(fabs(dhtDewPoint(25, 100) - 25) < 0.001f);
+    IS_TRUE(fabs(dhtDewPoint(20, 50) - 9.26f) < 0.01f);
+
+    END_IT
+}
+
+int main()
+{
+    SUITE("Kernels");
+    test_kernels_heat_index();
+    test_kernels_celsius();
+    test_kernels_adjustments();
+    test_kernels_batch();
+    test_kernels_dew_point();
+
+    FINISH
+}
@@ -0,0 +1,28 @@
+#include "Arduino.h"
+
+uint32_t hostMicros = 0;
+
+uint32_t millis() {
+    return hostMicros / 1000;
+}
+
+uint32_t micros() {
+    return hostMicros;
+}
+
+// Las esperas bloqueantes sólo avanzan el reloj
+void delay(uint32_t ms) {
+    hostMicros += ms * 1000;
+}
+
+void delayMicroseconds(uint32_t us) {
+    hostMicros += us;
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {}
+void digitalWrite(uint8_t pin, uint8_t value) {}
+int digitalRead(uint8_t pin) { return HIGH; }
+void noInterrupts() {}
+void interrupts() {}
+void attachInterrupt(uint8_t pin, void (*handler)(), int mode) {}
+void detachInterrupt(uint8_t pin) {}
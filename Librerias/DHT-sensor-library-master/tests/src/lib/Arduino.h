@@ -0,0 +1,40 @@
+#ifndef Arduino_h
+#define Arduino_h
+
+// Reemplazo de Arduino.h para compilar DHT.cpp en Linux. Los pines no hacen nada (las pruebas
+// usan una línea sintética con DHT::setEdgeSource()), y el reloj lo controla la prueba
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+typedef uint16_t word;
+
+#define HIGH          1
+#define LOW           0
+#define INPUT         0
+#define OUTPUT        1
+#define INPUT_PULLUP  2
+#define CHANGE        3
+
+#define F(x) x
+#define microsecondsToClockCycles(a) ((a) * 240L)
+#define digitalPinToInterrupt(p) (p)
+
+// Reloj de las pruebas, en us: micros() lo devuelve, y millis() lo devuelve en ms
+extern uint32_t hostMicros;
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+void noInterrupts();
+void interrupts();
+void attachInterrupt(uint8_t pin, void (*handler)(), int mode);
+void detachInterrupt(uint8_t pin);
+
+#endif
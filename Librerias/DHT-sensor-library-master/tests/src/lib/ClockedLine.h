@@ -0,0 +1,27 @@
+#ifndef clocked_line_h
+#define clocked_line_h
+
+// Línea sintética con el reloj del reemplazo de Arduino.h, para las pruebas que compilan DHT.cpp
+
+#include "Arduino.h"
+#include "SyntheticLine.h"
+#include <vector>
+
+class ClockedLine : public SyntheticLine {
+public:
+    std::vector<uint32_t> startTimes;   // millis() de cada señal de inicio
+
+    virtual void startSignal() {
+        SyntheticLine::startSignal();
+        startTimes.push_back(millis());
+    }
+
+    virtual uint32_t micros() {
+        now = hostMicros;
+        return SyntheticLine::micros();
+    }
+
+    bool busy() const { return starts > stops; }
+};
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef synthetic_line_h
+#define synthetic_line_h
+
+// Línea de datos sintética para DHTAsyncReader: un reloj controlado por la prueba y una trama
+// generada, cuyos flancos se guardan en el buffer a medida que avanza el reloj (como lo haría la
+// interrupción del pin). makePulses() genera sólo los pulsos de los bits, para dhtDecodeFrame()
+
+#include "DHTEdges.h"
+#include <stdlib.h>
+#include <vector>
+
+#define DHT_RESPONSE_DELAY  30  // Espera del sensor tras liberar la línea, en us
+#define DHT_RESPONSE_PULSE  80  // Pulsos bajo y alto de la respuesta, en us
+#define DHT_BIT_LOW         50  // Pulso bajo de cada bit, en us
+#define DHT_BIT_ZERO        27  // Pulso alto de un 0, en us
+#define DHT_BIT_ONE         70  // Pulso alto de un 1, en us
+
+class SyntheticLine : public DHTEdgeSource {
+public:
+    uint32_t now;                   // Reloj, en us
+    bool low;                       // La línea está tomada por la señal de inicio
+    int starts;                     // Llamadas a startSignal()
+    int stops;                      // Llamadas a stop()
+    std::vector<uint32_t> frame;    // Flancos de la trama, relativos a la liberación de la línea
+
+    SyntheticLine() : now(1000), low(false), starts(0), stops(0), _edges(NULL), _released(0), _next(0) {}
+
+    // Trama completa (84 flancos) para 5 bytes. jitter agrega hasta +-jitter us a cada pulso
+    void setFrame(const uint8_t data[5], uint32_t jitter = 0) {
+        uint32_t pulses[DHT_FRAME_PULSES];
+        uint32_t t = DHT_RESPONSE_DELAY;
+
+        makePulses(data, pulses, jitter);
+
+        frame.clear();
+        frame.push_back(t);
+        t += pulse(DHT_RESPONSE_PULSE, jitter);
+        frame.push_back(t);
+        t += pulse(DHT_RESPONSE_PULSE, jitter);
+        frame.push_back(t);
+
+        for (int i = 0; i < DHT_FRAME_PULSES; i++) {
+            t += pulses[i];
+            frame.push_back(t);
+        }
+
+        t += pulse(DHT_BIT_LOW, jitter);
+        frame.push_back(t);
+    }
+
+    // Largos de los 80 pulsos (bajo y alto de cada bit) de una trama, en us
+    static void makePulses(const uint8_t data[5], uint32_t pulses[DHT_FRAME_PULSES], uint32_t jitter = 0) {
+        for (int i = 0; i < DHT_FRAME_BITS; i++) {
+            bool one = data[i / 8] & (0x80 >> (i % 8));
+            pulses[2 * i] = pulse(DHT_BIT_LOW, jitter);
+            pulses[2 * i + 1] = pulse(one ? DHT_BIT_ONE : DHT_BIT_ZERO, jitter);
+        }
+    }
+
+    // Avanza el reloj, entregando los flancos que ocurren hasta entonces
+    void advance(uint32_t micros) {
+        now += micros;
+        deliver();
+    }
+
+    virtual void startSignal() {
+        low = true;
+        starts++;
+    }
+
+    virtual void capture(DHTEdgeBuffer* edges) {
+        low = false;
+        _edges = edges;
+        _released = now;
+        _next = 0;
+    }
+
+    virtual void stop() {
+        _edges = NULL;
+        stops++;
+    }
+
+    virtual uint32_t micros() {
+        deliver();
+        return now;
+    }
+
+    static uint32_t pulse(uint32_t micros, uint32_t jitter) {
+        return jitter ? micros - jitter + rand() % (2 * jitter + 1) : micros;
+    }
+
+private:
+    void deliver() {
+        while (_edges != NULL && _next < frame.size() && _released + frame[_next] <= now) {
+            _edges->record(_released + frame[_next]);
+            _next++;
+        }
+    }
+
+    DHTEdgeBuffer* _edges;
+    uint32_t _released;
+    size_t _next;
+};
+
+#endif
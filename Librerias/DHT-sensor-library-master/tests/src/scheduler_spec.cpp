@@ -0,0 +1,158 @@
+#include "DHTScheduler.h"
+#include "ClockedLine.h"
+#include "BDDTest.h"
+#include "trace.h"
+
+// 65.2 %, -10.1 °C en formato DHT22
+static const uint8_t FRAME[5] = { 0x02, 0x8C, 0x80, 0x65, 0x73 };
+
+// Llama a scheduler.loop() cada 100 us durante ms milisegundos. Devuelve el máximo de lecturas
+// simultáneas observado
+static int run(DHTScheduler& scheduler, ClockedLine* lines, uint32_t ms) {
+    int maxInFlight = 0;
+
+    for (uint32_t t = 0; t < ms * 10; t++) {
+        hostMicros += 100;
+        scheduler.loop();
+
+        int inFlight = 0;
+        for (uint8_t i = 0; i < scheduler.count(); i++) {
+            inFlight += lines[i].busy();
+        }
+        if (inFlight > maxInFlight) {
+            maxInFlight = inFlight;
+        }
+    }
+    return maxInFlight;
+}
+
+
+int test_scheduler_stagger() {
+    IT("reads one sensor at a time, spread evenly across the interval");
+    hostMicros = 0;
+    DHTScheduler scheduler(3);
+    ClockedLine lines[3];
+
+    for (int i = 0; i < 3; i++) {
+        IS_EQUAL(scheduler.add(10 + i, DHT22), i);
+        lines[i].setFrame(FRAME);
+        scheduler.sensor(i).setEdgeSource(&lines[i]);
+    }
+    scheduler.begin(3000);
+
+    IS_EQUAL(run(scheduler, lines, 8500), 1);
+
+    // Cada sensor, cada 3 s; uno cada 1 s, en orden
+    for (int i = 0; i < 3; i++) {
+        IS_EQUAL(lines[i].startTimes.size(), 3);
+        for (size_t k = 0; k < lines[i].startTimes.size(); k++) {
+            IS_TRUE(lines[i].startTimes[k] == i * 1000 + k * 3000);
+        }
+    }
+
+    const DHTReading& r = scheduler.reading(1);
+    IS_EQUAL(r.status, DHT_OK);
+    IS_TRUE(fabs(r.temperature - -10.1f) < 0.01f);
+    IS_TRUE(fabs(r.humidity - 65.2f) < 0.01f);
+    IS_TRUE(r.timestamp >= 7000 && r.timestamp < 7100);
+    IS_EQUAL(r.failures, 0);
+
+    END_IT
+}
+
+int test_scheduler_failure() {
+    IT("keeps the last valid values and counts failed reads");
+    hostMicros = 0;
+    DHTScheduler scheduler(2);
+    ClockedLine lines[2];
+
+    for (int i = 0; i < 2; i++) {
+        scheduler.add(10 + i, DHT11);
+        lines[i].setFrame(FRAME);
+        scheduler.sensor(i).setEdgeSource(&lines[i]);
+    }
+    scheduler.begin();
+
+    run(scheduler, lines, 2500);
+    IS_EQUAL(scheduler.reading(0).status, DHT_OK);
+    uint32_t timestamp = scheduler.reading(0).timestamp;
+
+    // El sensor 0 deja de responder
+    lines[0].frame.clear();
+    run(scheduler, lines, 2000);
+
+    const DHTReading& r = scheduler.reading(0);
+    IS_EQUAL(r.status, DHT_TIMEOUT);
+    IS_EQUAL(r.failures, 1);
+    IS_EQUAL(r.timestamp, timestamp);
+    IS_FALSE(isnan(r.humidity));
+    IS_EQUAL(scheduler.reading(1).status, DHT_OK);
+
+    END_IT
+}
+
+int test_scheduler_no_start() {
+    IT("counts a read that cannot start as a failure");
+    hostMicros = 0;
+    DHTScheduler scheduler(2);
+    ClockedLine lines[2];
+
+    for (int i = 0; i < 2; i++) {
+        scheduler.add(10 + i, DHT22);
+        lines[i].setFrame(FRAME);
+        scheduler.sensor(i).setEdgeSource(&lines[i]);
+    }
+
+    // Una lectura iniciada fuera del planificador deja ocupado al sensor 0
+    lines[0].frame.clear();
+    IS_TRUE(scheduler.sensor(0).startRead(true));
+    scheduler.begin();
+    run(scheduler, lines, 4500);
+
+    const DHTReading& r = scheduler.reading(0);
+    IS_EQUAL(r.status, DHT_NOT_STARTED);
+    IS_EQUAL(r.failures, 3);
+    IS_TRUE(isnan(r.temperature));
+    IS_EQUAL(scheduler.reading(1).status, DHT_OK);
+    IS_EQUAL(scheduler.reading(1).failures, 0);
+
+    END_IT
+}
+
+int test_scheduler_limits() {
+    IT("respects its capacity and the minimum interval");
+    hostMicros = 0;
+    DHTScheduler scheduler(2);
+    ClockedLine lines[2];
+
+    IS_EQUAL(scheduler.add(10, DHT22), 0);
+    IS_EQUAL(scheduler.add(11, DHT22), 1);
+    IS_EQUAL(scheduler.add(12, DHT22), -1);
+    IS_EQUAL(scheduler.count(), 2);
+    IS_TRUE(isnan(scheduler.reading(0).temperature));
+
+    for (int i = 0; i < 2; i++) {
+        lines[i].setFrame(FRAME);
+        scheduler.sensor(i).setEdgeSource(&lines[i]);
+    }
+
+    // Un intervalo menor que MIN_INTERVAL se sube a MIN_INTERVAL
+    scheduler.begin(100);
+    run(scheduler, lines, 3900);
+    IS_EQUAL(lines[0].startTimes.size(), 2);
+    IS_EQUAL(lines[1].startTimes.size(), 2);
+    IS_EQUAL(lines[0].startTimes[1] - lines[0].startTimes[0], MIN_INTERVAL);
+
+    END_IT
+}
+
+int main()
+{
+    SUITE("Scheduler");
+    test_scheduler_stagger();
+    test_scheduler_failure();
+    test_scheduler_no_start();
+    test_scheduler_limits();
+
+    FINISH
+}
@@ -0,0 +1,60 @@
+/**
+ * @file UbidotsBatchClient.h
+ */
+
+#ifndef UbidotsBatchClient_H
+#define UbidotsBatchClient_H
+
+#include <Arduino.h>
+#include <Client.h>
+
+#define BATCH_BUFFER_SIZE     512   //!< Bytes que se acumulan antes de escribir en el socket
+
+/**
+ * @brief Cliente intermedio que agrupa escrituras consecutivas.
+ *
+ * Fuera de un lote, todo pasa directo al cliente real. Entre beginBatch() y endBatch(), las
+ * escrituras (encabezados, tópicos y JSON de varios paquetes MQTT seguidos) se acumulan en un
+ * buffer y se escriben en bloques de BATCH_BUFFER_SIZE, en vez de una escritura por fragmento.
+ */
+class BatchClient : public Client {
+  public:
+    BatchClient(Client& client);
+
+    /**
+     * @brief Comenzar a acumular las escrituras.
+     */
+    void beginBatch();
+
+    /**
+     * @brief Escribir lo acumulado y volver a escribir directo.
+     *
+     * @return true Todo lo acumulado fue escrito
+     * @return false Alguna escritura del lote falló
+     */
+    bool endBatch();
+
+    virtual int connect(IPAddress ip, uint16_t port);
+    virtual int connect(const char* host, uint16_t port);
+    virtual size_t write(uint8_t data);
+    virtual size_t write(const uint8_t* buffer, size_t size);
+    virtual int available();
+    virtual int read();
+    virtual int read(uint8_t* buffer, size_t size);
+    virtual int peek();
+    virtual void flush();
+    virtual void stop();
+    virtual uint8_t connected();
+    virtual operator bool();
+
+  private:
+    bool send();
+
+    Client& _client;
+    uint8_t _buffer[BATCH_BUFFER_SIZE];
+    uint16_t _used;
+    bool _batching;
+    bool _failed;
+};
+
+#endif
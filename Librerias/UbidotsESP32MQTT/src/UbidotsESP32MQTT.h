@@ -6,23 +6,50 @@
 #define UbidotsESP32MQTT_H
 
 #include "PubSubClient.h"
+#include "UbidotsPayload.h"
+#include "UbidotsPolicy.h"
+#include "UbidotsHandlers.h"
+#include "UbidotsParse.h"
+#include "UbidotsBatchClient.h"
+#include "UbidotsRateLimit.h"
+#include "UbidotsJournal.h"
+#include "UbidotsSampler.h"
+#include "UbidotsStore.h"
 #include <WiFi.h>
 
 #define SERVER                "industrial.api.ubidots.com"  //!< Servidor de Ubidots
 #define FIRST_PART_TOPIC      "/v1.6/devices/"              //!< Texto por defecto del tópico
 #define MQTT_PORT             1883                          //!< Puerto de MQTT
-#define MAX_VALUES            5                             //!< Máximas variables en un Publish. Máximo 5!
+#define MAX_VALUES            5                             //!< Capacidad por defecto del buffer de valores
+#define MAX_PACKET_SIZE       1024                          //!< Tamaño máximo por defecto de cada paquete Publish
 #define DEFAULT_DEVICE_LABEL  "esp32"                       //!< Nombre opcional por defecto del dispositivo
+#define MAX_TOPIC_LENGTH      150                           //!< Largo máximo del tópico
+#define CONTEXT_ENTRIES_PER_VALUE  AGGREGATE_CONTEXT_ENTRIES  //!< Entradas de contexto por defecto por cada valor (un resumen)
+#define TCP_CONNECT_TIMEOUT   2000                          //!< Tiempo máximo de la conexión TCP, en ms
+#define MQTT_CONNECT_TIMEOUT  2                             //!< Tiempo máximo de respuesta del servidor, en s
+#define RECONNECT_INTERVAL    3000                          //!< Espera tras el primer intento fallido, en ms
+#define MAX_RECONNECT_INTERVAL  60000                       //!< Espera máxima entre intentos, en ms
+#define JOURNAL_REPLAY_VALUES 16                            //!< Valores del journal enviados por llamada a loop()
 
-typedef struct Value {
-  const char* _variableLabel;
-  float _value;               
-  char* _context;             
-  uint32_t _timestamp;           
-} Value;
+/**
+ * @brief Estado de la conexión con Ubidots, supervisada por Ubidots::loop().
+ */
+typedef enum UbidotsState {
+  UBIDOTS_WIFI_DOWN,        //!< Sin WiFi; se espera a que se conecte
+  UBIDOTS_TCP_CONNECTING,   //!< Abriendo la conexión TCP con el servidor
+  UBIDOTS_MQTT_CONNECTING,  //!< Conexión TCP abierta, autenticando por MQTT
+  UBIDOTS_SUBSCRIBING,      //!< Conectado, renovando las suscripciones registradas
+  UBIDOTS_CONNECTED         //!< Conectado y suscrito
+} UbidotsState;
 
 /**
  * @brief Clase principal
+ *
+ * loop() no bloquea salvo al conectarse: WiFiClient no ofrece una conexión TCP sin bloqueo y
+ * PubSubClient espera el CONNACK, así que el paso que abre la conexión TCP y el que envía el
+ * CONNECT esperan hasta sus tiempos máximos (por defecto TCP_CONNECT_TIMEOUT y
+ * MQTT_CONNECT_TIMEOUT, ver setConnectTimeout()). Un sketch que no tolere esas pausas durante una
+ * caída del servidor debe acortarlos.
  */
 class Ubidots {
   public:
@@ -44,10 +71,37 @@ class Ubidots {
      */
     Ubidots(const char* token, char* clientName);
 
+    /**
+     * @brief Construir un nuevo objeto Ubidots con una capacidad de valores específica.
+     * 
+     * @param token Default token de Ubidots
+     * @param clientName Nombre del cliente (debe ser único), o NULL para utilizar la MAC
+     * @param maxValues Cantidad máxima de valores pendientes: agregados y aún no enviados. Cada
+     * uno ocupa 8 bytes; el timestamp, el contexto y la espera por el límite de envío usan tablas
+     * aparte, que se reservan recién al usarse
+     */
+    Ubidots(const char* token, char* clientName, uint16_t maxValues);
+
+    /**
+     * @brief Construir un nuevo objeto Ubidots con capacidades de valores y de contexto específicas.
+     * 
+     * @param token Default token de Ubidots
+     * @param clientName Nombre del cliente (debe ser único), o NULL para utilizar la MAC
+     * @param maxValues Cantidad máxima de valores pendientes (ver el constructor anterior)
+     * @param maxContextEntries Cantidad máxima de entradas de contexto (addContext()), entre todos
+     * los valores pendientes. Los otros constructores reservan CONTEXT_ENTRIES_PER_VALUE por valor
+     */
+    Ubidots(const char* token, char* clientName, uint16_t maxValues, uint16_t maxContextEntries);
+
+    ~Ubidots();
+
     /**
      * @brief Establecer comunicación MQTT y asociar una función callback para recibir mensajes.
      * 
-     * @param callback Función para mensajes entrantes (debe tener el mismo formato)
+     * Los mensajes de variables registradas con on() se entregan a su handler; el callback recibe
+     * el resto.
+     * 
+     * @param callback Función para mensajes entrantes (debe tener el mismo formato), o NULL
      */
     void begin(void (*callback)(char*,uint8_t*,unsigned int));
 
@@ -68,19 +122,40 @@ class Ubidots {
     bool connected();
 
     /**
-     * @brief Reconectar cliente MQTT.
+     * @brief Reconectar cliente MQTT de inmediato. Bloquea hasta que la conexión tenga éxito o
+     * falle; no es necesario llamarlo, loop() reconecta por sí solo.
+     * 
+     * @deprecated loop() supervisa la conexión y la reconecta sin bloquear más de un paso por
+     * llamada. Se mantiene sólo por compatibilidad.
      */
-    void reconnect();
+    void reconnect() __attribute__ ((deprecated ("loop() reconecta por si solo")));
 
     /**
      * @brief Esto debe ser llamado regularmente para permitir al cliente procesar mensajes
      * entrantes y mantener su conexión al servidor.
      * 
+     * También supervisa la conexión: espera el WiFi, abre la conexión TCP, se autentica por MQTT
+     * y renueva las suscripciones registradas, un paso por llamada. Los intentos fallidos se
+     * repiten con espera creciente, desde RECONNECT_INTERVAL hasta MAX_RECONNECT_INTERVAL.
+     * 
+     * La conexión TCP y el CONNECT de MQTT son bloqueantes en WiFiClient y PubSubClient, así que
+     * las llamadas que dan esos pasos sí esperan: la que abre la conexión TCP, la resolución DNS
+     * del servidor más hasta TCP_CONNECT_TIMEOUT (2 s), y la que espera el CONNACK, hasta
+     * MQTT_CONNECT_TIMEOUT (2 s); ambos se pueden acortar con setConnectTimeout(). Se da un solo
+     * paso por llamada, y sólo cuando corresponde un intento, así que durante una caída loop()
+     * bloquea a lo más el mayor de esos tiempos (más el DNS) por llamada, una o dos veces por
+     * intento. El resto de las llamadas no bloquea.
+     * 
      * @return true Cliente aún se encuentra conectado
      * @return false Cliente ya no está conectado
      */
     bool loop();
 
+    /**
+     * @brief Estado actual de la conexión (ver loop()).
+     */
+    UbidotsState state() const;
+
     /**
      * @brief Establecer el parámetro Debug para ver información por Serial.
      * 
@@ -88,6 +163,35 @@ class Ubidots {
      */
     void setDebug(bool debug);
 
+    /**
+     * @brief Establecer el tamaño máximo de cada paquete Publish. Si los valores agregados no
+     * caben en un paquete, ubidotsPublish() los reparte en varios.
+     * 
+     * @param size Tamaño máximo del paquete en bytes (encabezado, tópico y JSON)
+     */
+    void setMaxPacketSize(uint16_t size);
+
+    /**
+     * @brief Establecer los tiempos máximos de los pasos bloqueantes de la conexión (ver loop()).
+     * 
+     * @param tcpTimeout Tiempo máximo de la conexión TCP, en ms (por defecto TCP_CONNECT_TIMEOUT)
+     * @param mqttTimeout Tiempo máximo de respuesta del servidor, en s (por defecto
+     * MQTT_CONNECT_TIMEOUT; PubSubClient no admite menos de 1 s)
+     */
+    void setConnectTimeout(uint16_t tcpTimeout, uint16_t mqttTimeout);
+
+    /**
+     * @brief Elegir el dispositivo de los próximos add() (modo gateway).
+     * 
+     * Permite juntar valores de varios dispositivos de Ubidots en un mismo cliente. Un solo
+     * ubidotsPublish() los envía todos por la misma conexión: un tramo de paquetes por
+     * dispositivo, uno tras otro.
+     * 
+     * @param deviceLabel Nombre del dispositivo (debe existir hasta publicar), o NULL para volver
+     * al dispositivo que recibe ubidotsPublish()
+     */
+    void setDevice(const char* deviceLabel);
+
     /**
      * @brief Agregar valor a una variable especificada.
      * 
@@ -116,38 +220,299 @@ class Ubidots {
     void add(const char* variableLabel, float value, char* context, uint32_t timestamp);
 
     /**
-     * @brief Suscribirse a una variable de un dispositivo de Ubidots.
+     * @brief Registrar una variable para agregar sus valores por id (ver add(uint8_t, float)).
+     * 
+     * Se llama una vez por variable, por ejemplo en setup(). El inicio de su entrada en el JSON
+     * se calcula en ese momento. add() con el nombre registra la variable por sí solo; con el id
+     * se evita buscarla en cada llamada.
+     * 
+     * @param variableLabel Nombre de la variable (se copia)
+     * @return uint8_t Id de la variable (el mismo si ya estaba registrada), o LABEL_NONE si no se
+     * pudo registrar
+     */
+    uint8_t addLabel(const char* variableLabel);
+
+    /**
+     * @brief Agregar valor a una variable registrada con addLabel().
+     * 
+     * Igual que add() con el nombre, sin buscar la variable en la tabla: el valor queda en el
+     * mismo buffer y en el mismo orden que los demás, y al publicar se copia el fragmento JSON
+     * precalculado de la variable. Para agregar timestamp, usar add() con el nombre.
+     * 
+     * @param labelId Id devuelto por addLabel()
+     * @param value Valor numérico
+     */
+    void add(uint8_t labelId, float value);
+
+    /**
+     * @brief Agregar el resumen de la ventana de un Sampler (ver Sampler::aggregate()).
+     * 
+     * Se agrega la media como valor de la variable, con el resto del resumen como contexto:
+     * {"min": ..., "max": ..., "sd": ..., "n": ...} (sd es la desviación estándar). Ocupa
+     * AGGREGATE_CONTEXT_ENTRIES entradas del buffer de contexto; si no caben, el resumen no se
+     * agrega (nunca se envía con el contexto incompleto).
+     * 
+     * @param aggregate Resumen de la ventana
+     * @return true Resumen agregado
+     * @return false Resumen sin muestras, descartado por su política, o sin espacio en el buffer
+     * de valores o de contexto
+     */
+    bool add(const SampleAggregate& aggregate);
+
+    /**
+     * @brief Agregar una entrada numérica al contexto del último valor agregado, con 2 decimales.
+     * 
+     * Las entradas de todos los valores pendientes comparten un buffer de maxContextEntries
+     * entradas (por defecto CONTEXT_ENTRIES_PER_VALUE por cada valor de maxValues), que se reserva
+     * al agregar la primera. Las entradas de un valor se liberan cuando este se envía.
+     * 
+     * @param key Clave del contexto
+     * @param value Valor numérico
+     * @return true Entrada agregada
+     * @return false No hay un valor al cual agregarla, o el buffer de contexto está lleno
+     */
+    bool addContext(const char* key, float value);
+
+    /**
+     * @brief Agregar una entrada numérica al contexto del último valor agregado.
+     * 
+     * El número se guarda en binario y se escribe recién al publicar, sin buffers intermedios.
+     * Por ejemplo, add("gps", 0) seguido de addContext("lat", -33.023034, 6) y
+     * addContext("lng", -71.5464, 6) envía el contexto {"lat": -33.023033, "lng": -71.546402}
+     * (el float más cercano a cada coordenada, redondeado a 6 decimales).
+     * 
+     * @param key Clave del contexto
+     * @param value Valor numérico
+     * @param decimals Cantidad de decimales a enviar (hasta FORMAT_MAX_DECIMALS; más se envían como
+     * FORMAT_MAX_DECIMALS)
+     * @return true Entrada agregada
+     * @return false No hay un valor al cual agregarla, o el buffer de contexto está lleno
+     */
+    bool addContext(const char* key, float value, uint8_t decimals);
+
+    /**
+     * @brief Agregar una entrada de texto al contexto del último valor agregado.
+     * 
+     * El texto no se copia (debe existir hasta publicar) y se escapa al enviarlo.
+     * 
+     * @param key Clave del contexto
+     * @param text Texto
+     * @return true Entrada agregada
+     * @return false No hay un valor al cual agregarla, o el buffer de contexto está lleno
+     */
+    bool addContext(const char* key, const char* text);
+
+    /**
+     * @brief Registrar una serie de muestras. En cada ubidotsPublish() se envían todas sus
+     * muestras como un único arreglo de la variable, y luego se vacía la serie.
+     * 
+     * Las series se publican al dispositivo de ese ubidotsPublish(). Si esperan por el límite de
+     * envío, siguen asociadas a él hasta enviarse, aunque entretanto se publique a otro
+     * dispositivo.
+     * 
+     * @param series Serie a registrar (debe existir mientras el cliente la utilice)
+     */
+    void addSeries(SampleSeries* series);
+
+    /**
+     * @brief Registrar una política de publicación para una variable. Desde entonces, cada add()
+     * de esa variable se evalúa con la política, y sólo se agrega al buffer si la pasa.
+     * 
+     * @param policy Política a registrar (debe existir mientras el cliente la utilice)
+     */
+    void addPolicy(PublishPolicy* policy);
+
+    /**
+     * @brief Limitar la tasa de paquetes Publish del cliente (para todo el token).
+     * 
+     * Los paquetes que exceden el límite no se descartan: sus valores quedan en el buffer, al
+     * inicio, y loop() los envía a medida que se recuperan tokens. Mientras esperan, ocupan
+     * espacio del buffer, y los textos de su contexto deben seguir existiendo.
+     * 
+     * @param perSecond Paquetes por segundo (0 para no limitar)
+     * @param burst Paquetes que se pueden enviar seguidos, por ejemplo tras una reconexión
+     */
+    void setRateLimit(float perSecond, uint16_t burst);
+
+    /**
+     * @brief Registrar un límite adicional para un dispositivo (ver setRateLimit()).
+     * 
+     * @param limit Límite a registrar (debe existir mientras el cliente lo utilice)
+     */
+    void addRateLimit(RateLimit* limit);
+
+    /**
+     * @brief Registrar un journal en flash para los valores de un dispositivo.
+     * 
+     * Desde entonces, si ubidotsPublish() se llama sin conexión, los valores de ese dispositivo
+     * cuyas variables estén en la tabla del journal se guardan en él, con su timestamp (o la hora
+     * actual, si el reloj ya fue sincronizado, por ejemplo con configTime()). Al volver la
+     * conexión, loop() los publica con su timestamp original, hasta JOURNAL_REPLAY_VALUES por
+     * llamada y respetando el límite de envío. El contexto de esos valores no se guarda.
+     * 
+     * @param journal Journal a utilizar (debe existir mientras el cliente lo utilice), o NULL
+     * @param deviceLabel Nombre del dispositivo de los valores guardados
+     */
+    void setJournal(UbidotsJournal* journal, const char* deviceLabel);
+
+    /**
+     * @brief Cantidad de valores que esperan por el límite de envío, o por la reconexión.
+     */
+    uint16_t queued() const;
+
+    /**
+     * @brief Cantidad de valores descartados por agregarlos con el buffer lleno.
+     * 
+     * Los valores que no se alcanzan a enviar (límite de envío o conexión caída) siguen ocupando
+     * el buffer hasta que loop() los envía; si mientras tanto se llena, los nuevos add() se
+     * descartan y se cuentan aquí. También cuenta los resúmenes (add(const SampleAggregate&)) que
+     * no caben en el buffer de contexto.
+     */
+    uint32_t dropped() const;
+
+    /**
+     * @brief Cantidad total de valores que tuvieron que esperar por el límite de envío.
+     */
+    uint32_t deferrals() const;
+
+    /**
+     * @brief Suma de las esperas de los valores diferidos ya enviados, en milisegundos.
+     */
+    uint32_t deferralDelay() const;
+
+    /**
+     * @brief Mayor espera de un valor diferido ya enviado, en milisegundos.
+     */
+    uint32_t maxDeferralDelay() const;
+
+    /**
+     * @brief Suscribirse a una variable de un dispositivo de Ubidots. Los mensajes se entregan al
+     * callback de begin().
+     * 
+     * La suscripción queda registrada: basta con llamarla una vez, por ejemplo en setup(), y
+     * loop() la renueva en cada reconexión. No bloquea; si no hay conexión, sólo se registra.
      * 
      * @param deviceLabel Nombre del dispositivo
      * @param variableLabel Nombre de la variable
-     * @return true Suscripción tuvo éxito 
-     * @return false Suscripción falló
+     * @return true Suscripción registrada (y enviada, si hay conexión)
+     * @return false Registro o envío de la suscripción falló
      */
     bool ubidotsSubscribe(const char* deviceLabel, const char* variableLabel);
 
     /**
-     * @brief Publicar variable/s a Ubidots. La cantidad máxima está definida por MAX_VALUES.
+     * @brief Suscribirse a una variable y asociarle un handler que recibe el valor como decimal.
+     * 
+     * El tópico se calcula una sola vez al registrar, y la suscripción se renueva en cada
+     * reconexión.
+     * 
+     * @param deviceLabel Nombre del dispositivo
+     * @param variableLabel Nombre de la variable
+     * @param handler Función a llamar con cada valor recibido
+     * @return true Registro (y suscripción, si hay conexión) tuvo éxito
+     * @return false Registro o suscripción falló
+     */
+    bool on(const char* deviceLabel, const char* variableLabel, FloatHandler handler);
+
+    /**
+     * @brief Suscribirse a una variable y asociarle un handler que recibe el valor como entero.
      * 
      * @param deviceLabel Nombre del dispositivo
-     * @return true Publicación tuvo éxito
+     * @param variableLabel Nombre de la variable
+     * @param handler Función a llamar con cada valor recibido
+     * @return true Registro (y suscripción, si hay conexión) tuvo éxito
+     * @return false Registro o suscripción falló
+     */
+    bool on(const char* deviceLabel, const char* variableLabel, IntHandler handler);
+
+    /**
+     * @brief Publicar variable/s y series a Ubidots. Si no caben en un paquete de tamaño máximo
+     * (ver setMaxPacketSize()), se envían en varios paquetes consecutivos.
+     * 
+     * Los valores agregados después de setDevice() se publican a su propio dispositivo. Con un
+     * límite de envío (ver setRateLimit()), lo que no alcanza a enviarse queda en espera. Sin
+     * conexión, los valores que acepta el journal (ver setJournal()) se guardan en él, y el resto
+     * espera a que loop() reconecte, igual que si la conexión cae durante el envío.
+     * 
+     * @param deviceLabel Nombre del dispositivo (para valores sin dispositivo, y series)
+     * @return true Publicación tuvo éxito, o todos los valores quedaron en el journal
      * @return false Publicación falló
      */
     bool ubidotsPublish(const char *deviceLabel);
   
   private:
     void (*callback)(char*,uint8_t*,unsigned int);
-    void initialize(const char* token, char* clientName);
+    void initialize(const char* token, char* clientName, uint16_t maxValues,
+                    uint16_t maxContextEntries);
+    bool buildTopic(const char* deviceLabel, char* topic, size_t* maxPayload);
+    void supervise(uint32_t now);
+    void setState(UbidotsState state);
+    void retryLater(uint32_t now);
+    bool flushQueue(uint32_t now);
+    bool tokenReady(const char* deviceLabel, uint32_t now);
+    bool beginPacket(const char* topic, size_t length);
+    void store(uint8_t labelId, float value, const ValueDetail* detail);
+    void releaseValues(uint16_t first, uint8_t device, uint16_t count, uint32_t now);
+    void deferValues(uint16_t first, uint8_t device);
+    bool storeValues();
+    bool isJournalDevice(const char* deviceLabel) const;
+    void replayJournal(uint32_t now);
+    RateLimit* findRateLimit(const char* deviceLabel);
+    bool publishValues(const char* deviceLabel, const Value* values, uint16_t count, uint32_t now,
+                       uint16_t* done, bool* complete, bool* published);
+    bool publishDevice(uint8_t device, uint16_t first, uint32_t now, bool* complete,
+                       bool* published);
+    bool publishSeries(const char* deviceLabel, uint32_t now, bool* complete, bool* published);
+    bool publishPacket(const char* topic, const Value* values, uint16_t count, size_t length);
+    bool publishStorePacket(const char* topic, uint16_t first, uint8_t device, uint16_t count,
+                            size_t length);
+    bool publishSeriesPacket(const char* topic, SeriesCursor from, SeriesCursor to, size_t length);
+    void printPacket(const char* topic);
+    bool endPacket(PayloadStream& stream, size_t written, size_t length);
+    void discardSeries(SeriesCursor to);
+    void clearSeries();
+    PublishPolicy* findPolicy(const char* variableLabel);
+    ContextEntry* nextContextEntry(const char* key);
+    bool subscribeHandler(VariableHandler* handler);
+    void handleMessage(char* topic, uint8_t* payload, unsigned int length);
     char* getMac();
     
     char _macAddr[18];    
     WiFiClient espClient;
-    PubSubClient _client = PubSubClient(espClient);
+    BatchClient _link = BatchClient(espClient);
+    PubSubClient _client = PubSubClient(_link);
     char* _clientName = NULL;
     bool _debug = false;
-    uint8_t currentValue;    
+    uint16_t _maxPacketSize;
     const char* _token;
     const char* _server;
-    Value * val;
+    ValueStore _store;      // Valores pendientes, en el orden de los add()
+    LabelTable _labels;
+    bool _lastAdded;        // Indica si el último add() quedó en el buffer (para addContext())
+    const char* _currentDevice;
+    UbidotsState _state;
+    uint32_t _nextAttempt;
+    uint32_t _retryDelay;
+    uint16_t _tcpTimeout;   // Tiempo máximo de la conexión TCP, en ms
+    uint16_t _mqttTimeout;  // Tiempo máximo de respuesta del servidor, en s
+    VariableHandler* _nextSubscription;
+    uint16_t _queued;       // Valores al inicio del buffer que ya se pidió publicar
+    const char* _seriesDevice;
+    bool _seriesQueued;
+    RateLimit _rateLimit;
+    RateLimit* _deviceLimits;
+    RateLimit* _tokenLimit; // Límite del dispositivo del próximo paquete (ver tokenReady())
+    uint32_t _nextRelease;
+    uint32_t _retryIn;
+    uint32_t _deferrals;
+    uint32_t _dropped;
+    uint32_t _released;
+    uint32_t _totalDelay;
+    uint32_t _maxDelay;
+    UbidotsJournal* _journal;
+    const char* _journalDevice;
+    SampleSeries* _series;
+    PublishPolicy* _policies;
+    HandlerRegistry _handlers;
 };
 
 #endif
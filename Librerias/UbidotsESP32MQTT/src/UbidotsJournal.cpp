@@ -0,0 +1,448 @@
+/**
+ * @file UbidotsJournal.cpp
+ */
+
+#include "UbidotsJournal.h"
+#include <stdio.h>
+#include <string.h>
+
+#define JOURNAL_HEADER        'H'   // Primer registro de cada segmento, con su secuencia
+#define JOURNAL_VALUE         'V'   // Valor de una variable
+#define JOURNAL_ACK           'A'   // Confirmación: posición del primer registro sin enviar
+#define JOURNAL_PATH_LENGTH   64
+#define JOURNAL_CHECKED_SIZE  10    // Bytes cubiertos por el CRC
+
+static_assert(sizeof(JournalRecord) == JOURNAL_RECORD_SIZE, "Formato del registro del journal");
+
+static uint16_t recordCheck(const JournalRecord* record) {
+  const uint8_t* data = (const uint8_t*)record;
+  uint16_t crc = 0xFFFF;
+
+  // CRC-16/CCITT
+  for (uint8_t i = 0; i < JOURNAL_CHECKED_SIZE; i++) {
+    crc ^= (uint16_t)data[i] << 8;
+    for (uint8_t b = 0; b < 8; b++) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+
+  return crc;
+}
+
+static bool recordValid(const JournalRecord* record) {
+  return record->_check == recordCheck(record);
+}
+
+FileJournalStorage::FileJournalStorage(const char* path) {
+  _path = path;
+}
+
+void FileJournalStorage::segmentPath(uint8_t segment, char* path, size_t length) {
+  snprintf(path, length, "%s.%u", _path, segment);
+}
+
+size_t FileJournalStorage::size(uint8_t segment) {
+  char path[JOURNAL_PATH_LENGTH];
+  segmentPath(segment, path, sizeof(path));
+
+  FILE* file = fopen(path, "rb");
+
+  if (file == NULL) {
+    return 0;
+  }
+
+  long length = (fseek(file, 0, SEEK_END) == 0) ? ftell(file) : 0;
+  fclose(file);
+  return (length > 0) ? (size_t)length : 0;
+}
+
+size_t FileJournalStorage::read(uint8_t segment, size_t offset, void* data, size_t length) {
+  char path[JOURNAL_PATH_LENGTH];
+  segmentPath(segment, path, sizeof(path));
+
+  FILE* file = fopen(path, "rb");
+
+  if (file == NULL) {
+    return 0;
+  }
+
+  size_t bytes = (fseek(file, offset, SEEK_SET) == 0) ? fread(data, 1, length, file) : 0;
+  fclose(file);
+  return bytes;
+}
+
+bool FileJournalStorage::append(uint8_t segment, const void* data, size_t length) {
+  char path[JOURNAL_PATH_LENGTH];
+  segmentPath(segment, path, sizeof(path));
+
+  FILE* file = fopen(path, "ab");
+
+  if (file == NULL) {
+    return false;
+  }
+
+  bool written = fwrite(data, 1, length, file) == length;
+  return (fclose(file) == 0) && written;
+}
+
+bool FileJournalStorage::erase(uint8_t segment) {
+  char path[JOURNAL_PATH_LENGTH];
+  segmentPath(segment, path, sizeof(path));
+
+  remove(path);
+  return size(segment) == 0;
+}
+
+UbidotsJournal::UbidotsJournal(JournalStorage& storage, const char* const* labels,
+                               uint8_t labelCount, uint16_t segmentRecords) : _storage(storage) {
+  _labels = labels;
+  _labelCount = (labelCount < JOURNAL_MAX_LABELS) ? labelCount : JOURNAL_MAX_LABELS;
+  _segmentRecords = (segmentRecords > 1) ? segmentRecords : 2;
+  _dropped = 0;
+
+  for (uint8_t s = 0; s < JOURNAL_SEGMENTS; s++) {
+    _sequence[s] = 0;
+    _size[s] = 0;
+    _unsent[s] = 0;
+  }
+
+  _active = 0;
+  _cursor._segment = 0;
+  _cursor._slot = 1;
+}
+
+bool UbidotsJournal::begin() {
+  JournalRecord records[JOURNAL_READ_RECORDS];
+
+  // Un segmento sin encabezado válido quedó a medio crear: se descarta
+  for (uint8_t s = 0; s < JOURNAL_SEGMENTS; s++) {
+    _sequence[s] = 0;
+    _unsent[s] = 0;
+    _size[s] = _storage.size(s);
+
+    if (_size[s] == 0) {
+      continue;
+    }
+
+    if (readRecords(s, 0, records) > 0 && recordValid(&records[0]) &&
+        records[0]._type == JOURNAL_HEADER && records[0]._timestamp != 0) {
+      _sequence[s] = records[0]._timestamp;
+
+    } else if (_storage.erase(s)) {
+      _size[s] = 0;
+
+    } else {
+      return false;
+    }
+  }
+
+  if (_sequence[0] == 0 && _sequence[1] == 0) {
+    reset();
+    return true;
+  }
+
+  uint8_t oldest = (_sequence[1] != 0 && (_sequence[0] == 0 || _sequence[1] < _sequence[0])) ? 1 : 0;
+  uint8_t newest = (_sequence[1 - oldest] != 0) ? 1 - oldest : oldest;
+
+  _active = newest;
+  _cursor._segment = oldest;
+  _cursor._slot = 1;
+
+  // La última confirmación (en orden de escritura) indica hasta dónde se envió
+  for (uint8_t i = 0; i < JOURNAL_SEGMENTS; i++) {
+    uint8_t s = (i == 0) ? oldest : newest;
+
+    for (uint16_t slot = 0; ; ) {
+      uint16_t n = readRecords(s, slot, records);
+
+      if (n == 0) {
+        break;
+      }
+
+      for (uint16_t r = 0; r < n; r++) {
+        if (recordValid(&records[r]) && records[r]._type == JOURNAL_ACK) {
+          for (uint8_t a = 0; a < JOURNAL_SEGMENTS; a++) {
+            if (_sequence[a] != 0 && _sequence[a] == records[r]._timestamp) {
+              _cursor._segment = a;
+              _cursor._slot = records[r]._slot;
+            }
+          }
+        }
+      }
+
+      slot += n;
+    }
+
+    if (newest == oldest) {
+      break;
+    }
+  }
+
+  // Un segmento antiguo ya enviado por completo no se necesita
+  if (_cursor._segment != oldest) {
+    _storage.erase(oldest);
+    _sequence[oldest] = 0;
+    _size[oldest] = 0;
+  }
+
+  _unsent[_cursor._segment] = countValues(_cursor._segment, _cursor._slot);
+  if (_cursor._segment != _active) {
+    _unsent[_active] = countValues(_active, 1);
+  }
+
+  if (pending() == 0) {
+    reset();
+  }
+
+  return true;
+}
+
+bool UbidotsJournal::record(const char* variableLabel, float value, uint32_t timestamp) {
+  uint8_t label = labelId(variableLabel);
+
+  if (label >= _labelCount || timestamp < JOURNAL_MIN_TIME) {
+    return false;
+  }
+
+  if (_sequence[_active] == 0) {
+    if (!startSegment(_active)) {
+      return false;
+    }
+
+  } else if (_size[_active] / JOURNAL_RECORD_SIZE >= _segmentRecords) {
+    // Segmento lleno: se continúa en el otro, descartando lo que quedaba en él
+    uint8_t other = 1 - _active;
+
+    _dropped += _unsent[other];
+    _unsent[other] = 0;
+    _storage.erase(other);
+    _sequence[other] = 0;
+    _size[other] = _storage.size(other);
+
+    if (_cursor._segment == other) {
+      _cursor._segment = _active;
+      _cursor._slot = 1;
+    }
+
+    if (!startSegment(other)) {
+      return false;
+    }
+    _active = other;
+  }
+
+  JournalRecord r;
+  r._timestamp = timestamp;
+  r._value = value;
+  r._type = JOURNAL_VALUE;
+  r._label = label;
+
+  if (!appendRecord(_active, &r)) {
+    return false;
+  }
+
+  _unsent[_active]++;
+  return true;
+}
+
+uint16_t UbidotsJournal::peek(JournalEntry* entries, uint16_t count) {
+  JournalPosition position = _cursor;
+
+  if (count > pending()) {
+    count = pending();
+  }
+
+  return readValues(&position, entries, count);
+}
+
+void UbidotsJournal::consume(uint16_t count) {
+  if (count >= pending()) {
+    reset();
+    return;
+  }
+
+  uint8_t first = _cursor._segment;
+
+  readValues(&_cursor, NULL, count);
+
+  // Los valores se envían en orden: primero se agotan los del segmento antiguo
+  if (first != _active) {
+    uint16_t n = (count < _unsent[first]) ? count : _unsent[first];
+    _unsent[first] -= n;
+    _unsent[_active] -= count - n;
+
+    if (_unsent[first] == 0) {
+      _storage.erase(first);
+      _sequence[first] = 0;
+      _size[first] = _storage.size(first);
+
+      if (_cursor._segment == first) {
+        _cursor._segment = _active;
+        _cursor._slot = 1;
+      }
+    }
+
+  } else {
+    _unsent[_active] -= count;
+  }
+
+  // Confirmar la nueva posición, si cabe; si no, tras un reinicio sólo se repiten valores
+  if (_size[_active] / JOURNAL_RECORD_SIZE < _segmentRecords) {
+    JournalRecord r;
+    r._timestamp = _sequence[_cursor._segment];
+    r._slot = _cursor._slot;
+    r._type = JOURNAL_ACK;
+    r._label = 0;
+    appendRecord(_active, &r);
+  }
+}
+
+uint32_t UbidotsJournal::pending() const {
+  return _unsent[0] + _unsent[1];
+}
+
+uint32_t UbidotsJournal::dropped() const {
+  return _dropped;
+}
+
+uint8_t UbidotsJournal::labelId(const char* variableLabel) const {
+  for (uint8_t i = 0; i < _labelCount; i++) {
+    if (_labels[i] == variableLabel || strcmp(_labels[i], variableLabel) == 0) {
+      return i;
+    }
+  }
+
+  return JOURNAL_MAX_LABELS;
+}
+
+bool UbidotsJournal::appendRecord(uint8_t segment, JournalRecord* record) {
+  record->_check = recordCheck(record);
+
+  // Un corte a mitad de una escritura deja bytes sueltos: se completa el registro, que no pasará
+  // el CRC, para que los siguientes queden alineados
+  uint8_t padding[JOURNAL_RECORD_SIZE];
+  size_t partial = _size[segment] % JOURNAL_RECORD_SIZE;
+
+  if (partial != 0) {
+    memset(padding, 0xFF, sizeof(padding));
+    if (!_storage.append(segment, padding, JOURNAL_RECORD_SIZE - partial)) {
+      _size[segment] = _storage.size(segment);
+      return false;
+    }
+    _size[segment] += JOURNAL_RECORD_SIZE - partial;
+  }
+
+  if (!_storage.append(segment, record, JOURNAL_RECORD_SIZE)) {
+    _size[segment] = _storage.size(segment);
+    return false;
+  }
+
+  _size[segment] += JOURNAL_RECORD_SIZE;
+  return true;
+}
+
+bool UbidotsJournal::startSegment(uint8_t segment) {
+  JournalRecord r;
+  uint32_t sequence = ((_sequence[0] > _sequence[1]) ? _sequence[0] : _sequence[1]) + 1;
+
+  r._timestamp = sequence;
+  r._slot = 0;
+  r._type = JOURNAL_HEADER;
+  r._label = 0;
+
+  if (_size[segment] != 0 && !_storage.erase(segment)) {
+    return false;
+  }
+  _size[segment] = 0;
+
+  if (!appendRecord(segment, &r)) {
+    _storage.erase(segment);
+    _size[segment] = _storage.size(segment);
+    return false;
+  }
+
+  _sequence[segment] = sequence;
+  return true;
+}
+
+uint16_t UbidotsJournal::readRecords(uint8_t segment, uint16_t slot, JournalRecord* records) {
+  size_t bytes = _storage.read(segment, (size_t)slot * JOURNAL_RECORD_SIZE, records,
+                               JOURNAL_READ_RECORDS * JOURNAL_RECORD_SIZE);
+  return bytes / JOURNAL_RECORD_SIZE;
+}
+
+uint16_t UbidotsJournal::readValues(JournalPosition* position, JournalEntry* entries,
+                                    uint16_t count) {
+  JournalRecord records[JOURNAL_READ_RECORDS];
+  uint16_t found = 0;
+
+  while (found < count) {
+    uint16_t n = readRecords(position->_segment, position->_slot, records);
+
+    if (n == 0) {
+      // Fin del segmento antiguo: se sigue con el activo
+      if (position->_segment == _active || _sequence[_active] == 0) {
+        break;
+      }
+      position->_segment = _active;
+      position->_slot = 1;
+      continue;
+    }
+
+    for (uint16_t i = 0; i < n && found < count; i++) {
+      const JournalRecord* r = &records[i];
+      position->_slot++;
+
+      if (!recordValid(r) || r->_type != JOURNAL_VALUE || r->_label >= _labelCount) {
+        continue;
+      }
+
+      if (entries != NULL) {
+        entries[found]._variableLabel = _labels[r->_label];
+        entries[found]._value = r->_value;
+        entries[found]._timestamp = r->_timestamp;
+      }
+      found++;
+    }
+  }
+
+  return found;
+}
+
+uint32_t UbidotsJournal::countValues(uint8_t segment, uint16_t fromSlot) {
+  JournalRecord records[JOURNAL_READ_RECORDS];
+  uint32_t count = 0;
+
+  for (uint16_t slot = fromSlot; ; ) {
+    uint16_t n = readRecords(segment, slot, records);
+
+    if (n == 0) {
+      break;
+    }
+
+    for (uint16_t i = 0; i < n; i++) {
+      if (recordValid(&records[i]) && records[i]._type == JOURNAL_VALUE &&
+          records[i]._label < _labelCount) {
+        count++;
+      }
+    }
+
+    slot += n;
+  }
+
+  return count;
+}
+
+void UbidotsJournal::reset() {
+  for (uint8_t s = 0; s < JOURNAL_SEGMENTS; s++) {
+    if (_size[s] != 0 || _sequence[s] != 0) {
+      _storage.erase(s);
+    }
+    _sequence[s] = 0;
+    _size[s] = _storage.size(s);
+    _unsent[s] = 0;
+  }
+
+  _active = 0;
+  _cursor._segment = 0;
+  _cursor._slot = 1;
+}
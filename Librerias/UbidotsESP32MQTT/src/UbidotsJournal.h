@@ -0,0 +1,217 @@
+/**
+ * @file UbidotsJournal.h
+ */
+
+#ifndef UbidotsJournal_H
+#define UbidotsJournal_H
+
+#include <Arduino.h>
+
+#define JOURNAL_SEGMENTS      2           //!< Cantidad de segmentos del journal
+#define JOURNAL_RECORD_SIZE   12          //!< Tamaño de cada registro en bytes
+#define JOURNAL_READ_RECORDS  16          //!< Registros leídos por cada acceso al almacenamiento
+#define JOURNAL_MAX_LABELS    0xFF        //!< Cantidad máxima de variables del journal
+#define JOURNAL_MIN_TIME      1577836800  //!< Timestamp mínimo válido (2020-01-01), en segundos
+
+/**
+ * @brief Almacenamiento de los segmentos del journal.
+ *
+ * Cada segmento es un archivo de sólo agregado: se escribe al final, se lee en cualquier
+ * posición y se borra completo. Así el journal no depende del sistema de archivos, y en las
+ * pruebas se puede reemplazar por archivos comunes o por memoria.
+ */
+class JournalStorage {
+  public:
+    virtual ~JournalStorage() {}
+
+    /**
+     * @brief Tamaño de un segmento en bytes (0 si no existe).
+     */
+    virtual size_t size(uint8_t segment) = 0;
+
+    /**
+     * @brief Leer bytes de un segmento.
+     *
+     * @param segment Segmento
+     * @param offset Posición desde el inicio del segmento
+     * @param data Destino
+     * @param length Cantidad de bytes
+     * @return size_t Bytes leídos (menos que length al llegar al final)
+     */
+    virtual size_t read(uint8_t segment, size_t offset, void* data, size_t length) = 0;
+
+    /**
+     * @brief Agregar bytes al final de un segmento.
+     *
+     * @return true Bytes escritos
+     * @return false Error de escritura (puede haber quedado una parte escrita)
+     */
+    virtual bool append(uint8_t segment, const void* data, size_t length) = 0;
+
+    /**
+     * @brief Borrar un segmento completo.
+     */
+    virtual bool erase(uint8_t segment) = 0;
+};
+
+/**
+ * @brief Segmentos del journal en archivos, con la API de C (fopen).
+ *
+ * En ESP32 sirve para SPIFFS y LittleFS, que se montan en el sistema de archivos virtual: por
+ * ejemplo, tras SPIFFS.begin(true), la ruta "/spiffs/journal" usa los archivos
+ * "/spiffs/journal.0" y "/spiffs/journal.1". En Linux sirve para probar el journal con archivos
+ * comunes.
+ */
+class FileJournalStorage : public JournalStorage {
+  public:
+    /**
+     * @brief Construir el almacenamiento.
+     *
+     * @param path Ruta base de los archivos (debe existir mientras se utilice)
+     */
+    FileJournalStorage(const char* path);
+
+    size_t size(uint8_t segment);
+    size_t read(uint8_t segment, size_t offset, void* data, size_t length);
+    bool append(uint8_t segment, const void* data, size_t length);
+    bool erase(uint8_t segment);
+
+  private:
+    void segmentPath(uint8_t segment, char* path, size_t length);
+
+    const char* _path;
+};
+
+/**
+ * @brief Registro del journal, tal como se guarda en el almacenamiento (12 bytes).
+ */
+typedef struct JournalRecord {
+  uint32_t _timestamp;  // Unix Timestamp en segundos; en encabezados y confirmaciones, la secuencia
+  union {
+    float _value;
+    uint32_t _slot;     // En confirmaciones: registro siguiente al último enviado
+  };
+  uint8_t _type;
+  uint8_t _label;       // Índice en la tabla de variables
+  uint16_t _check;      // CRC-16 de los 10 bytes anteriores
+} JournalRecord;
+
+/**
+ * @brief Valor leído del journal.
+ */
+typedef struct JournalEntry {
+  const char* _variableLabel;
+  float _value;
+  uint32_t _timestamp;
+} JournalEntry;
+
+/**
+ * @brief Posición de un registro: segmento y registro dentro del segmento.
+ */
+typedef struct JournalPosition {
+  uint8_t _segment;
+  uint16_t _slot;
+} JournalPosition;
+
+/**
+ * @brief Journal persistente de valores con timestamp, para no perderlos sin conexión.
+ *
+ * Guarda cada valor como un registro binario de 12 bytes (variable, valor y timestamp) en el
+ * almacenamiento flash, sólo agregando al final: nunca reescribe un registro. Las variables se
+ * guardan como índice de una tabla fija, por lo que la tabla debe mantener su orden entre
+ * reinicios.
+ *
+ * Los registros se reparten en dos segmentos de tamaño fijo. Cuando el segmento activo se llena,
+ * se borra el otro y se continúa en él: si aún tenía valores sin enviar, se pierden los más
+ * antiguos (ver dropped()). Lo enviado se confirma con un registro de confirmación, y cuando todo
+ * está enviado se borran ambos segmentos, por lo que sin cortes el journal no escribe en flash.
+ *
+ * Un corte de energía a mitad de una escritura deja un registro incompleto, que se detecta por su
+ * CRC y se ignora. Si el corte ocurre entre un envío y su confirmación, esos valores se vuelven a
+ * enviar (con el mismo timestamp).
+ */
+class UbidotsJournal {
+  public:
+    /**
+     * @brief Construir un journal.
+     *
+     * @param storage Almacenamiento de los segmentos (debe existir mientras se utilice)
+     * @param labels Tabla de nombres de variables (debe existir mientras se utilice)
+     * @param labelCount Cantidad de variables (hasta JOURNAL_MAX_LABELS)
+     * @param segmentRecords Capacidad de cada segmento, en registros
+     */
+    UbidotsJournal(JournalStorage& storage, const char* const* labels, uint8_t labelCount,
+                   uint16_t segmentRecords);
+
+    /**
+     * @brief Recuperar el journal guardado: valores pendientes y posición de envío. Llamar una
+     * vez, con el sistema de archivos ya montado, antes de usar el journal.
+     *
+     * @return true Journal listo
+     * @return false Error de almacenamiento
+     */
+    bool begin();
+
+    /**
+     * @brief Guardar un valor.
+     *
+     * @param variableLabel Nombre de la variable (debe estar en la tabla)
+     * @param value Valor numérico
+     * @param timestamp Valor Unix Timestamp en segundos
+     * @return true Valor guardado
+     * @return false Variable desconocida, timestamp inválido o error de almacenamiento
+     */
+    bool record(const char* variableLabel, float value, uint32_t timestamp);
+
+    /**
+     * @brief Leer los valores pendientes más antiguos, sin marcarlos como enviados.
+     *
+     * @param entries Destino
+     * @param count Cantidad máxima de valores
+     * @return uint16_t Cantidad de valores leídos
+     */
+    uint16_t peek(JournalEntry* entries, uint16_t count);
+
+    /**
+     * @brief Marcar como enviados los valores pendientes más antiguos.
+     *
+     * @param count Cantidad de valores (normalmente, los de un peek() ya publicados)
+     */
+    void consume(uint16_t count);
+
+    /**
+     * @brief Cantidad de valores pendientes de envío.
+     */
+    uint32_t pending() const;
+
+    /**
+     * @brief Cantidad de valores perdidos por llenarse el journal.
+     */
+    uint32_t dropped() const;
+
+    /**
+     * @brief Índice de una variable en la tabla, o JOURNAL_MAX_LABELS si no está.
+     */
+    uint8_t labelId(const char* variableLabel) const;
+
+  private:
+    bool appendRecord(uint8_t segment, JournalRecord* record);
+    bool startSegment(uint8_t segment);
+    uint16_t readRecords(uint8_t segment, uint16_t slot, JournalRecord* records);
+    uint16_t readValues(JournalPosition* position, JournalEntry* entries, uint16_t count);
+    uint32_t countValues(uint8_t segment, uint16_t fromSlot);
+    void reset();
+
+    JournalStorage& _storage;
+    const char* const* _labels;
+    uint8_t _labelCount;
+    uint16_t _segmentRecords;
+    uint32_t _sequence[JOURNAL_SEGMENTS];   // Secuencia de cada segmento (0 si está vacío)
+    size_t _size[JOURNAL_SEGMENTS];         // Bytes de cada segmento
+    uint8_t _active;                        // Segmento en el que se escribe
+    JournalPosition _cursor;                // Primer registro sin enviar
+    uint32_t _unsent[JOURNAL_SEGMENTS];     // Valores sin enviar de cada segmento
+    uint32_t _dropped;
+};
+
+#endif
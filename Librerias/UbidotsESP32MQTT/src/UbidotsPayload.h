@@ -0,0 +1,291 @@
+/**
+ * @file UbidotsPayload.h
+ */
+
+#ifndef UbidotsPayload_H
+#define UbidotsPayload_H
+
+#include <Arduino.h>
+#include <Print.h>
+#include "UbidotsSeries.h"
+
+#define PAYLOAD_CHUNK_SIZE    64  //!< Tamaño del buffer intermedio al transmitir el JSON
+
+#define CONTEXT_NUMBER        0   //!< Entrada de contexto numérica
+#define CONTEXT_TEXT          1   //!< Entrada de contexto de texto
+
+/**
+ * @brief Entrada de contexto con tipo ("clave": valor).
+ *
+ * Los números se guardan en binario y se escriben recién al armar el JSON; los textos se guardan
+ * como puntero (no se copian) y se escapan al escribirlos.
+ */
+typedef struct ContextEntry {
+  const char* _key;
+  uint8_t _type;
+  uint8_t _decimals;
+  union {
+    float _number;
+    const char* _text;
+  };
+} ContextEntry;
+
+/**
+ * @brief Valor completo, para serializar (el cliente guarda los suyos en un ValueStore).
+ */
+typedef struct Value {
+  const char* _variableLabel;
+  float _value;
+  char* _context;
+  uint32_t _timestamp;
+  const ContextEntry* _entries;   // Contexto con tipo, se escribe después de _context
+  uint8_t _entryCount;
+} Value;
+
+/**
+ * @brief Posición dentro de una lista de series: serie y muestra.
+ */
+typedef struct SeriesCursor {
+  SampleSeries* _series;  // NULL indica el final de la lista
+  uint16_t _sample;
+} SeriesCursor;
+
+/**
+ * @brief Escritor de texto de sólo agregado.
+ *
+ * Mantiene la longitud total escrita, por lo que cada agregado cuesta sólo lo que se escribe.
+ * El destino lo define cada clase derivada: un buffer fijo (PayloadBuffer), un contador que sólo
+ * mide (PayloadCounter) o una salida Print, como el cliente MQTT (PayloadStream). Si un agregado
+ * no cabe, se marca el desborde y el resto de los agregados se ignoran.
+ */
+class PayloadWriter {
+  public:
+    PayloadWriter();
+    virtual ~PayloadWriter() {}
+
+    /**
+     * @brief Agregar un texto terminado en '\0'.
+     *
+     * @param text Texto a agregar
+     * @return true El texto fue escrito
+     * @return false Desborde
+     */
+    bool append(const char* text);
+
+    /**
+     * @brief Agregar una cantidad fija de caracteres.
+     *
+     * @param text Texto a agregar
+     * @param length Cantidad de caracteres
+     * @return true El texto fue escrito
+     * @return false Desborde
+     */
+    bool append(const char* text, size_t length);
+
+    /**
+     * @brief Agregar un caracter.
+     *
+     * @param c Caracter a agregar
+     * @return true El caracter fue escrito
+     * @return false Desborde
+     */
+    bool append(char c);
+
+    /**
+     * @brief Agregar un entero sin signo en base 10.
+     *
+     * @param value Valor a agregar
+     * @return true El número fue escrito
+     * @return false Desborde
+     */
+    bool appendUInt(uint32_t value);
+
+    /**
+     * @brief Agregar un texto escapado para ir dentro de un string JSON (sin las comillas).
+     *
+     * Escapa '"', '\\' y los caracteres de control.
+     *
+     * @param text Texto a agregar, terminado en '\0'
+     * @return true El texto fue escrito
+     * @return false Desborde
+     */
+    bool appendEscaped(const char* text);
+
+    /**
+     * @brief Agregar un número decimal con una cantidad fija de decimales.
+     *
+     * El texto es el mismo que el de "%.*f", pero sin pasar por printf (ver ubidotsFormatFixed()).
+     *
+     * @param value Valor a agregar
+     * @param decimals Cantidad de decimales (más de FORMAT_MAX_DECIMALS se escriben como
+     * FORMAT_MAX_DECIMALS)
+     * @return true El número fue escrito
+     * @return false Desborde
+     */
+    bool appendFloat(float value, uint8_t decimals);
+
+    /**
+     * @brief Cantidad de caracteres escritos.
+     */
+    size_t length() const;
+
+    /**
+     * @brief Indica si algún agregado no pudo ser escrito.
+     */
+    bool overflowed() const;
+
+  protected:
+    /**
+     * @brief Escribir caracteres en el destino.
+     *
+     * @param data Caracteres a escribir
+     * @param length Cantidad de caracteres
+     * @return true Caracteres escritos
+     * @return false No hay espacio en el destino
+     */
+    virtual bool write(const char* data, size_t length) = 0;
+
+  private:
+    size_t _length;
+    bool _overflow;
+};
+
+/**
+ * @brief Escritor sobre un buffer de tamaño fijo, siempre terminado en '\0'.
+ */
+class PayloadBuffer : public PayloadWriter {
+  public:
+    /**
+     * @brief Construir un nuevo escritor.
+     *
+     * @param buffer Buffer de destino
+     * @param size Tamaño total del buffer (incluyendo el caracter nulo)
+     */
+    PayloadBuffer(char* buffer, size_t size);
+
+    /**
+     * @brief Texto escrito, terminado en '\0'.
+     */
+    const char* c_str() const;
+
+  protected:
+    virtual bool write(const char* data, size_t length);
+
+  private:
+    char* _buffer;
+    size_t _size;
+};
+
+/**
+ * @brief Escritor que no almacena nada, sólo mide la longitud del texto.
+ */
+class PayloadCounter : public PayloadWriter {
+  protected:
+    virtual bool write(const char* data, size_t length);
+};
+
+/**
+ * @brief Escritor que transmite el texto a una salida Print en bloques de PAYLOAD_CHUNK_SIZE.
+ *
+ * Al terminar se debe llamar a flush() para enviar el último bloque.
+ */
+class PayloadStream : public PayloadWriter {
+  public:
+    /**
+     * @brief Construir un nuevo escritor.
+     *
+     * @param out Salida de destino (por ejemplo, PubSubClient entre beginPublish/endPublish)
+     */
+    PayloadStream(Print& out);
+
+    /**
+     * @brief Enviar los caracteres pendientes del bloque actual.
+     *
+     * @return true Caracteres enviados
+     * @return false La salida no aceptó todos los caracteres
+     */
+    bool flush();
+
+  protected:
+    virtual bool write(const char* data, size_t length);
+
+  private:
+    Print& _out;
+    char _chunk[PAYLOAD_CHUNK_SIZE];
+    size_t _used;
+};
+
+/**
+ * @brief Construir el diccionario JSON de Ubidots para un conjunto de valores.
+ *
+ * Formato: {"var": [{"value": 1.00, "timestamp": 1600000000000, "context": {...}}], ...}
+ *
+ * Como el resultado sólo depende de los valores, se puede llamar primero con un PayloadCounter
+ * para conocer el largo exacto, y luego con un PayloadStream para transmitirlo.
+ *
+ * @param values Valores a serializar
+ * @param count Cantidad de valores
+ * @param writer Escritor de destino
+ * @return Longitud del payload, o 0 si no pudo ser escrito completo
+ */
+size_t buildPayload(const Value* values, uint16_t count, PayloadWriter& writer);
+
+/**
+ * @brief Agregar el final de la entrada de un valor, después del número: timestamp, contexto y
+ * el cierre "}]".
+ *
+ * @param writer Escritor de destino
+ * @param timestamp Valor Unix Timestamp en segundos, o 0 si no tiene
+ * @param context Contexto en texto, o NULL
+ * @param entries Contexto con tipo, se escribe después de context
+ * @param entryCount Cantidad de entradas
+ */
+void appendValueEnd(PayloadWriter& writer, uint32_t timestamp, const char* context,
+                    const ContextEntry* entries, uint8_t entryCount);
+
+/**
+ * @brief Calcular cuántos valores consecutivos caben en un mismo JSON.
+ *
+ * Siempre se incluye al menos un valor; si ese valor por sí solo excede maxLength, el largo
+ * devuelto será mayor a maxLength y el llamador debe descartarlo.
+ *
+ * @param values Valores a serializar
+ * @param count Cantidad de valores disponibles
+ * @param maxLength Largo máximo del JSON
+ * @param length Largo exacto del JSON con los valores que caben
+ * @return Cantidad de valores que caben (al menos 1 si count > 0)
+ */
+uint16_t fitPayload(const Value* values, uint16_t count, size_t maxLength, size_t* length);
+
+/**
+ * @brief Comparar dos nombres de dispositivo (NULL sólo es igual a NULL).
+ */
+bool sameDevice(const char* a, const char* b);
+
+/**
+ * @brief Construir el diccionario JSON de Ubidots para las muestras de una lista de series.
+ *
+ * Formato: {"var": [{"value": 1.00, "timestamp": 1600000000250}, {...}], ...}
+ *
+ * @param from Primera muestra a incluir
+ * @param to Primera muestra que no se incluye ({NULL, 0} para llegar al final de la lista)
+ * @param writer Escritor de destino
+ * @return Longitud del payload, o 0 si no pudo ser escrito completo
+ */
+size_t buildSeriesPayload(SeriesCursor from, SeriesCursor to, PayloadWriter& writer);
+
+/**
+ * @brief Calcular cuántas muestras consecutivas, desde una posición, caben en un mismo JSON.
+ *
+ * Siempre se incluye al menos una muestra si quedan muestras; si esa muestra por sí sola excede
+ * maxLength, el largo devuelto será mayor a maxLength y el llamador debe descartarla.
+ *
+ * @param from Primera muestra a incluir
+ * @param maxLength Largo máximo del JSON
+ * @param to Primera muestra que no cabe ({NULL, 0} si caben todas)
+ * @param length Largo exacto del JSON con las muestras que caben
+ * @return Cantidad de muestras que caben
+ */
+uint16_t fitSeriesPayload(SeriesCursor from, size_t maxLength, SeriesCursor* to, size_t* length);
+
+#endif
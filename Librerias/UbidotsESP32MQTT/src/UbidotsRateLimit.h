@@ -0,0 +1,89 @@
+/**
+ * @file UbidotsRateLimit.h
+ */
+
+#ifndef UbidotsRateLimit_H
+#define UbidotsRateLimit_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Límite de envío con balde de tokens (token bucket).
+ *
+ * Cada paquete Publish consume un token. Los tokens se recuperan a una tasa fija, hasta un máximo
+ * (ráfaga). El cliente tiene un límite general para su token (Ubidots::setRateLimit()), y se
+ * puede registrar uno adicional por dispositivo (Ubidots::addRateLimit()). Los paquetes que no
+ * tienen token no se descartan: quedan en espera y Ubidots::loop() los envía al recuperarse.
+ */
+class RateLimit {
+  public:
+    /**
+     * @brief Construir un límite sin restricciones, para el token completo.
+     */
+    RateLimit();
+
+    /**
+     * @brief Construir un límite sin restricciones, para un dispositivo.
+     *
+     * @param deviceLabel Nombre del dispositivo
+     */
+    RateLimit(const char* deviceLabel);
+
+    /**
+     * @brief Establecer la tasa de recuperación de tokens.
+     *
+     * @param perSecond Paquetes por segundo (0 para no limitar)
+     * @return RateLimit& El mismo límite
+     */
+    RateLimit& setRate(float perSecond);
+
+    /**
+     * @brief Establecer la ráfaga: máximo de tokens acumulados. El balde comienza lleno.
+     *
+     * @param burst Cantidad de paquetes que se pueden enviar seguidos (al menos 1)
+     * @return RateLimit& El mismo límite
+     */
+    RateLimit& setBurst(uint16_t burst);
+
+    /**
+     * @brief Recuperar los tokens del tiempo transcurrido, e indicar si hay uno disponible.
+     *
+     * @param now Tiempo actual en milisegundos (millis())
+     * @return true Hay al menos un token
+     * @return false Hay que esperar (ver wait())
+     */
+    bool ready(uint32_t now);
+
+    /**
+     * @brief Consumir un token. Llamar sólo después de que ready() retorne true.
+     */
+    void consume();
+
+    /**
+     * @brief Milisegundos hasta el próximo token, según el último ready().
+     */
+    uint32_t wait() const;
+
+    /**
+     * @brief Nombre del dispositivo, o NULL si es el límite del token.
+     */
+    const char* label() const;
+
+    /**
+     * @brief Siguiente límite registrado en el cliente, o NULL.
+     */
+    RateLimit* next() const;
+
+  private:
+    friend class Ubidots;
+
+    const char* _deviceLabel;
+    float _rate;        // Tokens por segundo
+    float _tokens;
+    uint16_t _burst;
+    uint32_t _last;
+    bool _started;
+    RateLimit* _next;
+};
+
+#endif
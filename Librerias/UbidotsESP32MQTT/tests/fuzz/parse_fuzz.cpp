@@ -0,0 +1,57 @@
+#include "UbidotsParse.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Objetivo para libFuzzer: ningún payload debe leer fuera de su largo ni entregar un valor
+// inconsistente con el resultado de la conversión.
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    int32_t integer = 0x5A5A5A5A;
+    int32_t fixed = 0x5A5A5A5A;
+    float decimal = 1234.5f;
+
+    // Copia exacta en el heap, para que ASan detecte cualquier lectura después del final
+    uint8_t* payload = (uint8_t*)malloc(size ? size : 1);
+    memcpy(payload, data, size);
+
+    if (!ubidotsParseInt(payload, size, &integer) && integer != 0x5A5A5A5A) {
+        abort();
+    }
+    if (!ubidotsParseFixed(payload, size, size % 10, &fixed) && fixed != 0x5A5A5A5A) {
+        abort();
+    }
+    if (ubidotsParseFloat(payload, size, &decimal)) {
+        if (isnan(decimal) || isinf(decimal)) {
+            abort();
+        }
+    } else if (decimal != 1234.5f) {
+        abort();
+    }
+
+    free(payload);
+    return 0;
+}
+
+#ifndef LIBFUZZER
+// Sin libFuzzer, se ejecuta cada archivo recibido como argumento (por ejemplo, el corpus)
+int main(int argc, char** argv) {
+    uint8_t buffer[256];
+
+    for (int i = 1; i < argc; i++) {
+        FILE* file = fopen(argv[i], "rb");
+
+        if (file == NULL) {
+            printf("Cannot open %s\n", argv[i]);
+            return 1;
+        }
+
+        size_t size = fread(buffer, 1, sizeof(buffer), file);
+        fclose(file);
+        LLVMFuzzerTestOneInput(buffer, size);
+    }
+
+    printf("%d inputs ok\n", argc - 1);
+    return 0;
+}
+#endif
@@ -0,0 +1,117 @@
+#include "UbidotsBatchClient.h"
+#include "BDDTest.h"
+#include "trace.h"
+#include <string.h>
+#include <string>
+
+// Cliente que registra lo escrito y la cantidad de escrituras
+class CaptureClient : public Client {
+public:
+    std::string data;
+    int writes;
+    size_t limit;
+    bool stopped;
+    CaptureClient() : writes(0), limit(100000), stopped(false) {}
+    virtual int connect(IPAddress /* ip */, uint16_t /* port */) { return 1; }
+    virtual int connect(const char* /* host */, uint16_t /* port */) { return 1; }
+    virtual size_t write(uint8_t b) { return write(&b, 1); }
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        writes++;
+        if (data.size() + size > limit) {
+            return 0;
+        }
+        data.append((const char*)buffer, size);
+        return size;
+    }
+    virtual int available() { return 0; }
+    virtual int read() { return -1; }
+    virtual int read(uint8_t* /* buffer */, size_t /* size */) { return -1; }
+    virtual int peek() { return -1; }
+    virtual void flush() {}
+    virtual void stop() { stopped = true; }
+    virtual uint8_t connected() { return 1; }
+    virtual operator bool() { return true; }
+};
+
+size_t writeText(Client& client, const char* text) {
+    return client.write((const uint8_t*)text, strlen(text));
+}
+
+
+int test_batch_passthrough() {
+    IT("writes directly outside a batch");
+    CaptureClient out;
+    BatchClient link(out);
+
+    IS_EQUAL(writeText(link, "abc"), 3);
+    IS_EQUAL(link.write('d'), 1);
+
+    IS_TRUE(out.data == "abcd");
+    IS_EQUAL(out.writes, 2);
+
+    END_IT
+}
+
+int test_batch_coalesces() {
+    IT("coalesces the writes of a batch into blocks of BATCH_BUFFER_SIZE");
+    CaptureClient out;
+    BatchClient link(out);
+    std::string expected;
+
+    link.beginBatch();
+    for (int i = 0; i < 100; i++) {
+        IS_EQUAL(writeText(link, "0123456789"), 10);
+        expected += "0123456789";
+    }
+    IS_EQUAL(out.writes, 1000 / BATCH_BUFFER_SIZE);
+
+    IS_TRUE(link.endBatch());
+    IS_TRUE(out.data == expected);
+    IS_EQUAL(out.writes, (1000 + BATCH_BUFFER_SIZE - 1) / BATCH_BUFFER_SIZE);
+
+    END_IT
+}
+
+int test_batch_failure() {
+    IT("reports a failed write and drops the rest of the batch");
+    CaptureClient out;
+    out.limit = 10;
+    BatchClient link(out);
+    uint8_t block[BATCH_BUFFER_SIZE] = { 0 };
+
+    link.beginBatch();
+    IS_EQUAL(link.write(block, sizeof(block)), 0);
+    IS_EQUAL(writeText(link, "abc"), 0);
+    IS_FALSE(link.endBatch());
+    IS_EQUAL(out.writes, 1);
+
+    END_IT
+}
+
+int test_batch_stop() {
+    IT("discards pending data when the connection stops");
+    CaptureClient out;
+    BatchClient link(out);
+
+    link.beginBatch();
+    writeText(link, "abc");
+    link.stop();
+
+    IS_TRUE(out.stopped);
+    IS_TRUE(link.endBatch());
+    IS_EQUAL(out.writes, 0);
+
+    END_IT
+}
+
+
+int main()
+{
+    SUITE("Batch");
+    test_batch_passthrough();
+    test_batch_coalesces();
+    test_batch_failure();
+    test_batch_stop();
+
+    FINISH
+}
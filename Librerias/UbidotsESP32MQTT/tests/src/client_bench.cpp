@@ -0,0 +1,65 @@
+#include "UbidotsESP32MQTT.h"
+#include <chrono>
+#include <iostream>
+
+#define ITERATIONS 200000
+#define VALUES     5
+
+static char CLIENT_NAME[] = "cliente";
+
+int main()
+{
+    const uint8_t connack[] = { 0x20, 0x02, 0x00, 0x00 };
+    const char* const labels[VALUES] = { "temperatura", "humedad", "distancia", "pot", "boton" };
+
+    WiFi.setStatus(WL_CONNECTED);
+    Ubidots ubidots("BBFF-token", CLIENT_NAME, VALUES);
+    ubidots.begin(NULL);
+
+    for (int i = 0; i < 10 && ubidots.state() != UBIDOTS_CONNECTED; i++) {
+        if (ubidots.state() == UBIDOTS_MQTT_CONNECTING) {
+            network.respond(connack, sizeof(connack));
+        }
+        ubidots.loop();
+    }
+
+    if (ubidots.state() != UBIDOTS_CONNECTED) {
+        std::cout << "no connection\n";
+        return 1;
+    }
+
+    // Sólo se cuentan los bytes: guardarlos mediría a std::string, no al cliente
+    network.capture = false;
+
+    for (int pass = 0; pass < 2; pass++) {
+        uint8_t ids[VALUES];
+        for (int i = 0; i < VALUES; i++) {
+            ids[i] = ubidots.addLabel(labels[i]);
+        }
+
+        network.bytes = 0;
+        network.writes = 0;
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (long i = 0; i < ITERATIONS; i++) {
+            for (int v = 0; v < VALUES; v++) {
+                float value = (float)((i + v) % 1000) / 10;
+                if (pass == 0) {
+                    ubidots.add(labels[v], value);
+                } else {
+                    ubidots.add(ids[v], value);
+                }
+            }
+            ubidots.ubidotsPublish("esp32");
+        }
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+        double seconds = std::chrono::duration<double>(end - start).count();
+        std::cout << (pass == 0 ? "add(label)" : "add(id)") << " + ubidotsPublish, " << VALUES
+                  << " values: " << ITERATIONS / seconds << " publishes/s, "
+                  << (double)network.bytes / (ITERATIONS * VALUES) << " bytes/value, "
+                  << (double)network.writes / ITERATIONS << " writes/publish\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,645 @@
+#include "UbidotsESP32MQTT.h"
+#include "BDDTest.h"
+#include "trace.h"
+#include <string>
+#include <string.h>
+
+#define TOKEN         "BBFF-token"
+#define JOURNAL_PATH  "bin/client_spec"
+#define T0            1600000000
+
+static char CLIENT_NAME[] = "cliente";
+static const char* const LABELS[] = { "temperatura", "humedad" };
+
+static float floatReceived;
+static std::string callbackTopic;
+
+static void onBoton(float value) {
+    floatReceived = value;
+}
+
+static void callback(char* topic, uint8_t* /* payload */, unsigned int /* length */) {
+    callbackTopic = topic;
+}
+
+// Cadena MQTT: largo en dos bytes y luego el texto
+static std::string mqttString(const char* text) {
+    std::string s;
+    s += (char)(strlen(text) >> 8);
+    s += (char)(strlen(text) & 0xFF);
+    return s + text;
+}
+
+// Paquete MQTT: encabezado, largo restante (varint) y cuerpo
+static std::string packet(uint8_t header, const std::string& body) {
+    std::string s(1, (char)header);
+    size_t length = body.size();
+
+    do {
+        uint8_t digit = length % 128;
+        length /= 128;
+        s += (char)(length > 0 ? digit | 0x80 : digit);
+    } while (length > 0);
+
+    return s + body;
+}
+
+static std::string publishPacket(const char* topic, const char* json) {
+    return packet(0x30, mqttString(topic) + json);
+}
+
+// Lee el siguiente paquete de los bytes enviados. Devuelve false si no queda uno completo
+static bool nextPacket(const std::string& sent, size_t* pos, uint8_t* header, std::string* body) {
+    size_t p = *pos;
+    size_t length = 0;
+    size_t multiplier = 1;
+
+    if (p >= sent.size()) {
+        return false;
+    }
+    *header = sent[p++];
+
+    uint8_t digit;
+    do {
+        if (p >= sent.size()) {
+            return false;
+        }
+        digit = sent[p++];
+        length += (digit & 0x7F) * multiplier;
+        multiplier *= 128;
+    } while (digit & 0x80);
+
+    if (p + length > sent.size()) {
+        return false;
+    }
+
+    *body = sent.substr(p, length);
+    *pos = p + length;
+    return true;
+}
+
+static void startNetwork() {
+    network.reset();
+    hostMillis = 0;
+    floatReceived = 0;
+    callbackTopic.clear();
+    WiFi.setStatus(WL_CONNECTED);
+}
+
+// Llama a loop() hasta quedar conectado, respondiendo CONNACK cuando el cliente lo espera
+static bool connectClient(Ubidots& ubidots) {
+    const uint8_t connack[] = { 0x20, 0x02, 0x00, 0x00 };
+
+    for (int i = 0; i < 10 && ubidots.state() != UBIDOTS_CONNECTED; i++) {
+        if (ubidots.state() == UBIDOTS_MQTT_CONNECTING) {
+            network.respond(connack, sizeof(connack));
+        }
+        ubidots.loop();
+    }
+
+    return ubidots.state() == UBIDOTS_CONNECTED;
+}
+
+
+int test_client_connect() {
+    IT("opens the connection with the exact CONNECT packet");
+    startNetwork();
+    Ubidots ubidots(TOKEN, CLIENT_NAME);
+    ubidots.begin(callback);
+
+    IS_TRUE(connectClient(ubidots));
+    IS_TRUE(network.host == SERVER);
+    IS_EQUAL(network.port, MQTT_PORT);
+    IS_EQUAL(network.connects, 1);
+
+    // Protocolo MQTT 3.1.1, usuario (token) y sesión limpia, keepalive de 15 s
+    std::string body = mqttString("MQTT") + std::string("\x04\x82\x00\x0F", 4) +
+                       mqttString(CLIENT_NAME) + mqttString(TOKEN);
+    IS_TRUE(network.sent == packet(0x10, body));
+
+    END_IT
+}
+
+int test_client_connect_backoff() {
+    IT("retries a refused TCP connection with a growing delay");
+    startNetwork();
+    network.allowConnect = false;
+    Ubidots ubidots(TOKEN, CLIENT_NAME);
+    ubidots.begin(callback);
+
+    ubidots.loop();
+    ubidots.loop();
+    IS_EQUAL(ubidots.state(), UBIDOTS_TCP_CONNECTING);
+    IS_TRUE(network.sent.empty());
+
+    // El segundo intento no ocurre antes de RECONNECT_INTERVAL
+    network.allowConnect = true;
+    hostMillis += RECONNECT_INTERVAL / 2;
+    ubidots.loop();
+    IS_EQUAL(network.connects, 0);
+
+    hostMillis += RECONNECT_INTERVAL;
+    IS_TRUE(connectClient(ubidots));
+    IS_EQUAL(network.connects, 1);
+
+    END_IT
+}
+
+int test_client_connect_timeout() {
+    IT("waits for the TCP connection and the CONNACK at most the given timeouts");
+    startNetwork();
+    Ubidots ubidots(TOKEN, CLIENT_NAME);
+    ubidots.setConnectTimeout(500, 1);
+    ubidots.begin(callback);
+
+    ubidots.loop();
+    ubidots.loop();
+    IS_EQUAL(ubidots.state(), UBIDOTS_MQTT_CONNECTING);
+    IS_EQUAL(network.timeout, 500);
+
+    // Sin CONNACK, la llamada que envía el CONNECT vuelve tras 1 s y reintenta más tarde
+    uint32_t start = hostMillis;
+    ubidots.loop();
+    IS_EQUAL(ubidots.state(), UBIDOTS_TCP_CONNECTING);
+    IS_TRUE(hostMillis - start >= 1000 && hostMillis - start < 1100);
+
+    END_IT
+}
+
+int test_client_publish() {
+    IT("publishes the exact topic and JSON of the added values");
+    startNetwork();
+    Ubidots ubidots(TOKEN, CLIENT_NAME);
+    ubidots.begin(callback);
+    IS_TRUE(connectClient(ubidots));
+    network.sent.clear();
+
+    ubidots.add("temperatura", 21.5);
+    ubidots.add("humedad", 60, NULL, T0);
+    IS_TRUE(ubidots.ubidotsPublish("esp32"));
+
+    IS_TRUE(network.sent == publishPacket("/v1.6/devices/esp32",
+        "{\"temperatura\": [{\"value\": 21.50}], "
+        "\"humedad\": [{\"value\": 60.00, \"timestamp\": 1600000000000}]}"));
+
+    // El buffer queda vacío tras publicar
+    network.sent.clear();
+    IS_FALSE(ubidots.ubidotsPublish("esp32"));
+    IS_TRUE(network.sent.empty());
+
+    END_IT
+}
+
+int test_client_publish_packed() {
+    IT("publishes values added by id with the same bytes as by name");
+    startNetwork();
+    Ubidots ubidots(TOKEN, CLIENT_NAME);
+    ubidots.begin(callback);
+    IS_TRUE(connectClient(ubidots));
+
+    uint8_t temperatura = ubidots.addLabel("temperatura");
+    uint8_t humedad = ubidots.addLabel("humedad");
+
+    ubidots.add("temperatura", 21.5);
+    ubidots.add("humedad", 55.25);
+    network.sent.clear();
+    IS_TRUE(ubidots.ubidotsPublish("esp32"));
+    std::string byName = network.sent;
+
+    ubidots.add(temperatura, 21.5);
+    ubidots.add(humedad, 55.25);
+    network.sent.clear();
+    IS_TRUE(ubidots.ubidotsPublish("esp32"));
+    IS_TRUE(network.sent == byName);
+
+    // Por id y por nombre en el mismo lote, en el orden de los add()
+    ubidots.add(humedad, 55.25);
+    ubidots.add("presion", 1013, NULL, 1700000000);
+    ubidots.add(temperatura, 21.5);
+    network.sent.clear();
+    IS_TRUE(ubidots.ubidotsPublish("esp32"));
+    IS_TRUE(network.sent == publishPacket("/v1.6/devices/esp32",
+        "{\"humedad\": [{\"value\": 55.25}], "
+        "\"presion\": [{\"value\": 1013.00, \"timestamp\": 1700000000000}], "
+        "\"temperatura\": [{\"value\": 21.50}]}"));
+
+    END_IT
+}
+
+int test_client_publish_aggregate() {
+    IT("publishes a sampler window as its mean with the rest as context");
+    startNetwork();
+    Ubidots ubidots(TOKEN, CLIENT_NAME);
+    ubidots.begin(callback);
+    IS_TRUE(connectClient(ubidots));
+
+    Sampler sampler("distancia", NULL, 0, 4);
+    const float values[] = { 10, 12, 14, 16 };
+    ubidots.add(sampler.aggregate());
+    for (int i = 0; i < 4; i++) {
+        sampler.record(values[i]);
+    }
+    ubidots.add(sampler.aggregate());
+
+    // La ventana vacía no agrega nada
+    network.sent.clear();
+    IS_TRUE(ubidots.ubidotsPublish("esp32"));
+    IS_TRUE(network.sent == publishPacket("/v1.6/devices/esp32",
+        "{\"distancia\": [{\"value\": 13.00, \"context\": "
+        "{\"min\": 10.00, \"max\": 16.00, \"sd\": 2.58, \"n\": 4}}]}"));
+
+    END_IT
+}
+
+int test_client_publish_split() {
+    IT("splits the values into packets that fit the maximum size");
+    startNetwork();
+    Ubidots ubidots(TOKEN, CLIENT_NAME);
+    ubidots.begin(callback);
+    ubidots.setMaxPacketSize(80);
+    IS_TRUE(connectClient(ubidots));
+    network.sent.clear();
+
+    ubidots.add("temperatura", 21.5);
+    ubidots.add("humedad", 60);
+    ubidots.add("distancia", 123);
+    IS_TRUE(ubidots.ubidotsPublish("esp32"));
+
+    size_t pos = 0;
+    uint8_t header;
+    std::string body;
+    std::string payloads;
+    int packets = 0;
+    std::string topic = mqttString("/v1.6/devices/esp32");
+
+    while (nextPacket(network.sent, &pos, &header, &body)) {
+        IS_EQUAL(header, 0x30);
+        IS_TRUE(body.size() + 2 <= 80);
+        IS_TRUE(body.compare(0, topic.size(), topic) == 0);
+        payloads += body.substr(topic.size());
+        packets++;
+    }
+
+    IS_EQUAL(pos, network.sent.size());
+    IS_TRUE(packets > 1);
+    IS_TRUE(payloads.find("\"temperatura\": [{\"value\": 21.50}]") != std::string::npos);
+    IS_TRUE(payloads.find("\"humedad\": [{\"value\": 60.00}]") != std::string::npos);
+    IS_TRUE(payloads.find("\"distancia\": [{\"value\": 123.00}]") != std::string::npos);
+
+    END_IT
+}
+
+int test_client_subscribe() {
+    IT("subscribes to registered variables and renews them after reconnecting");
+    startNetwork();
+    Ubidots ubidots(TOKEN, CLIENT_NAME);
+    ubidots.begin(callback);
+    IS_TRUE(ubidots.ubidotsSubscribe("esp32", "boton"));
+    IS_TRUE(network.sent.empty());
+
+    IS_TRUE(connectClient(ubidots));
+
+    std::string subscribe = packet(0x82, std::string("\x00\x02", 2) +
+                                         mqttString("/v1.6/devices/esp32/boton/lv") + '\0');
+    size_t pos = 0;
+    uint8_t header;
+    std::string body;
+
+    IS_TRUE(nextPacket(network.sent, &pos, &header, &body));
+    IS_EQUAL(header, 0x10);
+    IS_TRUE(network.sent.substr(pos) == subscribe);
+
+    // El servidor cierra la conexión: loop() reconecta y vuelve a suscribirse
+    network.drop();
+    network.sent.clear();
+    ubidots.loop();
+    IS_EQUAL(ubidots.state(), UBIDOTS_TCP_CONNECTING);
+    IS_TRUE(connectClient(ubidots));
+    IS_EQUAL(network.connects, 2);
+
+    pos = 0;
+    IS_TRUE(nextPacket(network.sent, &pos, &header, &body));
+    IS_EQUAL(header, 0x10);
+    IS_TRUE(network.sent.substr(pos) == subscribe);
+
+    END_IT
+}
+
+int test_client_dispatch() {
+    IT("passes incoming values to their handler and other messages to the callback");
+    startNetwork();
+    Ubidots ubidots(TOKEN, CLIENT_NAME);
+    ubidots.begin(callback);
+    IS_TRUE(ubidots.on("esp32", "boton", onBoton));
+    IS_TRUE(connectClient(ubidots));
+
+    std::string message = publishPacket("/v1.6/devices/esp32/boton/lv", "1.5");
+    network.respond(message.data(), message.size());
+    ubidots.loop();
+    IS_TRUE(floatReceived == 1.5f);
+    IS_TRUE(callbackTopic.empty());
+
+    message = publishPacket("/v1.6/devices/esp32/led/lv", "1");
+    network.respond(message.data(), message.size());
+    ubidots.loop();
+    IS_TRUE(callbackTopic == "/v1.6/devices/esp32/led/lv");
+
+    END_IT
+}
+
+int test_client_rate_limit() {
+    IT("defers publishes over the rate limit and sends them from loop()");
+    startNetwork();
+    Ubidots ubidots(TOKEN, CLIENT_NAME);
+    ubidots.begin(callback);
+    ubidots.setRateLimit(1, 1);
+    IS_TRUE(connectClient(ubidots));
+    network.sent.clear();
+
+    ubidots.add("temperatura", 21.5);
+    IS_TRUE(ubidots.ubidotsPublish("esp32"));
+    std::string first = network.sent;
+
+    network.sent.clear();
+    ubidots.add("temperatura", 22);
+    ubidots.ubidotsPublish("esp32");
+    IS_TRUE(network.sent.empty());
+    IS_EQUAL(ubidots.queued(), 1);
+    IS_EQUAL(ubidots.deferrals(), 1);
+
+    hostMillis += 1000;
+    ubidots.loop();
+    IS_EQUAL(ubidots.queued(), 0);
+    IS_TRUE(network.sent == publishPacket("/v1.6/devices/esp32",
+                                          "{\"temperatura\": [{\"value\": 22.00}]}"));
+
+    END_IT
+}
+
+int test_client_keep_on_drop() {
+    IT("keeps unsent values queued when the connection drops, without spending tokens");
+    startNetwork();
+    Ubidots ubidots(TOKEN, CLIENT_NAME);
+    ubidots.begin(callback);
+    ubidots.setRateLimit(1, 1);
+    IS_TRUE(connectClient(ubidots));
+
+    network.drop();
+    ubidots.add("temperatura", 21.5);
+    IS_FALSE(ubidots.ubidotsPublish("esp32"));
+    IS_EQUAL(ubidots.queued(), 1);
+    IS_EQUAL(ubidots.dropped(), 0);
+
+    // Al reconectar sale de inmediato: el intento sin conexión no gastó el token
+    network.sent.clear();
+    ubidots.loop();
+    IS_TRUE(connectClient(ubidots));
+    IS_EQUAL(ubidots.queued(), 0);
+    IS_TRUE(network.sent.find(publishPacket("/v1.6/devices/esp32",
+        "{\"temperatura\": [{\"value\": 21.50}]}")) != std::string::npos);
+
+    END_IT
+}
+
+int test_client_null_device() {
+    IT("skips values without device when per-device limits are registered");
+    startNetwork();
+    Ubidots ubidots(TOKEN, CLIENT_NAME);
+    ubidots.begin(callback);
+    RateLimit sala("sala");
+    sala.setRate(1).setBurst(1);
+    ubidots.addRateLimit(&sala);
+    PublishPolicy policy("temperatura");
+    ubidots.addPolicy(&policy);
+    IS_TRUE(connectClient(ubidots));
+    network.sent.clear();
+
+    ubidots.add((const char*)NULL, 1);
+    ubidots.add("humedad", 60);
+    ubidots.setDevice("sala");
+    ubidots.add("temperatura", 21.5);
+    IS_FALSE(ubidots.ubidotsPublish(NULL));
+    IS_EQUAL(ubidots.queued(), 0);
+    IS_TRUE(network.sent == publishPacket("/v1.6/devices/sala",
+                                          "{\"temperatura\": [{\"value\": 21.50}]}"));
+
+    END_IT
+}
+
+int test_client_packed_device() {
+    IT("keeps deferred values added by id on their own device");
+    startNetwork();
+    Ubidots ubidots(TOKEN, CLIENT_NAME);
+    ubidots.begin(callback);
+    ubidots.setRateLimit(1, 1);
+    IS_TRUE(connectClient(ubidots));
+    uint8_t temperatura = ubidots.addLabel("temperatura");
+    uint8_t humedad = ubidots.addLabel("humedad");
+
+    ubidots.add("distancia", 1);
+    IS_TRUE(ubidots.ubidotsPublish("sala"));
+
+    // Sin token, el lote de "bodega" espera; luego se publica a "patio", con otro por setDevice()
+    ubidots.add(temperatura, 21.5);
+    ubidots.ubidotsPublish("bodega");
+    ubidots.add(humedad, 60);
+    ubidots.setDevice("invernadero");
+    ubidots.add(humedad, 80);
+    ubidots.ubidotsPublish("patio");
+
+    network.sent.clear();
+    for (int i = 0; i < 3; i++) {
+        hostMillis += 1000;
+        ubidots.loop();
+    }
+    IS_TRUE(network.sent == publishPacket("/v1.6/devices/bodega",
+                                          "{\"temperatura\": [{\"value\": 21.50}]}") +
+                            publishPacket("/v1.6/devices/patio",
+                                          "{\"humedad\": [{\"value\": 60.00}]}") +
+                            publishPacket("/v1.6/devices/invernadero",
+                                          "{\"humedad\": [{\"value\": 80.00}]}"));
+
+    END_IT
+}
+
+int test_client_series_device() {
+    IT("keeps a deferred series on the device it was published to");
+    startNetwork();
+    Ubidots ubidots(TOKEN, CLIENT_NAME);
+    ubidots.begin(callback);
+    ubidots.setRateLimit(1, 1);
+    IS_TRUE(connectClient(ubidots));
+    SampleSeries series("nivel", 4);
+    ubidots.addSeries(&series);
+
+    ubidots.add("distancia", 1);
+    IS_TRUE(ubidots.ubidotsPublish("sala"));
+
+    // Sin token, la serie espera; publicar otro dispositivo no la cambia de destino
+    series.record(3, T0);
+    ubidots.ubidotsPublish("bodega");
+    ubidots.add("distancia", 2);
+    ubidots.ubidotsPublish("patio");
+
+    network.sent.clear();
+    hostMillis += 1000;
+    ubidots.loop();
+    hostMillis += 1000;
+    ubidots.loop();
+    IS_EQUAL(ubidots.queued(), 0);
+    IS_EQUAL(series.count(), 0);
+    IS_TRUE(network.sent == publishPacket("/v1.6/devices/patio",
+                                          "{\"distancia\": [{\"value\": 2.00}]}") +
+                            publishPacket("/v1.6/devices/bodega",
+                                          "{\"nivel\": [{\"value\": 3.00, \"timestamp\": 1600000000000}]}"));
+
+    END_IT
+}
+
+int test_client_context_reuse() {
+    IT("frees the context of sent values while others wait for the rate limit");
+    startNetwork();
+    Ubidots ubidots(TOKEN, CLIENT_NAME);
+    ubidots.begin(callback);
+    ubidots.setRateLimit(1, 1);
+    IS_TRUE(connectClient(ubidots));
+
+    Sampler sampler("distancia", NULL, 0, 4);
+    sampler.record(10);
+    sampler.record(20);
+
+    // Dos resúmenes de 4 entradas, a dispositivos distintos: cada uno necesita su token
+    ubidots.add("distancia", 1);
+    IS_TRUE(ubidots.ubidotsPublish("sala"));
+    ubidots.add(sampler.aggregate());
+    ubidots.ubidotsPublish("bodega");
+    ubidots.add(sampler.aggregate());
+    ubidots.ubidotsPublish("patio");
+    IS_EQUAL(ubidots.queued(), 2);
+
+    // Al enviar el de "bodega", sus entradas quedan libres para un tercer resumen
+    hostMillis += 1000;
+    ubidots.loop();
+    IS_EQUAL(ubidots.queued(), 1);
+    ubidots.add(sampler.aggregate());
+    IS_TRUE(ubidots.addContext("extra", 1.0f));
+    ubidots.ubidotsPublish("sala");
+
+    network.sent.clear();
+    hostMillis += 1000;
+    ubidots.loop();
+    hostMillis += 1000;
+    ubidots.loop();
+    IS_EQUAL(ubidots.queued(), 0);
+
+    const char* context = "{\"distancia\": [{\"value\": 15.00, \"context\": "
+        "{\"min\": 10.00, \"max\": 20.00, \"sd\": 7.07, \"n\": 2";
+    IS_TRUE(network.sent == publishPacket("/v1.6/devices/patio",
+                                          (std::string(context) + "}}]}").c_str()) +
+                            publishPacket("/v1.6/devices/sala",
+                                          (std::string(context) + ", \"extra\": 1.00}}]}").c_str()));
+
+    END_IT
+}
+
+int test_client_context_capacity() {
+    IT("sizes the context buffer from the value capacity or the given number of entries");
+    startNetwork();
+    Ubidots small(TOKEN, CLIENT_NAME, 1);
+    small.add("gps", 0);
+    for (int i = 0; i < CONTEXT_ENTRIES_PER_VALUE; i++) {
+        IS_TRUE(small.addContext("lat", -33.02f, 6));
+    }
+    IS_FALSE(small.addContext("alt", 12.0f));
+
+    Ubidots sized(TOKEN, CLIENT_NAME, 1, 3);
+    sized.add("gps", 0);
+    IS_TRUE(sized.addContext("lat", -33.02f, 6));
+    IS_TRUE(sized.addContext("lng", -71.54f, 6));
+    IS_TRUE(sized.addContext("alt", 12.0f));
+    IS_FALSE(sized.addContext("fix", "3d"));
+
+    END_IT
+}
+
+int test_client_aggregate_full() {
+    IT("drops a whole aggregate when its context does not fit");
+    startNetwork();
+    Ubidots ubidots(TOKEN, CLIENT_NAME, 3, AGGREGATE_CONTEXT_ENTRIES + 2);
+    ubidots.begin(callback);
+    IS_TRUE(connectClient(ubidots));
+
+    Sampler sampler("distancia", NULL, 0, 4);
+    sampler.record(10);
+
+    IS_TRUE(ubidots.add(sampler.aggregate()));
+    IS_FALSE(ubidots.add(sampler.aggregate()));
+    IS_FALSE(ubidots.addContext("extra", 1.0f));
+    IS_EQUAL(ubidots.dropped(), 1);
+
+    network.sent.clear();
+    IS_TRUE(ubidots.ubidotsPublish("esp32"));
+    IS_TRUE(network.sent == publishPacket("/v1.6/devices/esp32",
+        "{\"distancia\": [{\"value\": 10.00, \"context\": "
+        "{\"min\": 10.00, \"max\": 10.00, \"sd\": 0.00, \"n\": 1}}]}"));
+
+    END_IT
+}
+
+int test_client_journal() {
+    IT("stores values in the journal while offline and replays them once connected");
+    startNetwork();
+    WiFi.setStatus(WL_DISCONNECTED);
+    FileJournalStorage storage(JOURNAL_PATH);
+    storage.erase(0);
+    storage.erase(1);
+    UbidotsJournal journal(storage, LABELS, 2, 32);
+    IS_TRUE(journal.begin());
+
+    Ubidots ubidots(TOKEN, CLIENT_NAME);
+    ubidots.begin(callback);
+    ubidots.setJournal(&journal, "esp32");
+
+    ubidots.add("temperatura", 21.5, NULL, T0);
+    ubidots.add("humedad", 60, NULL, T0 + 1);
+    IS_TRUE(ubidots.ubidotsPublish("esp32"));
+    IS_EQUAL(journal.pending(), 2);
+    IS_EQUAL(ubidots.queued(), 0);
+    IS_TRUE(network.sent.empty());
+
+    WiFi.setStatus(WL_CONNECTED);
+    IS_TRUE(connectClient(ubidots));
+    ubidots.loop();
+
+    IS_EQUAL(journal.pending(), 0);
+    IS_TRUE(network.sent.find(publishPacket("/v1.6/devices/esp32",
+        "{\"temperatura\": [{\"value\": 21.50, \"timestamp\": 1600000000000}], "
+        "\"humedad\": [{\"value\": 60.00, \"timestamp\": 1600000001000}]}")) != std::string::npos);
+
+    END_IT
+}
+
+int main()
+{
+    SUITE("Client");
+    test_client_connect();
+    test_client_connect_backoff();
+    test_client_connect_timeout();
+    test_client_publish();
+    test_client_publish_packed();
+    test_client_publish_aggregate();
+    test_client_publish_split();
+    test_client_subscribe();
+    test_client_dispatch();
+    test_client_rate_limit();
+    test_client_keep_on_drop();
+    test_client_null_device();
+    test_client_packed_device();
+    test_client_series_device();
+    test_client_context_reuse();
+    test_client_context_capacity();
+    test_client_aggregate_full();
+    test_client_journal();
+
+    FINISH
+}
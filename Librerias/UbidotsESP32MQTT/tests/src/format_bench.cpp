@@ -0,0 +1,73 @@
+#include "UbidotsFormat.h"
+#include <chrono>
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define VERIFY_ITERATIONS 10000000
+#define ITERATIONS 5000000
+
+// Valores aleatorios: la mitad en rangos típicos de telemetría, la otra mitad cualquier float finito
+float randomValue() {
+    if (rand() & 1) {
+        return ((float)rand() / RAND_MAX - 0.5f) * 20000.0f;
+    }
+
+    uint32_t bits = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+int main()
+{
+    char expected[64];
+    char text[FORMAT_FIXED_SIZE];
+    long fallback = 0;
+
+    // Verificación contra snprintf
+    srand(1);
+    for (long i = 0; i < VERIFY_ITERATIONS; i++) {
+        float value = randomValue();
+        uint8_t decimals = rand() % (FORMAT_MAX_DECIMALS + 1);
+        size_t n = ubidotsFormatFixed(value, decimals, text);
+
+        if (n == 0) {
+            fallback++;
+            continue;
+        }
+
+        int m = snprintf(expected, sizeof(expected), "%.*f", decimals, value);
+        if (n != (size_t)m || memcmp(text, expected, n) != 0) {
+            std::cout << "Mismatch for " << expected << " (" << (int)decimals << " decimals)\n";
+            return 1;
+        }
+    }
+    std::cout << VERIFY_ITERATIONS << " random values match snprintf ("
+              << fallback << " left to snprintf)\n";
+
+    // Velocidad con 2 decimales, como en el payload
+    float values[1024];
+    for (int i = 0; i < 1024; i++) {
+        values[i] = ((float)rand() / RAND_MAX - 0.5f) * 20000.0f;
+    }
+
+    size_t total = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (long i = 0; i < ITERATIONS; i++) {
+        total += snprintf(text, sizeof(text), "%.*f", 2, values[i & 1023]);
+    }
+    std::chrono::steady_clock::time_point middle = std::chrono::steady_clock::now();
+    for (long i = 0; i < ITERATIONS; i++) {
+        total += ubidotsFormatFixed(values[i & 1023], 2, text);
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    double before = std::chrono::duration<double, std::nano>(middle - start).count() / ITERATIONS;
+    double after = std::chrono::duration<double, std::nano>(end - middle).count() / ITERATIONS;
+    std::cout << "%.2f: snprintf " << before << " ns, ubidotsFormatFixed " << after
+              << " ns (x" << before / after << ", " << total << " bytes)\n";
+
+    return 0;
+}
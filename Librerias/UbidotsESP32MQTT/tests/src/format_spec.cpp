@@ -0,0 +1,94 @@
+#include "UbidotsFormat.h"
+#include "BDDTest.h"
+#include "trace.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DIFF_ITERATIONS 1000000
+
+// Compara con snprintf; si difieren, muestra ambos textos
+bool matches(float value, uint8_t decimals) {
+    char expected[64];
+    char text[FORMAT_FIXED_SIZE];
+    int n = snprintf(expected, sizeof(expected), "%.*f", decimals, value);
+    size_t length = ubidotsFormatFixed(value, decimals, text);
+
+    if (length == (size_t)n && memcmp(text, expected, n) == 0) {
+        return true;
+    }
+
+    printf("  %.9g with %d decimals: \"%.*s\", expected \"%s\"\n", value, decimals,
+           (int)length, text, expected);
+    return false;
+}
+
+
+int test_format_values() {
+    IT("formats values like %.*f");
+    char text[FORMAT_FIXED_SIZE];
+
+    IS_EQUAL(ubidotsFormatFixed(21.5f, 2, text), 5);
+    IS_TRUE(memcmp(text, "21.50", 5) == 0);
+    IS_EQUAL(ubidotsFormatFixed(-3.0f, 0, text), 2);
+    IS_TRUE(memcmp(text, "-3", 2) == 0);
+
+    IS_TRUE(matches(0.0f, 2));
+    IS_TRUE(matches(-0.0f, 2));
+    IS_TRUE(matches(-0.001f, 2));
+    IS_TRUE(matches(0.005f, 2));
+    IS_TRUE(matches(0.125f, 2));
+    IS_TRUE(matches(0.375f, 2));
+    IS_TRUE(matches(2.5f, 0));
+    IS_TRUE(matches(3.5f, 0));
+    IS_TRUE(matches(99.995f, 2));
+    IS_TRUE(matches(-33.023034f, 6));
+    IS_TRUE(matches(4294967296.0f, 2));
+    IS_TRUE(matches(1e-45f, 9));
+    IS_TRUE(matches(123456789.0f, 9));
+
+    END_IT
+}
+
+int test_format_fallback() {
+    IT("leaves NaN, infinity and huge values to snprintf");
+    char text[FORMAT_FIXED_SIZE];
+
+    IS_EQUAL(ubidotsFormatFixed(NAN, 2, text), 0);
+    IS_EQUAL(ubidotsFormatFixed(INFINITY, 2, text), 0);
+    IS_EQUAL(ubidotsFormatFixed(3e38f, 2, text), 0);
+    IS_EQUAL(ubidotsFormatFixed(1.0f, FORMAT_MAX_DECIMALS + 1, text), 0);
+
+    END_IT
+}
+
+int test_format_matches_snprintf() {
+    IT("matches snprintf on random values");
+    bool ok = true;
+
+    srand(4321);
+    for (int i = 0; i < DIFF_ITERATIONS && ok; i++) {
+        uint8_t decimals = rand() % (FORMAT_MAX_DECIMALS + 1);
+        float value = ((float)rand() / RAND_MAX - 0.5f) * powf(10, rand() % 12 - 4);
+        char text[FORMAT_FIXED_SIZE];
+
+        if (ubidotsFormatFixed(value, decimals, text) > 0) {
+            ok = matches(value, decimals);
+        }
+    }
+    IS_TRUE(ok);
+
+    END_IT
+}
+
+
+int main()
+{
+    SUITE("Format");
+    test_format_values();
+    test_format_fallback();
+    test_format_matches_snprintf();
+
+    FINISH
+}
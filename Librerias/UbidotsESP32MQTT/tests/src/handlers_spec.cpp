@@ -0,0 +1,122 @@
+#include "UbidotsHandlers.h"
+#include "BDDTest.h"
+#include "trace.h"
+#include <string.h>
+
+int intCalls = 0;
+int32_t intValue = 0;
+int floatCalls = 0;
+float floatValue = 0;
+
+void onInt(int32_t value) {
+    intCalls++;
+    intValue = value;
+}
+
+void onFloat(float value) {
+    floatCalls++;
+    floatValue = value;
+}
+
+void reset() {
+    intCalls = 0;
+    intValue = 0;
+    floatCalls = 0;
+    floatValue = 0;
+}
+
+
+int test_handler_topic() {
+    IT("precomputes the full /lv topic");
+    HandlerRegistry registry;
+
+    VariableHandler* h = registry.add("esp32", "led_r", onInt);
+
+    IS_TRUE(h != NULL);
+    IS_TRUE(strcmp(h->_topic, "/v1.6/devices/esp32/led_r/lv") == 0);
+    IS_EQUAL(h->_length, strlen("/v1.6/devices/esp32/led_r/lv"));
+    IS_EQUAL(h->_hash, topicHash(h->_topic, h->_length));
+    IS_TRUE(registry.first() == h);
+
+    END_IT
+}
+
+int test_handler_dispatch() {
+    IT("routes each message to the handler of its topic");
+    reset();
+    HandlerRegistry registry;
+    registry.add("esp32", "led_r", onInt);
+    registry.add("esp32", "temp", onFloat);
+
+    IS_TRUE(registry.dispatch("/v1.6/devices/esp32/led_r/lv", (const uint8_t*)"255", 3));
+    IS_EQUAL(intCalls, 1);
+    IS_EQUAL(intValue, 255);
+    IS_EQUAL(floatCalls, 0);
+
+    IS_TRUE(registry.dispatch("/v1.6/devices/esp32/temp/lv", (const uint8_t*)"21.5", 4));
+    IS_EQUAL(floatCalls, 1);
+    IS_TRUE(floatValue == 21.5f);
+
+    END_IT
+}
+
+int test_handler_unknown_topic() {
+    IT("does not route messages of other topics");
+    reset();
+    HandlerRegistry registry;
+    registry.add("esp32", "led_r", onInt);
+
+    IS_FALSE(registry.dispatch("/v1.6/devices/esp32/led_g/lv", (const uint8_t*)"1", 1));
+    IS_FALSE(registry.dispatch("/v1.6/devices/esp32/led_r/lv/x", (const uint8_t*)"1", 1));
+    IS_EQUAL(intCalls, 0);
+
+    END_IT
+}
+
+int test_handler_registration() {
+    IT("keeps one registration per variable");
+    reset();
+    HandlerRegistry registry;
+
+    VariableHandler* plain = registry.add("esp32", "boton");
+    IS_TRUE(plain != NULL);
+    IS_FALSE(registry.dispatch("/v1.6/devices/esp32/boton/lv", (const uint8_t*)"1", 1));
+
+    IS_TRUE(registry.add("esp32", "boton", onInt) == plain);
+    IS_TRUE(registry.add("esp32", "boton") == plain);
+    IS_TRUE(registry.dispatch("/v1.6/devices/esp32/boton/lv", (const uint8_t*)"1", 1));
+    IS_EQUAL(intCalls, 1);
+
+    IS_TRUE(registry.first() == plain);
+    IS_TRUE(plain->_next == NULL);
+
+    END_IT
+}
+
+int test_handler_invalid_payload() {
+    IT("rejects payloads that are not numbers");
+    reset();
+    HandlerRegistry registry;
+    registry.add("esp32", "led_r", onInt);
+
+    IS_FALSE(registry.dispatch("/v1.6/devices/esp32/led_r/lv", (const uint8_t*)"25x", 3));
+    IS_FALSE(registry.dispatch("/v1.6/devices/esp32/led_r/lv", (const uint8_t*)"", 0));
+    IS_FALSE(registry.dispatch("/v1.6/devices/esp32/led_r/lv",
+        (const uint8_t*)"123456789012345678901234567890", 30));
+    IS_EQUAL(intCalls, 0);
+
+    END_IT
+}
+
+
+int main()
+{
+    SUITE("Handlers");
+    test_handler_topic();
+    test_handler_dispatch();
+    test_handler_unknown_topic();
+    test_handler_registration();
+    test_handler_invalid_payload();
+
+    FINISH
+}
@@ -0,0 +1,185 @@
+#include "UbidotsJournal.h"
+#include "BDDTest.h"
+#include "trace.h"
+#include <string.h>
+
+#define JOURNAL_PATH "bin/journal_spec"
+#define T0 1600000000
+
+static const char* const LABELS[] = { "temperatura", "humedad" };
+
+static void clearJournal(JournalStorage& storage) {
+    storage.erase(0);
+    storage.erase(1);
+}
+
+
+int test_journal_replay() {
+    IT("replays values in order with their timestamps");
+    FileJournalStorage storage(JOURNAL_PATH);
+    clearJournal(storage);
+    UbidotsJournal journal(storage, LABELS, 2, 32);
+    JournalEntry entries[4];
+
+    IS_TRUE(journal.begin());
+    IS_TRUE(journal.record("temperatura", 21.5, T0));
+    IS_TRUE(journal.record("humedad", 60, T0 + 1));
+    IS_TRUE(journal.record("temperatura", 22, T0 + 2));
+    IS_EQUAL(journal.pending(), 3);
+
+    IS_EQUAL(journal.peek(entries, 2), 2);
+    IS_TRUE(strcmp(entries[0]._variableLabel, "temperatura") == 0);
+    IS_TRUE(entries[0]._value == 21.5);
+    IS_EQUAL(entries[0]._timestamp, T0);
+    IS_TRUE(strcmp(entries[1]._variableLabel, "humedad") == 0);
+
+    journal.consume(2);
+    IS_EQUAL(journal.pending(), 1);
+    IS_EQUAL(journal.peek(entries, 4), 1);
+    IS_TRUE(entries[0]._value == 22);
+    IS_EQUAL(entries[0]._timestamp, T0 + 2);
+
+    END_IT
+}
+
+int test_journal_restart() {
+    IT("recovers pending values and the sent position after a restart");
+    FileJournalStorage storage(JOURNAL_PATH);
+    clearJournal(storage);
+    JournalEntry entries[4];
+
+    {
+        UbidotsJournal journal(storage, LABELS, 2, 32);
+        IS_TRUE(journal.begin());
+        for (int i = 0; i < 5; i++) {
+            IS_TRUE(journal.record("humedad", i, T0 + i));
+        }
+        journal.consume(2);
+    }
+
+    UbidotsJournal journal(storage, LABELS, 2, 32);
+    IS_TRUE(journal.begin());
+    IS_EQUAL(journal.pending(), 3);
+    IS_EQUAL(journal.peek(entries, 4), 3);
+    IS_TRUE(entries[0]._value == 2);
+    IS_TRUE(entries[2]._value == 4);
+
+    IS_TRUE(journal.record("humedad", 5, T0 + 5));
+    IS_EQUAL(journal.pending(), 4);
+
+    END_IT
+}
+
+int test_journal_rotate() {
+    IT("rotates segments when full and drops the oldest values");
+    FileJournalStorage storage(JOURNAL_PATH);
+    clearJournal(storage);
+    JournalEntry entries[8];
+
+    // Cada segmento: encabezado y 3 valores
+    UbidotsJournal journal(storage, LABELS, 2, 4);
+    IS_TRUE(journal.begin());
+    for (int i = 0; i < 8; i++) {
+        IS_TRUE(journal.record("temperatura", i, T0 + i));
+    }
+
+    IS_EQUAL(journal.dropped(), 3);
+    IS_EQUAL(journal.pending(), 5);
+    IS_EQUAL(journal.peek(entries, 8), 5);
+    IS_TRUE(entries[0]._value == 3);
+    IS_TRUE(entries[4]._value == 7);
+
+    // Lo enviado del segmento antiguo lo libera
+    journal.consume(3);
+    IS_EQUAL(journal.pending(), 2);
+    IS_EQUAL(journal.peek(entries, 8), 2);
+    IS_TRUE(entries[0]._value == 6);
+
+    UbidotsJournal restarted(storage, LABELS, 2, 4);
+    IS_TRUE(restarted.begin());
+    IS_EQUAL(restarted.pending(), 2);
+    IS_EQUAL(restarted.peek(entries, 8), 2);
+    IS_TRUE(entries[1]._value == 7);
+
+    END_IT
+}
+
+int test_journal_torn() {
+    IT("ignores a torn record and keeps the next ones aligned");
+    FileJournalStorage storage(JOURNAL_PATH);
+    clearJournal(storage);
+    JournalEntry entries[4];
+
+    {
+        UbidotsJournal journal(storage, LABELS, 2, 32);
+        IS_TRUE(journal.begin());
+        IS_TRUE(journal.record("temperatura", 1, T0));
+        IS_TRUE(journal.record("temperatura", 2, T0 + 1));
+    }
+
+    // Corte de energía a mitad de un registro
+    const uint8_t partial[5] = { 0x10, 0x20, 0x30, 0x40, 0x50 };
+    IS_TRUE(storage.append(0, partial, sizeof(partial)));
+
+    UbidotsJournal journal(storage, LABELS, 2, 32);
+    IS_TRUE(journal.begin());
+    IS_EQUAL(journal.pending(), 2);
+    IS_TRUE(journal.record("temperatura", 3, T0 + 2));
+    IS_EQUAL(storage.size(0) % JOURNAL_RECORD_SIZE, 0);
+
+    IS_EQUAL(journal.peek(entries, 4), 3);
+    IS_TRUE(entries[1]._value == 2);
+    IS_TRUE(entries[2]._value == 3);
+
+    END_IT
+}
+
+int test_journal_reject() {
+    IT("rejects unknown variables and unsynchronized clocks");
+    FileJournalStorage storage(JOURNAL_PATH);
+    clearJournal(storage);
+    UbidotsJournal journal(storage, LABELS, 2, 32);
+
+    IS_TRUE(journal.begin());
+    IS_FALSE(journal.record("presion", 1000, T0));
+    IS_FALSE(journal.record("humedad", 50, 120));
+    IS_EQUAL(journal.pending(), 0);
+    IS_EQUAL(storage.size(0), 0);
+
+    END_IT
+}
+
+int test_journal_erase() {
+    IT("erases its segments once everything is sent");
+    FileJournalStorage storage(JOURNAL_PATH);
+    clearJournal(storage);
+    UbidotsJournal journal(storage, LABELS, 2, 4);
+
+    IS_TRUE(journal.begin());
+    for (int i = 0; i < 5; i++) {
+        IS_TRUE(journal.record("humedad", i, T0 + i));
+    }
+    IS_TRUE(storage.size(1) > 0);
+
+    journal.consume(5);
+    IS_EQUAL(journal.pending(), 0);
+    IS_EQUAL(storage.size(0), 0);
+    IS_EQUAL(storage.size(1), 0);
+
+    END_IT
+}
+
+int main()
+{
+    SUITE("Journal");
+    test_journal_replay();
+    test_journal_restart();
+    test_journal_rotate();
+    test_journal_torn();
+    test_journal_reject();
+    test_journal_erase();
+
+    FileJournalStorage storage(JOURNAL_PATH);
+    clearJournal(storage);
+    FINISH
+}
@@ -0,0 +1,64 @@
+#include "UbidotsLabels.h"
+#include "BDDTest.h"
+#include "trace.h"
+#include <stdio.h>
+#include <string.h>
+
+
+int test_labels_ids() {
+    IT("returns one small id per variable");
+    LabelTable labels;
+
+    IS_EQUAL(labels.add("temperatura"), 0);
+    IS_EQUAL(labels.add("humedad"), 1);
+    IS_EQUAL(labels.add("temperatura"), 0);
+    IS_EQUAL(labels.count(), 2);
+    IS_EQUAL(labels.find("humedad"), 1);
+    IS_EQUAL(labels.find("presion"), LABEL_NONE);
+
+    // La tabla crece según se registran variables
+    char names[20][8];
+    for (int i = 0; i < 20; i++) {
+        snprintf(names[i], sizeof(names[i]), "var%d", i);
+        IS_EQUAL(labels.add(names[i]), i + 2);
+    }
+    IS_TRUE(strcmp(labels.label(21), "var19") == 0);
+
+    END_IT
+}
+
+int test_labels_fragment() {
+    IT("precomputes the escaped JSON fragment of each variable");
+    LabelTable labels;
+    uint8_t id = labels.add("sala \"1\"");
+
+    IS_TRUE(strcmp(labels.fragment(id), "\"sala \\\"1\\\"\": [{\"value\": ") == 0);
+    IS_EQUAL(labels.fragmentLength(id), strlen(labels.fragment(id)));
+
+    END_IT
+}
+
+int test_labels_copy() {
+    IT("keeps its own copy of each variable name");
+    LabelTable labels;
+    char name[16] = "temperatura";
+    uint8_t id = labels.add(name);
+
+    strcpy(name, "humedad");
+    IS_TRUE(strcmp(labels.label(id), "temperatura") == 0);
+    IS_EQUAL(labels.find("temperatura"), id);
+    IS_EQUAL(labels.add(NULL), LABEL_NONE);
+    IS_EQUAL(labels.find(NULL), LABEL_NONE);
+
+    END_IT
+}
+
+int main()
+{
+    SUITE("Labels");
+    test_labels_ids();
+    test_labels_fragment();
+    test_labels_copy();
+
+    FINISH
+}
@@ -0,0 +1,127 @@
+#include "WiFi.h"
+
+uint32_t hostMillis = 0;
+HostNetwork network;
+WiFiClass WiFi;
+SerialClass Serial;
+
+extern "C" {
+    uint32_t millis(void) {
+        return hostMillis;
+    }
+}
+
+void HostNetwork::reset() {
+    allowConnect = true;
+    open = false;
+    capture = true;
+    sent.clear();
+    pending.clear();
+    host.clear();
+    port = 0;
+    timeout = 0;
+    connects = 0;
+    writes = 0;
+    bytes = 0;
+}
+
+void HostNetwork::respond(const void* data, size_t length) {
+    pending.append((const char*)data, length);
+}
+
+void HostNetwork::drop() {
+    open = false;
+    pending.clear();
+}
+
+int WiFiClient::connect(IPAddress /* ip */, uint16_t port) {
+    return connect("", port);
+}
+
+int WiFiClient::connect(const char* host, uint16_t port) {
+    network.host = host;
+    network.port = port;
+
+    if (!network.allowConnect) {
+        return 0;
+    }
+
+    network.open = true;
+    network.connects++;
+    return 1;
+}
+
+int WiFiClient::connect(const char* host, uint16_t port, int32_t timeout) {
+    network.timeout = timeout;
+    return connect(host, port);
+}
+
+size_t WiFiClient::write(uint8_t b) {
+    return write(&b, 1);
+}
+
+size_t WiFiClient::write(const uint8_t* buffer, size_t size) {
+    if (!network.open) {
+        return 0;
+    }
+
+    network.writes++;
+    network.bytes += size;
+    if (network.capture) {
+        network.sent.append((const char*)buffer, size);
+    }
+    return size;
+}
+
+int WiFiClient::available() {
+    if (network.pending.empty()) {
+        // Sin datos, el cliente está esperando: el tiempo avanza, y las esperas de PubSubClient
+        // terminan por timeout en vez de bloquear la prueba
+        hostMillis++;
+        return 0;
+    }
+
+    return network.pending.size();
+}
+
+int WiFiClient::read() {
+    if (network.pending.empty()) {
+        return -1;
+    }
+
+    uint8_t b = network.pending[0];
+    network.pending.erase(0, 1);
+    return b;
+}
+
+int WiFiClient::read(uint8_t* buffer, size_t size) {
+    size_t n = (size < network.pending.size()) ? size : network.pending.size();
+
+    network.pending.copy((char*)buffer, n);
+    network.pending.erase(0, n);
+    return n;
+}
+
+int WiFiClient::peek() {
+    return network.pending.empty() ? -1 : (uint8_t)network.pending[0];
+}
+
+void WiFiClient::flush() {}
+
+void WiFiClient::stop() {
+    network.open = false;
+}
+
+uint8_t WiFiClient::connected() {
+    return network.open;
+}
+
+WiFiClient::operator bool() {
+    return network.open;
+}
+
+uint8_t* WiFiClass::macAddress(uint8_t* mac) {
+    const uint8_t address[6] = { 0x24, 0x0A, 0xC4, 0x01, 0x02, 0x03 };
+    memcpy(mac, address, sizeof(address));
+    return mac;
+}
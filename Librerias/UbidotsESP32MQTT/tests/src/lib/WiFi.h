@@ -0,0 +1,90 @@
+#ifndef wifi_h
+#define wifi_h
+
+// Reemplazos de WiFi, WiFiClient, Serial y millis() para compilar el cliente de Ubidots en Linux,
+// sobre los archivos de prueba de PubSubClient (Arduino.h, Client.h)
+
+#include "Arduino.h"
+#include "Client.h"
+#include <string>
+
+#define WL_CONNECTED      3
+#define WL_DISCONNECTED   6
+
+// Reloj de las pruebas: millis() devuelve este valor
+extern uint32_t hostMillis;
+
+// Lado servidor de la red simulada, compartido por todos los WiFiClient
+struct HostNetwork {
+    bool allowConnect;      // Aceptar conexiones TCP
+    bool open;              // Hay una conexión TCP abierta
+    bool capture;           // Guardar los bytes escritos en sent
+    std::string sent;       // Bytes escritos por el cliente
+    std::string pending;    // Bytes que el servidor aún no entrega al cliente
+    std::string host;       // Último servidor al que se conectó
+    uint16_t port;
+    int32_t timeout;        // Tiempo máximo pedido para la última conexión TCP, en ms
+    uint32_t connects;      // Conexiones TCP abiertas
+    uint32_t writes;        // Llamadas a write()
+    size_t bytes;           // Total de bytes escritos (aunque no se guarden)
+
+    HostNetwork() { reset(); }
+    void reset();
+    void respond(const void* data, size_t length);
+    void drop();            // El servidor cierra la conexión
+};
+
+extern HostNetwork network;
+
+class WiFiClient : public Client {
+public:
+    virtual int connect(IPAddress ip, uint16_t port);
+    virtual int connect(const char* host, uint16_t port);
+    int connect(const char* host, uint16_t port, int32_t timeout);
+    virtual size_t write(uint8_t b);
+    virtual size_t write(const uint8_t* buffer, size_t size);
+    virtual int available();
+    virtual int read();
+    virtual int read(uint8_t* buffer, size_t size);
+    virtual int peek();
+    virtual void flush();
+    virtual void stop();
+    virtual uint8_t connected();
+    virtual operator bool();
+};
+
+class WiFiClass {
+public:
+    WiFiClass() : _status(WL_DISCONNECTED) {}
+    int begin(const char* /* ssid */, const char* /* pass */) { return _status; }
+    uint8_t* macAddress(uint8_t* mac);
+    int status() { return _status; }
+    void setStatus(int status) { _status = status; }
+
+private:
+    int _status;
+};
+
+extern WiFiClass WiFi;
+
+// Serial guarda lo impreso en output
+class SerialClass : public Print {
+public:
+    std::string output;
+
+    virtual size_t write(uint8_t c) { output += (char)c; return 1; }
+    void begin(unsigned long /* baud */) {}
+    void print(const char* text) { output += text; }
+    void print(char c) { output += c; }
+    void print(int value) { output += std::to_string(value); }
+    void print(unsigned int value) { output += std::to_string(value); }
+    void print(long value) { output += std::to_string(value); }
+    void print(unsigned long value) { output += std::to_string(value); }
+    void print(double value) { output += std::to_string(value); }
+    void println() { output += "\r\n"; }
+    template<typename T> void println(T value) { print(value); println(); }
+};
+
+extern SerialClass Serial;
+
+#endif
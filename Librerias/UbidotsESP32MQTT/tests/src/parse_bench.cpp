@@ -0,0 +1,72 @@
+#include "UbidotsParse.h"
+#include <chrono>
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+
+#define ITERATIONS 1000000
+
+const char* payloads[] = { "255", "21.50", "-3", "1023.75", "0", "4095", "55.25", "1.5e3" };
+#define PAYLOADS (sizeof(payloads) / sizeof(payloads[0]))
+
+template <typename F>
+double measure(F parse, double* checksum) {
+    size_t lengths[PAYLOADS];
+    for (size_t p = 0; p < PAYLOADS; p++) {
+        lengths[p] = strlen(payloads[p]);
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (long i = 0; i < ITERATIONS; i++) {
+        size_t p = i % PAYLOADS;
+        *checksum += parse((const uint8_t*)payloads[p], lengths[p]);
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count() / ITERATIONS;
+}
+
+// Lo que hacía el despacho antes: copiar a un buffer terminado en '\0' y usar strtod
+float copyAndStrtod(const uint8_t* payload, size_t length) {
+    char text[24];
+    memcpy(text, payload, length);
+    text[length] = '\0';
+    return strtod(text, NULL);
+}
+
+float inPlaceFloat(const uint8_t* payload, size_t length) {
+    float value = 0;
+    ubidotsParseFloat(payload, length, &value);
+    return value;
+}
+
+long copyAndStrtol(const uint8_t* payload, size_t length) {
+    char text[24];
+    memcpy(text, payload, length);
+    text[length] = '\0';
+    return strtol(text, NULL, 10);
+}
+
+long inPlaceInt(const uint8_t* payload, size_t length) {
+    int32_t value = 0;
+    ubidotsParseInt(payload, length, &value);
+    return value;
+}
+
+int main()
+{
+    double checksum = 0;
+
+    double before = measure(copyAndStrtod, &checksum);
+    double after = measure(inPlaceFloat, &checksum);
+    std::cout << "float: copy + strtod " << before << " ns, ubidotsParseFloat " << after
+              << " ns (x" << before / after << ")\n";
+
+    before = measure(copyAndStrtol, &checksum);
+    after = measure(inPlaceInt, &checksum);
+    std::cout << "int:   copy + strtol " << before << " ns, ubidotsParseInt " << after
+              << " ns (x" << before / after << ")\n";
+
+    std::cout << "(checksum " << checksum << ")\n";
+    return 0;
+}
@@ -0,0 +1,181 @@
+#include "UbidotsParse.h"
+#include "BDDTest.h"
+#include "trace.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DIFF_ITERATIONS 100000
+
+bool parseInt(const char* text, int32_t* value) {
+    return ubidotsParseInt((const uint8_t*)text, strlen(text), value);
+}
+
+bool parseFixed(const char* text, uint8_t decimals, int32_t* value) {
+    return ubidotsParseFixed((const uint8_t*)text, strlen(text), decimals, value);
+}
+
+bool parseFloat(const char* text, float* value) {
+    return ubidotsParseFloat((const uint8_t*)text, strlen(text), value);
+}
+
+bool closeTo(float a, float b) {
+    return fabsf(a - b) <= fabsf(b) * 1e-6f;
+}
+
+
+int test_parse_int() {
+    IT("parses integers, truncating the fraction");
+    int32_t value = 0;
+
+    IS_TRUE(parseInt("255", &value));
+    IS_EQUAL(value, 255);
+    IS_TRUE(parseInt("-3", &value));
+    IS_EQUAL(value, -3);
+    IS_TRUE(parseInt("+7", &value));
+    IS_EQUAL(value, 7);
+    IS_TRUE(parseInt("255.0", &value));
+    IS_EQUAL(value, 255);
+    IS_TRUE(parseInt("-1.9", &value));
+    IS_EQUAL(value, -1);
+    IS_TRUE(parseInt("2147483647", &value));
+    IS_EQUAL(value, 2147483647);
+    IS_TRUE(parseInt("-2147483648", &value));
+    IS_TRUE(value == INT32_MIN);
+    IS_TRUE(parseInt("0000000000000000000000042", &value));
+    IS_EQUAL(value, 42);
+
+    END_IT
+}
+
+int test_parse_int_invalid() {
+    IT("rejects malformed or out of range integers without touching the result");
+    int32_t value = 99;
+
+    IS_FALSE(parseInt("", &value));
+    IS_FALSE(parseInt("-", &value));
+    IS_FALSE(parseInt(".", &value));
+    IS_FALSE(parseInt("25x", &value));
+    IS_FALSE(parseInt(" 25", &value));
+    IS_FALSE(parseInt("1.2.3", &value));
+    IS_FALSE(parseInt("1e3", &value));
+    IS_FALSE(parseInt("2147483648", &value));
+    IS_FALSE(parseInt("-2147483649", &value));
+    IS_FALSE(parseInt("123456789012345678901234567890", &value));
+    IS_EQUAL(value, 99);
+
+    END_IT
+}
+
+int test_parse_no_terminator() {
+    IT("parses only the given span, without a terminator");
+    const uint8_t payload[] = { '1', '2', '3', '4', '5' };
+    int32_t value = 0;
+    float decimal = 0;
+
+    IS_TRUE(ubidotsParseInt(payload, 3, &value));
+    IS_EQUAL(value, 123);
+    IS_TRUE(ubidotsParseFloat(payload + 3, 2, &decimal));
+    IS_TRUE(decimal == 45.0f);
+
+    END_IT
+}
+
+int test_parse_fixed() {
+    IT("parses fixed point values, rounding the last decimal");
+    int32_t value = 0;
+
+    IS_TRUE(parseFixed("21.57", 1, &value));
+    IS_EQUAL(value, 216);
+    IS_TRUE(parseFixed("21.54", 1, &value));
+    IS_EQUAL(value, 215);
+    IS_TRUE(parseFixed("-21.55", 1, &value));
+    IS_EQUAL(value, -216);
+    IS_TRUE(parseFixed("3", 2, &value));
+    IS_EQUAL(value, 300);
+    IS_TRUE(parseFixed("0.001", 3, &value));
+    IS_EQUAL(value, 1);
+    IS_FALSE(parseFixed("1", 10, &value));
+    IS_FALSE(parseFixed("3000000", 3, &value));
+
+    END_IT
+}
+
+int test_parse_float() {
+    IT("parses decimals and exponents");
+    float value = 0;
+
+    IS_TRUE(parseFloat("21.5", &value));
+    IS_TRUE(value == 21.5f);
+    IS_TRUE(parseFloat("-0.25", &value));
+    IS_TRUE(value == -0.25f);
+    IS_TRUE(parseFloat(".5", &value));
+    IS_TRUE(value == 0.5f);
+    IS_TRUE(parseFloat("5.", &value));
+    IS_TRUE(value == 5.0f);
+    IS_TRUE(parseFloat("1.5e3", &value));
+    IS_TRUE(value == 1500.0f);
+    IS_TRUE(parseFloat("25E-2", &value));
+    IS_TRUE(value == 0.25f);
+    IS_TRUE(parseFloat("1e-60", &value));
+    IS_TRUE(value == 0.0f);
+    IS_TRUE(parseFloat("0e999", &value));
+    IS_TRUE(value == 0.0f);
+
+    value = 99;
+    IS_FALSE(parseFloat("1e", &value));
+    IS_FALSE(parseFloat("1e+", &value));
+    IS_FALSE(parseFloat("e5", &value));
+    IS_FALSE(parseFloat("1e39", &value));
+    IS_FALSE(parseFloat("nan", &value));
+    IS_FALSE(parseFloat("21.5 ", &value));
+    IS_TRUE(value == 99.0f);
+
+    END_IT
+}
+
+int test_parse_matches_libc() {
+    IT("matches strtol and strtof on random numbers");
+    char text[32];
+    bool ok = true;
+
+    srand(1234);
+    for (int i = 0; i < DIFF_ITERATIONS && ok; i++) {
+        long integer = (long)(rand() % 2000001) - 1000000;
+        int decimals = rand() % 5;
+        int32_t value;
+        float decimal;
+
+        snprintf(text, sizeof(text), "%ld", integer);
+        ok = parseInt(text, &value) && value == integer;
+
+        float f = ((float)rand() / RAND_MAX - 0.5f) * 20000.0f;
+        snprintf(text, sizeof(text), "%.*f", decimals, f);
+        ok = ok && parseFloat(text, &decimal) && closeTo(decimal, strtof(text, NULL));
+
+        snprintf(text, sizeof(text), "%.4e", f);
+        ok = ok && parseFloat(text, &decimal) && closeTo(decimal, strtof(text, NULL));
+    }
+
+    if (!ok) {
+        printf("  failed on \"%s\"\n", text);
+    }
+    IS_TRUE(ok);
+
+    END_IT
+}
+
+
+int main()
+{
+    SUITE("Parse");
+    test_parse_int();
+    test_parse_int_invalid();
+    test_parse_no_terminator();
+    test_parse_fixed();
+    test_parse_float();
+    test_parse_matches_libc();
+
+    FINISH
+}
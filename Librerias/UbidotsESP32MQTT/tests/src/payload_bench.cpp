@@ -0,0 +1,66 @@
+#include "UbidotsStore.h"
+#include <chrono>
+#include <iostream>
+
+#define ITERATIONS 1000000
+
+// Valor sin contexto con tipo; el resto de los campos queda en cero
+static Value makeValue(const char* label, float number, char* context, uint32_t timestamp) {
+    Value v = {};
+    v._variableLabel = label;
+    v._value = number;
+    v._context = context;
+    v._timestamp = timestamp;
+    return v;
+}
+
+int main()
+{
+    char buffer[500];
+    Value values[] = {
+        makeValue("temperatura", 21.5f, NULL, 0),
+        makeValue("humedad", 55.25f, NULL, 0),
+        makeValue("distancia", 123.0f, NULL, 1600000000),
+        makeValue("pot", 4095.0f, NULL, 0),
+        makeValue("boton", 1.0f, NULL, 0),
+    };
+    size_t total = 0;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (long i = 0; i < ITERATIONS; i++) {
+        values[0]._value = (float)(i % 1000) / 10;
+        PayloadBuffer writer(buffer, sizeof(buffer));
+        total += buildPayload(values, 5, writer);
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    double ns = std::chrono::duration<double, std::nano>(end - start).count() / ITERATIONS;
+    std::cout << "buildPayload, 5 values: " << ns << " ns/payload ("
+              << total / ITERATIONS << " bytes)\n";
+
+    // Los mismos valores agregados por id, en el store del cliente: fragmentos precalculados
+    LabelTable labels;
+    ValueStore store;
+
+    store.begin(5, 0);
+    for (int i = 0; i < 5; i++) {
+        ValueDetail detail = {};
+        detail._timestamp = values[i]._timestamp;
+        store.add(labels.add(values[i]._variableLabel), values[i]._value, NULL,
+                  values[i]._timestamp != 0 ? &detail : NULL);
+    }
+
+    total = 0;
+    start = std::chrono::steady_clock::now();
+    for (long i = 0; i < ITERATIONS; i++) {
+        PayloadBuffer writer(buffer, sizeof(buffer));
+        total += buildStorePayload(store, labels, 0, 5, DEVICE_NONE, 5, writer);
+    }
+    end = std::chrono::steady_clock::now();
+
+    ns = std::chrono::duration<double, std::nano>(end - start).count() / ITERATIONS;
+    std::cout << "buildStorePayload, 5 values: " << ns << " ns/payload ("
+              << total / ITERATIONS << " bytes)\n";
+
+    return 0;
+}
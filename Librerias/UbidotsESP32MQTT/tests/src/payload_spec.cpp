@@ -0,0 +1,282 @@
+#include "UbidotsPayload.h"
+#include "UbidotsFormat.h"
+#include "BDDTest.h"
+#include "trace.h"
+#include <string.h>
+#include <string>
+
+// Valor sin contexto con tipo; el resto de los campos queda en cero
+static Value makeValue(const char* label, float number, char* context, uint32_t timestamp) {
+    Value v = {};
+    v._variableLabel = label;
+    v._value = number;
+    v._context = context;
+    v._timestamp = timestamp;
+    return v;
+}
+
+// Salida Print que registra lo recibido y la cantidad de escrituras
+class CapturePrint : public Print {
+public:
+    std::string data;
+    int writes;
+    CapturePrint() : writes(0) {}
+    virtual size_t write(uint8_t b) {
+        data += (char)b;
+        writes++;
+        return 1;
+    }
+    virtual size_t write(const uint8_t *buffer, size_t size) {
+        data.append((const char*)buffer, size);
+        writes++;
+        return size;
+    }
+};
+
+int test_payload_single_value() {
+    IT("builds a single value payload");
+    char buffer[500];
+    PayloadBuffer writer(buffer, sizeof(buffer));
+    Value values[] = { makeValue("temp", 21.5f, NULL, 0) };
+
+    size_t length = buildPayload(values, 1, writer);
+
+    const char* expected = "{\"temp\": [{\"value\": 21.50}]}";
+    IS_EQUAL(length, strlen(expected));
+    IS_TRUE(memcmp(buffer, expected, length + 1) == 0);
+
+    END_IT
+}
+
+int test_payload_multiple_values() {
+    IT("builds a payload with timestamp and context");
+    char buffer[500];
+    PayloadBuffer writer(buffer, sizeof(buffer));
+    char context[] = "\"lat\": -33.02, \"lng\": -71.54";
+    Value values[] = {
+        makeValue("a", 1.0f, NULL, 0),
+        makeValue("b", -2.256f, NULL, 1600000000),
+        makeValue("gps", 0.0f, context, 0),
+    };
+
+    size_t length = buildPayload(values, 3, writer);
+
+    const char* expected = "{\"a\": [{\"value\": 1.00}], "
+        "\"b\": [{\"value\": -2.26, \"timestamp\": 1600000000000}], "
+        "\"gps\": [{\"value\": 0.00, \"context\": {\"lat\": -33.02, \"lng\": -71.54}}]}";
+    IS_EQUAL(length, strlen(expected));
+    IS_TRUE(memcmp(buffer, expected, length + 1) == 0);
+
+    END_IT
+}
+
+int test_payload_typed_context() {
+    IT("builds typed context entries after the raw context");
+    char buffer[500];
+    PayloadBuffer writer(buffer, sizeof(buffer));
+    char context[] = "\"fix\": 3";
+    ContextEntry entries[3];
+    entries[0]._key = "lat";
+    entries[0]._type = CONTEXT_NUMBER;
+    entries[0]._decimals = 6;
+    entries[0]._number = -33.023034f;
+    entries[1]._key = "lng";
+    entries[1]._type = CONTEXT_NUMBER;
+    entries[1]._decimals = 1;
+    entries[1]._number = -71.5464f;
+    entries[2]._key = "name";
+    entries[2]._type = CONTEXT_TEXT;
+    entries[2]._text = "Sala \"A\"";
+    Value values[] = {
+        { "gps", 0.0f, NULL, 0, entries, 2 },
+        { "room", 1.0f, context, 0, entries + 2, 1 },
+    };
+
+    size_t length = buildPayload(values, 2, writer);
+
+    const char* expected =
+        "{\"gps\": [{\"value\": 0.00, \"context\": {\"lat\": -33.023033, \"lng\": -71.5}}], "
+        "\"room\": [{\"value\": 1.00, \"context\": {\"fix\": 3, \"name\": \"Sala \\\"A\\\"\"}}]}";
+    IS_EQUAL(length, strlen(expected));
+    IS_TRUE(memcmp(buffer, expected, length + 1) == 0);
+
+    END_IT
+}
+
+int test_writer_escaped() {
+    IT("escapes quotes, backslashes and control characters");
+    char buffer[64];
+    PayloadBuffer writer(buffer, sizeof(buffer));
+
+    IS_TRUE(writer.appendEscaped("a\"b\\c\nd\te\x01" "f"));
+
+    IS_TRUE(strcmp(buffer, "a\\\"b\\\\c\\nd\\te\\u0001f") == 0);
+
+    END_IT
+}
+
+int test_payload_overflow() {
+    IT("reports overflow instead of writing past the buffer");
+    char buffer[32];
+    memset(buffer, 'x', sizeof(buffer));
+    PayloadBuffer writer(buffer, 20);
+    Value values[] = { makeValue("temperature", 21.5f, NULL, 0) };
+
+    size_t length = buildPayload(values, 1, writer);
+
+    IS_EQUAL(length, 0);
+    IS_TRUE(writer.overflowed());
+    IS_TRUE(writer.length() < 20);
+    IS_EQUAL(buffer[writer.length()], '\0');
+    IS_EQUAL(buffer[20], 'x');
+
+    END_IT
+}
+
+int test_writer_uint() {
+    IT("appends unsigned integers");
+    char buffer[32];
+    PayloadBuffer writer(buffer, sizeof(buffer));
+
+    writer.appendUInt(0);
+    writer.append(',');
+    writer.appendUInt(4294967295u);
+
+    IS_TRUE(strcmp(buffer, "0,4294967295") == 0);
+    IS_EQUAL(writer.length(), 12);
+
+    END_IT
+}
+
+int test_writer_float_decimals() {
+    IT("writes more decimals than the formatter supports as its maximum");
+    char buffer[64];
+    PayloadBuffer writer(buffer, sizeof(buffer));
+
+    IS_TRUE(writer.appendFloat(1.5f, 200));
+    IS_TRUE(strcmp(buffer, "1.500000000") == 0);
+
+    // FLT_MAX pasa por snprintf, y con el máximo de decimales aún cabe
+    PayloadBuffer large(buffer, sizeof(buffer));
+    IS_TRUE(large.appendFloat(-3.40282347e38f, 255));
+    IS_FALSE(large.overflowed());
+    IS_EQUAL(large.length(), 1 + 39 + 1 + FORMAT_MAX_DECIMALS);
+
+    END_IT
+}
+
+int test_counter_matches_buffer() {
+    IT("measures the same length that is written");
+    char buffer[500];
+    PayloadBuffer writer(buffer, sizeof(buffer));
+    PayloadCounter counter;
+    Value values[] = {
+        makeValue("a", 1.0f, NULL, 0),
+        makeValue("b", 123456.789f, NULL, 1600000000),
+    };
+
+    size_t length = buildPayload(values, 2, writer);
+
+    IS_EQUAL(buildPayload(values, 2, counter), length);
+    IS_FALSE(counter.overflowed());
+
+    END_IT
+}
+
+int test_stream_in_chunks() {
+    IT("streams the payload in chunks of PAYLOAD_CHUNK_SIZE");
+    char buffer[1024];
+    PayloadBuffer writer(buffer, sizeof(buffer));
+    CapturePrint out;
+    PayloadStream stream(out);
+    Value values[20];
+    for (int i = 0; i < 20; i++) {
+        values[i]._variableLabel = "variable";
+        values[i]._value = i;
+        values[i]._context = NULL;
+        values[i]._timestamp = 0;
+        values[i]._entries = NULL;
+        values[i]._entryCount = 0;
+    }
+
+    size_t length = buildPayload(values, 20, writer);
+    IS_TRUE(length > PAYLOAD_CHUNK_SIZE);
+
+    IS_EQUAL(buildPayload(values, 20, stream), length);
+    IS_TRUE(stream.flush());
+
+    IS_TRUE(out.data == std::string(buffer, length));
+    IS_EQUAL(out.writes, (int)((length + PAYLOAD_CHUNK_SIZE - 1) / PAYLOAD_CHUNK_SIZE));
+
+    END_IT
+}
+
+int test_fit_payload() {
+    IT("splits values into payloads that fit a maximum length");
+    Value values[40];
+    for (int i = 0; i < 40; i++) {
+        values[i]._variableLabel = "variable";
+        values[i]._value = i;
+        values[i]._context = NULL;
+        values[i]._timestamp = 0;
+        values[i]._entries = NULL;
+        values[i]._entryCount = 0;
+    }
+
+    size_t maxLength = 200;
+    uint16_t first = 0;
+    int packets = 0;
+    while (first < 40) {
+        size_t length;
+        uint16_t n = fitPayload(values + first, 40 - first, maxLength, &length);
+        IS_TRUE(n > 0);
+        IS_TRUE(length <= maxLength);
+
+        char buffer[256];
+        PayloadBuffer writer(buffer, sizeof(buffer));
+        IS_EQUAL(buildPayload(values + first, n, writer), length);
+
+        if (first + n < 40) {
+            PayloadCounter counter;
+            IS_TRUE(buildPayload(values + first, n + 1, counter) > maxLength);
+        }
+        first += n;
+        packets++;
+    }
+    IS_TRUE(packets > 1);
+
+    END_IT
+}
+
+int test_fit_payload_oversized() {
+    IT("returns a single value when it alone exceeds the maximum length");
+    Value values[] = {
+        makeValue("a_very_long_variable_label", 1.0f, NULL, 0),
+        makeValue("b", 2.0f, NULL, 0),
+    };
+    size_t length;
+
+    IS_EQUAL(fitPayload(values, 2, 10, &length), 1);
+    IS_TRUE(length > 10);
+
+    END_IT
+}
+
+
+int main()
+{
+    SUITE("Payload");
+    test_payload_single_value();
+    test_payload_multiple_values();
+    test_payload_typed_context();
+    test_writer_escaped();
+    test_payload_overflow();
+    test_writer_uint();
+    test_writer_float_decimals();
+    test_counter_matches_buffer();
+    test_stream_in_chunks();
+    test_fit_payload();
+    test_fit_payload_oversized();
+
+    FINISH
+}
@@ -0,0 +1,96 @@
+#include "UbidotsPolicy.h"
+#include "BDDTest.h"
+#include "trace.h"
+
+
+int test_policy_default() {
+    IT("passes every value without restrictions");
+    PublishPolicy policy("temp");
+
+    IS_TRUE(policy.evaluate(20.0f, 0));
+    IS_TRUE(policy.evaluate(20.0f, 10));
+    IS_EQUAL(policy.passed(), 2);
+    IS_EQUAL(policy.suppressed(), 0);
+
+    END_IT
+}
+
+int test_policy_deadband() {
+    IT("suppresses changes inside an absolute deadband");
+    PublishPolicy policy("temp");
+    policy.setDeadband(0.5f);
+
+    IS_TRUE(policy.evaluate(20.0f, 0));
+    IS_FALSE(policy.evaluate(20.3f, 1000));
+    IS_FALSE(policy.evaluate(19.6f, 2000));
+    IS_TRUE(policy.evaluate(20.5f, 3000));
+    IS_FALSE(policy.evaluate(20.9f, 4000));
+    IS_EQUAL(policy.passed(), 2);
+    IS_EQUAL(policy.suppressed(), 3);
+
+    END_IT
+}
+
+int test_policy_relative_deadband() {
+    IT("suppresses changes inside a relative deadband");
+    PublishPolicy policy("pot");
+    policy.setRelativeDeadband(0.1f);
+
+    IS_TRUE(policy.evaluate(1000.0f, 0));
+    IS_FALSE(policy.evaluate(1050.0f, 1));
+    IS_TRUE(policy.evaluate(1100.0f, 2));
+    IS_FALSE(policy.evaluate(1200.0f, 3));
+
+    END_IT
+}
+
+int test_policy_min_interval() {
+    IT("never passes before the minimum interval");
+    PublishPolicy policy("temp");
+    policy.setMinInterval(1000);
+
+    IS_TRUE(policy.evaluate(20.0f, 0));
+    IS_FALSE(policy.evaluate(30.0f, 999));
+    IS_TRUE(policy.evaluate(30.0f, 1000));
+
+    END_IT
+}
+
+int test_policy_heartbeat() {
+    IT("passes unchanged values after the heartbeat interval");
+    PublishPolicy policy("temp");
+    policy.setDeadband(1.0f).setHeartbeat(60000);
+
+    IS_TRUE(policy.evaluate(20.0f, 0));
+    IS_FALSE(policy.evaluate(20.0f, 59999));
+    IS_TRUE(policy.evaluate(20.0f, 60000));
+    IS_FALSE(policy.evaluate(20.0f, 60001));
+
+    END_IT
+}
+
+int test_policy_millis_overflow() {
+    IT("handles millis() overflow");
+    PublishPolicy policy("temp");
+    policy.setMinInterval(1000);
+
+    IS_TRUE(policy.evaluate(20.0f, 0xFFFFFF00));
+    IS_FALSE(policy.evaluate(20.0f, 0x00000010));
+    IS_TRUE(policy.evaluate(20.0f, 0x00000300));
+
+    END_IT
+}
+
+
+int main()
+{
+    SUITE("Policy");
+    test_policy_default();
+    test_policy_deadband();
+    test_policy_relative_deadband();
+    test_policy_min_interval();
+    test_policy_heartbeat();
+    test_policy_millis_overflow();
+
+    FINISH
+}
@@ -0,0 +1,76 @@
+#include "UbidotsRateLimit.h"
+#include "BDDTest.h"
+#include "trace.h"
+
+
+int test_rate_unlimited() {
+    IT("never waits without a rate");
+    RateLimit limit;
+
+    for (int i = 0; i < 100; i++) {
+        IS_TRUE(limit.ready(0));
+        limit.consume();
+    }
+    IS_EQUAL(limit.wait(), 0);
+
+    END_IT
+}
+
+int test_rate_burst() {
+    IT("allows a full burst and then waits for new tokens");
+    RateLimit limit("esp32");
+    limit.setRate(2).setBurst(3);
+
+    for (int i = 0; i < 3; i++) {
+        IS_TRUE(limit.ready(1000));
+        limit.consume();
+    }
+    IS_FALSE(limit.ready(1000));
+    IS_EQUAL(limit.wait(), 500);
+
+    IS_FALSE(limit.ready(1400));
+    IS_TRUE(limit.ready(1500));
+    limit.consume();
+    IS_FALSE(limit.ready(1500));
+
+    END_IT
+}
+
+int test_rate_cap() {
+    IT("does not accumulate more tokens than the burst");
+    RateLimit limit;
+    limit.setRate(10).setBurst(2);
+
+    IS_TRUE(limit.ready(0));
+    IS_TRUE(limit.ready(60000));
+    limit.consume();
+    limit.consume();
+    IS_FALSE(limit.ready(60000));
+
+    END_IT
+}
+
+int test_rate_overflow() {
+    IT("handles millis() overflow");
+    RateLimit limit;
+    limit.setRate(1).setBurst(1);
+
+    IS_TRUE(limit.ready(0xFFFFFF00));
+    limit.consume();
+    IS_FALSE(limit.ready(0xFFFFFFF0));
+    IS_TRUE(limit.ready(0x00000400));
+
+    END_IT
+}
+
+
+int main()
+{
+    SUITE("RateLimit");
+    test_rate_unlimited();
+    test_rate_burst();
+    test_rate_cap();
+    test_rate_overflow();
+
+    FINISH
+}
@@ -0,0 +1,144 @@
+#include "UbidotsSampler.h"
+#include "BDDTest.h"
+#include "trace.h"
+#include <math.h>
+
+static int reads;
+static float nextReading;
+
+static float counter() {
+    reads++;
+    return nextReading;
+}
+
+// Estadísticas de referencia: se recorren las últimas n muestras en dos pasadas
+static void reference(const float* values, int end, int n, float* mean, float* variance,
+                      float* lowest, float* highest) {
+    double sum = 0;
+    *lowest = values[end - n];
+    *highest = values[end - n];
+    for (int i = end - n; i < end; i++) {
+        sum += values[i];
+        *lowest = values[i] < *lowest ? values[i] : *lowest;
+        *highest = values[i] > *highest ? values[i] : *highest;
+    }
+    *mean = sum / n;
+
+    double m2 = 0;
+    for (int i = end - n; i < end; i++) {
+        m2 += (values[i] - *mean) * (values[i] - *mean);
+    }
+    *variance = n > 1 ? m2 / (n - 1) : 0;
+}
+
+
+int test_sampler_window() {
+    IT("matches a two-pass computation over the sliding window");
+    const int total = 2000;
+    const int window = 7;
+    static float values[total];
+    Sampler sampler("distancia", NULL, 0, window);
+
+    // Lecturas alrededor de 150 cm con ruido y una rampa, para que el mínimo y el máximo cambien
+    srand(1);
+    bool ok = true;
+    for (int i = 0; i < total; i++) {
+        values[i] = 150 + (i % 300) * 0.1f + (rand() % 1000) / 100.0f;
+        IS_TRUE(sampler.record(values[i]));
+
+        int n = i + 1 < window ? i + 1 : window;
+        float mean, variance, lowest, highest;
+        reference(values, i + 1, n, &mean, &variance, &lowest, &highest);
+
+        ok = ok && sampler.count() == n;
+        ok = ok && fabsf(sampler.mean() - mean) < 1e-3f;
+        ok = ok && fabsf(sampler.variance() - variance) < 1e-2f * (1 + variance);
+        ok = ok && sampler.minimum() == lowest && sampler.maximum() == highest;
+    }
+    IS_TRUE(ok);
+
+    END_IT
+}
+
+int test_sampler_cadence() {
+    IT("reads the source at a fixed rate and counts the reads missed");
+    reads = 0;
+    nextReading = 1;
+    Sampler sampler("potenciometro", counter, 100, 10);
+
+    // Se llama a poll() cada 30 ms: una lectura cada 100 ms, sin deriva
+    for (uint32_t now = 1000; now < 2000; now += 30) {
+        sampler.poll(now);
+    }
+    IS_EQUAL(reads, 10);
+    IS_EQUAL(sampler.missed(), 0);
+
+    // Un atraso de 350 ms pierde 3 lecturas y mantiene la fase
+    IS_TRUE(sampler.poll(2350));
+    IS_EQUAL(sampler.missed(), 3);
+    IS_FALSE(sampler.poll(2399));
+    IS_TRUE(sampler.poll(2400));
+    IS_EQUAL(reads, 12);
+
+    // Desborde de millis()
+    Sampler wrap("potenciometro", counter, 100, 10);
+    IS_TRUE(wrap.poll(0xFFFFFFC0));
+    IS_FALSE(wrap.poll(0x10));
+    IS_TRUE(wrap.poll(0x24));
+    IS_EQUAL(wrap.missed(), 0);
+
+    END_IT
+}
+
+int test_sampler_failures() {
+    IT("keeps failed reads out of the window");
+    Sampler sampler("temperatura", NULL, 0, 4);
+
+    IS_TRUE(sampler.record(20));
+    IS_FALSE(sampler.record(NAN));
+    IS_TRUE(sampler.record(22));
+
+    IS_EQUAL(sampler.count(), 2);
+    IS_EQUAL(sampler.failures(), 1);
+    IS_TRUE(sampler.mean() == 21);
+
+    sampler.reset();
+    IS_EQUAL(sampler.count(), 0);
+    IS_EQUAL(sampler.failures(), 0);
+    IS_TRUE(sampler.mean() == 0 && sampler.minimum() == 0 && sampler.maximum() == 0);
+
+    END_IT
+}
+
+int test_sampler_aggregate() {
+    IT("summarizes the window in one aggregate");
+    Sampler sampler("humedad", NULL, 0, 3);
+    SampleAggregate empty = sampler.aggregate();
+    IS_EQUAL(empty._count, 0);
+
+    const float values[] = { 90, 40, 50, 60 };
+    for (int i = 0; i < 4; i++) {
+        sampler.record(values[i]);
+    }
+
+    SampleAggregate aggregate = sampler.aggregate();
+    IS_TRUE(aggregate._variableLabel == sampler.label());
+    IS_EQUAL(aggregate._count, 3);
+    IS_TRUE(aggregate._mean == 50);
+    IS_TRUE(aggregate._min == 40);
+    IS_TRUE(aggregate._max == 60);
+    IS_TRUE(aggregate._variance == 100);
+
+    END_IT
+}
+
+int main()
+{
+    SUITE("Sampler");
+    test_sampler_window();
+    test_sampler_cadence();
+    test_sampler_failures();
+    test_sampler_aggregate();
+
+    FINISH
+}
@@ -0,0 +1,138 @@
+#include "UbidotsPayload.h"
+#include "BDDTest.h"
+#include "trace.h"
+#include <string.h>
+
+
+int test_series_ring() {
+    IT("keeps the newest samples when the series is full");
+    SampleSeries series("distancia", 3);
+
+    for (int i = 0; i < 5; i++) {
+        series.record(i, 1600000000 + i);
+    }
+
+    IS_EQUAL(series.count(), 3);
+    IS_EQUAL(series.dropped(), 2);
+    IS_TRUE(series.at(0)._value == 2);
+    IS_TRUE(series.at(2)._value == 4);
+    IS_EQUAL(series.at(2)._timestamp, 1600000004);
+
+    series.clear();
+    IS_EQUAL(series.count(), 0);
+
+    END_IT
+}
+
+int test_series_discard() {
+    IT("discards the oldest samples");
+    SampleSeries series("distancia", 4);
+
+    for (int i = 0; i < 6; i++) {
+        series.record(i, 1600000000 + i);
+    }
+
+    series.discard(1);
+    IS_EQUAL(series.count(), 3);
+    IS_TRUE(series.at(0)._value == 3);
+    IS_TRUE(series.at(2)._value == 5);
+
+    series.record(6, 1600000006);
+    IS_EQUAL(series.count(), 4);
+    IS_TRUE(series.at(3)._value == 6);
+
+    series.discard(10);
+    IS_EQUAL(series.count(), 0);
+
+    END_IT
+}
+
+int test_series_payload() {
+    IT("builds one array per variable with millisecond timestamps");
+    SampleSeries series("distancia", 4);
+    series.record(12.5f, 1600000000, 0);
+    series.record(13.0f, 1600000000, 500);
+    series.record(14.0f, 1600000001, 5);
+    char buffer[256];
+    PayloadBuffer writer(buffer, sizeof(buffer));
+    SeriesCursor from = { &series, 0 };
+    SeriesCursor to = { NULL, 0 };
+
+    size_t length = buildSeriesPayload(from, to, writer);
+
+    const char* expected = "{\"distancia\": ["
+        "{\"value\": 12.50, \"timestamp\": 1600000000000}, "
+        "{\"value\": 13.00, \"timestamp\": 1600000000500}, "
+        "{\"value\": 14.00, \"timestamp\": 1600000001005}]}";
+    IS_EQUAL(length, strlen(expected));
+    IS_TRUE(strcmp(buffer, expected) == 0);
+
+    END_IT
+}
+
+int test_series_millis() {
+    IT("carries milliseconds past 999 into the timestamp");
+    SampleSeries series("distancia", 2);
+    series.record(1, 1600000000, 1500);
+    series.record(2, 1600000000, 65535);
+
+    IS_EQUAL(series.at(0)._timestamp, 1600000001);
+    IS_EQUAL(series.at(0)._millis, 500);
+    IS_EQUAL(series.at(1)._timestamp, 1600000065);
+    IS_EQUAL(series.at(1)._millis, 535);
+
+    char buffer[128];
+    PayloadBuffer writer(buffer, sizeof(buffer));
+    SeriesCursor from = { &series, 0 };
+    SeriesCursor to = { NULL, 0 };
+    buildSeriesPayload(from, to, writer);
+    IS_TRUE(strcmp(buffer, "{\"distancia\": ["
+        "{\"value\": 1.00, \"timestamp\": 1600000001500}, "
+        "{\"value\": 2.00, \"timestamp\": 1600000065535}]}") == 0);
+
+    END_IT
+}
+
+int test_series_fit() {
+    IT("splits a long series into payloads that fit a maximum length");
+    SampleSeries series("distancia", 50);
+    for (int i = 0; i < 50; i++) {
+        series.record(i, 1600000000 + i / 2, (i % 2) * 500);
+    }
+
+    size_t maxLength = 300;
+    SeriesCursor from = { &series, 0 };
+    int samples = 0;
+    int packets = 0;
+    while (from._series != NULL) {
+        SeriesCursor to;
+        size_t length;
+        uint16_t n = fitSeriesPayload(from, maxLength, &to, &length);
+        IS_TRUE(n > 0);
+        IS_TRUE(length <= maxLength);
+
+        char buffer[512];
+        PayloadBuffer writer(buffer, sizeof(buffer));
+        IS_EQUAL(buildSeriesPayload(from, to, writer), length);
+
+        samples += n;
+        packets++;
+        from = to;
+    }
+    IS_EQUAL(samples, 50);
+    IS_TRUE(packets > 1);
+
+    END_IT
+}
+
+int main()
+{
+    SUITE("Series");
+    test_series_ring();
+    test_series_discard();
+    test_series_payload();
+    test_series_millis();
+    test_series_fit();
+
+    FINISH
+}
@@ -0,0 +1,208 @@
+#include "UbidotsStore.h"
+#include "BDDTest.h"
+#include "trace.h"
+#include <stdio.h>
+#include <string.h>
+
+
+int test_store_payload() {
+    IT("builds the same JSON from stored values as from Value entries");
+    LabelTable labels;
+    ValueStore store;
+    const char* names[] = { "temperatura", "humedad", "temperatura" };
+    float numbers[] = { 21.5f, 55.25f, -3.125f };
+    Value values[3];
+    char stored[200];
+    char expected[200];
+
+    store.begin(3, 4);
+    for (int i = 0; i < 3; i++) {
+        values[i] = {};
+        values[i]._variableLabel = names[i];
+        values[i]._value = numbers[i];
+        IS_TRUE(store.add(labels.add(names[i]), numbers[i], NULL, NULL));
+    }
+    IS_FALSE(store.add(labels.add("presion"), 1.0f, NULL, NULL));
+
+    PayloadBuffer a(stored, sizeof(stored));
+    PayloadBuffer b(expected, sizeof(expected));
+    size_t length = buildStorePayload(store, labels, 0, 3, DEVICE_NONE, 3, a);
+
+    IS_EQUAL(length, buildPayload(values, 3, b));
+    IS_TRUE(strcmp(stored, expected) == 0);
+    IS_TRUE(strcmp(stored, "{\"temperatura\": [{\"value\": 21.50}], \"humedad\": [{\"value\": 55.25}], "
+                           "\"temperatura\": [{\"value\": -3.12}]}") == 0);
+
+    END_IT
+}
+
+int test_store_detail() {
+    IT("keeps registered and unregistered variables in the order they were added");
+    LabelTable labels;
+    ValueStore store;
+    ValueDetail detail = {};
+    char buffer[200];
+
+    store.begin(3, 4);
+    IS_TRUE(store.add(labels.add("temperatura"), 21.5f, NULL, NULL));
+
+    detail._variableLabel = "sin_registro";
+    detail._timestamp = 1700000000;
+    IS_TRUE(store.add(LABEL_NONE, 1.0f, NULL, &detail));
+
+    ContextEntry* entry = store.addEntry("sala");
+    IS_TRUE(entry != NULL);
+    entry->_type = CONTEXT_TEXT;
+    entry->_text = "norte";
+
+    IS_TRUE(store.add(labels.add("humedad"), 55.0f, NULL, NULL));
+    IS_TRUE(store.detail(0) == NULL);
+    IS_TRUE(store.detail(1) != NULL);
+    IS_TRUE(strcmp(store.label(labels, 1), "sin_registro") == 0);
+
+    PayloadBuffer writer(buffer, sizeof(buffer));
+    buildStorePayload(store, labels, 0, 3, DEVICE_NONE, 3, writer);
+    IS_TRUE(strcmp(buffer, "{\"temperatura\": [{\"value\": 21.50}], "
+                           "\"sin_registro\": [{\"value\": 1.00, \"timestamp\": 1700000000000, "
+                           "\"context\": {\"sala\": \"norte\"}}], "
+                           "\"humedad\": [{\"value\": 55.00}]}") == 0);
+
+    END_IT
+}
+
+int test_store_devices() {
+    IT("groups the values of each device without reordering them");
+    LabelTable labels;
+    ValueStore store;
+    char patio[] = "patio";
+    char buffer[200];
+
+    store.begin(4, 0);
+    store.add(labels.add("a"), 1.0f, "bodega", NULL);
+    store.add(labels.add("b"), 2.0f, NULL, NULL);
+    store.add(labels.add("c"), 3.0f, "bodega", NULL);
+    store.add(labels.add("d"), 4.0f, patio, NULL);
+    store.queue(0, 4, "invernadero", 0);
+
+    uint8_t bodega = store.at(0)._device;
+    IS_EQUAL(store.at(2)._device, bodega);
+    IS_TRUE(strcmp(store.device(store.at(1)._device), "invernadero") == 0);
+    IS_EQUAL(store.next(1, 4, bodega), 2);
+
+    PayloadBuffer writer(buffer, sizeof(buffer));
+    buildStorePayload(store, labels, 0, 4, bodega, 2, writer);
+    IS_TRUE(strcmp(buffer, "{\"a\": [{\"value\": 1.00}], \"c\": [{\"value\": 3.00}]}") == 0);
+
+    // Los dispositivos sin valores salen de la tabla al compactar
+    store.mark(0, 4, bodega, 2, VALUE_DONE);
+    IS_EQUAL(store.compact(4), 2);
+    IS_TRUE(strcmp(store.label(labels, 0), "b") == 0);
+    IS_TRUE(strcmp(store.device(store.at(0)._device), "invernadero") == 0);
+    IS_TRUE(strcmp(store.device(store.at(1)._device), "patio") == 0);
+    IS_EQUAL(store.at(1)._device, 0);
+
+    END_IT
+}
+
+int test_store_compact_entries() {
+    IT("frees the context entries of removed values and keeps the rest");
+    LabelTable labels;
+    ValueStore store;
+    ValueDetail detail = {};
+    char buffer[200];
+
+    store.begin(3, 3);
+    for (int i = 0; i < 3; i++) {
+        char key[8];
+        snprintf(key, sizeof(key), "k%d", i);
+        store.add(labels.add(key), i, (i == 1) ? "patio" : "bodega", &detail);
+
+        ContextEntry* entry = store.addEntry(labels.label(i));
+        entry->_type = CONTEXT_NUMBER;
+        entry->_decimals = 0;
+        entry->_number = i;
+    }
+    IS_TRUE(store.addEntry("k3") == NULL);
+
+    // Enviar el de bodega que está primero: su entrada se libera y las demás bajan
+    store.queue(0, 3, NULL, 0);
+    store.mark(0, 3, store.at(0)._device, 1, VALUE_DONE);
+    IS_EQUAL(store.compact(3), 2);
+
+    PayloadBuffer writer(buffer, sizeof(buffer));
+    buildStorePayload(store, labels, 0, 2, store.at(1)._device, 1, writer);
+    IS_TRUE(strcmp(buffer, "{\"k2\": [{\"value\": 2.00, \"context\": {\"k2\": 2}}]}") == 0);
+
+    IS_TRUE(store.add(labels.add("k3"), 3.0f, NULL, NULL));
+    IS_TRUE(store.addEntry("k3") != NULL);
+
+    END_IT
+}
+
+int test_store_remove_last() {
+    IT("removes the last value together with its context entries");
+    LabelTable labels;
+    ValueStore store;
+
+    store.begin(2, 4);
+    store.add(labels.add("a"), 1.0f, NULL, NULL);
+    store.addEntry("k");
+    store.add(labels.add("b"), 2.0f, NULL, NULL);
+    store.addEntry("k");
+    store.addEntry("k");
+    IS_EQUAL(store.freeEntries(), 1);
+
+    store.removeLast();
+    IS_EQUAL(store.count(), 1);
+    IS_EQUAL(store.freeEntries(), 3);
+    IS_EQUAL(store.detail(0)->_entryCount, 1);
+
+    END_IT
+}
+
+int test_store_fit() {
+    IT("splits stored values into payloads that fit a maximum length");
+    LabelTable labels;
+    ValueStore store;
+    char buffer[100];
+
+    store.begin(10, 0);
+    for (int i = 0; i < 10; i++) {
+        store.add(labels.add((i % 2) ? "humedad" : "temperatura"), i * 10.5f, NULL, NULL);
+    }
+
+    uint16_t first = 0;
+    int packets = 0;
+
+    while (first < 10) {
+        size_t length;
+        uint16_t n = fitStorePayload(store, labels, first, 10, DEVICE_NONE, 80, &length);
+        PayloadBuffer writer(buffer, sizeof(buffer));
+
+        IS_TRUE(n > 0);
+        IS_TRUE(length <= 80);
+        IS_EQUAL(buildStorePayload(store, labels, first, 10, DEVICE_NONE, n, writer), length);
+
+        store.mark(first, 10, DEVICE_NONE, n, VALUE_DONE);
+        first = store.next(first, 10, DEVICE_NONE);
+        packets++;
+    }
+    IS_TRUE(packets > 1);
+    IS_EQUAL(store.compact(10), 0);
+    IS_EQUAL(store.count(), 0);
+
+    END_IT
+}
+
+int main()
+{
+    SUITE("Store");
+    test_store_payload();
+    test_store_detail();
+    test_store_devices();
+    test_store_compact_entries();
+    test_store_remove_last();
+    test_store_fit();
+
+    FINISH
+}
@@ -0,0 +1,56 @@
+/*
+ * Non Blocking
+ * Prints the distance read by an ultrasonic sensor in
+ * centimeters without waiting for the echo: trigger()
+ * returns at once and poll() tells when the echo has
+ * been measured, so loop() keeps running meanwhile.
+ *
+ * The circuit:
+ * * Module HR-SC04 (four pins) or PING))) (and other with
+ *   three pins), attached to digital pins as follows:
+ * ---------------------    --------------------
+ * | HC-SC04 | Arduino |    | 3 pins | Arduino |
+ * ---------------------    --------------------
+ * |   Vcc   |   5V    |    |   Vcc  |   5V    |
+ * |   Trig  |   12    | OR |   SIG  |    2    |
+ * |   Echo  |    2    |    |   Gnd  |   GND   |
+ * |   Gnd   |   GND   |    --------------------
+ * ---------------------
+ * Note: the echo pin must support interrupts (pins 2 and 3
+ * on the Arduino Uno, any pin on the ESP32)
+ *
+ * This example code is released into the MIT License.
+ */
+
+#include <Ultrasonic.h>
+
+Ultrasonic ultrasonic(12, 2);
+unsigned long lastTrigger = 0;
+bool measuring = false;
+
+void setup() {
+  Serial.begin(9600);
+}
+
+void loop() {
+  // One measurement every 100 ms
+  if (!measuring && millis() - lastTrigger >= 100) {
+    lastTrigger = millis();
+    measuring = ultrasonic.trigger();
+  }
+
+  if (measuring) {
+    UltrasonicStatus status = ultrasonic.poll();
+
+    if (status == ULTRASONIC_OK) {
+      Serial.print("Distance in CM: ");
+      Serial.println(ultrasonic.distance());
+    } else if (status == ULTRASONIC_TIMEOUT) {
+      Serial.println("No echo");
+    }
+
+    measuring = status == ULTRASONIC_BUSY;
+  }
+
+  // Anything else here keeps running while the echo is on its way
+}
@@ -0,0 +1,67 @@
+/*
+ * Scheduler
+ * Prints the filtered distance read by four ultrasonic
+ * sensors mounted close together (e.g. on the lid of a
+ * tank). Firing them at the same time, or right one after
+ * the other, makes each sensor hear the pings of its
+ * neighbours (crosstalk), so UltrasonicScheduler fires one
+ * at a time and waits a guard time after each echo. It
+ * never waits for an echo, so loop() keeps running.
+ *
+ * The circuit:
+ * * Four HC-SC04 modules, attached to digital pins as follows:
+ * -------------------------------------------
+ * | HC-SC04 | Arduino                       |
+ * -------------------------------------------
+ * |   Vcc   |   5V                          |
+ * |   Trig  |   4, 5, 6, 7                  |
+ * |   Echo  |   2, 3, 18, 19 (interrupts)   |
+ * |   Gnd   |   GND                         |
+ * -------------------------------------------
+ * Note: the echo pins must support interrupts (the pins
+ * above are for the Arduino Mega; any pin on the ESP32)
+ *
+ * This example code is released into the MIT License.
+ */
+
+#include <UltrasonicScheduler.h>
+
+UltrasonicScheduler scheduler(4);
+unsigned long lastPrint = 0;
+
+void setup() {
+  Serial.begin(9600);
+
+  scheduler.add(4, 2);
+  scheduler.add(5, 3);
+  scheduler.add(6, 18);
+  scheduler.add(7, 19);
+
+  // Optional: fire the sensors far from each other one after the other
+  const uint8_t order[] = {0, 2, 1, 3};
+  scheduler.setOrder(order, 4);
+
+  // 10 ms of silence after each echo
+  scheduler.begin(10000UL);
+}
+
+void loop() {
+  scheduler.loop();
+
+  if (millis() - lastPrint >= 1000) {
+    lastPrint = millis();
+
+    for (uint8_t i = 0; i < scheduler.count(); i++) {
+      const UltrasonicReading &reading = scheduler.reading(i);
+      Serial.print("Sensor ");
+      Serial.print(i);
+      Serial.print(": ");
+      Serial.print(reading.distance / 100.0); // Tenths of a millimetre to CM
+      Serial.print(" cm, ");
+      Serial.print(scheduler.rate(i));
+      Serial.print(" samples/s, ");
+      Serial.print(reading.failures);
+      Serial.println(" without echo");
+    }
+  }
+}
@@ -0,0 +1,56 @@
+/*
+ * Temperature Compensation
+ * Prints the distance read by an ultrasonic sensor in
+ * millimetres, corrected with the air temperature and
+ * humidity read by a DHT22 sensor (DHT sensor library by
+ * Adafruit). The speed of sound changes about 0.6 m/s per
+ * degree, so without the correction the distance is off by
+ * up to a few millimetres per metre.
+ *
+ * The circuit:
+ * ---------------------    ---------------------
+ * | HC-SC04 | Arduino |    |  DHT22  | Arduino |
+ * ---------------------    ---------------------
+ * |   Vcc   |   5V    |    |   Vcc   |   5V    |
+ * |   Trig  |   12    |    |   Data  |    4    |
+ * |   Echo  |   13    |    |   Gnd   |   GND   |
+ * |   Gnd   |   GND   |    ---------------------
+ * ---------------------
+ *
+ * This example code is released into the MIT License.
+ */
+
+#include <Ultrasonic.h>
+#include <DHT.h>
+
+Ultrasonic ultrasonic(12, 13);
+UltrasonicFilter filter;
+UltrasonicAir air; // 20 C until the first DHT reading
+DHT dht(4, DHT22);
+unsigned long lastAir = 0;
+
+void setup() {
+  Serial.begin(9600);
+  dht.begin();
+
+  ultrasonic.setFilter(&filter);
+  ultrasonic.setAir(&air);
+  filter.setAir(&air);
+}
+
+void loop() {
+  // The air changes slowly: read it every 10 s
+  if (millis() - lastAir >= 10000 || lastAir == 0) {
+    lastAir = millis();
+    air.set(dht.readTemperature(), dht.readHumidity()); // Ignored if the read failed
+  }
+
+  ultrasonic.read();
+
+  Serial.print("Distance in MM: ");
+  Serial.print(filter.distance() / 10.0);
+  Serial.print(" at ");
+  Serial.print(air.temperature() / 10.0);
+  Serial.println(" C");
+  delay(100);
+}
@@ -27,13 +27,15 @@
 
 #include "Ultrasonic.h"
 
-Ultrasonic::Ultrasonic(uint8_t trigPin, uint8_t echoPin, unsigned long timeOut) {
+Ultrasonic::Ultrasonic(uint8_t trigPin, uint8_t echoPin, unsigned long timeOut)
+  : pinEdges(trigPin, echoPin) {
   trig = trigPin;
   echo = echoPin;
   threePins = trig == echo ? true : false;
   pinMode(trig, OUTPUT);
   pinMode(echo, INPUT);
   timeout = timeOut;
+  async.setSource(&pinEdges);
 }
 
 unsigned int Ultrasonic::timing() {
@@ -61,11 +63,137 @@ unsigned int Ultrasonic::timing() {
  * If the unit of measure is not passed as a parameter,
  * sby default, it will return the distance in centimeters.
  * To change the default, replace CM by INC.
+ *
+ * The echo is timed with the same interrupt as trigger() and poll();
+ * pins without an interrupt are polled as before.
  */
 unsigned int Ultrasonic::read(uint8_t und) {
-  return timing() / und / 2;  //distance by divisor
+  if (usePins && !pinEdges.hasInterrupt())
+    return scale(timing(), und);
+
+  async.cancel();
+  trigger();
+  while (poll() == ULTRASONIC_BUSY);
+  return distance(und);
+}
+
+/*
+ * With an air snapshot (setAir()), CM and INC distances use its speed of
+ * sound and are rounded to the nearest unit; otherwise they use the
+ * divisor, as always.
+ */
+unsigned int Ultrasonic::scale(unsigned long duration, uint8_t und) {
+  if (air != NULL && (und == CM || und == INC)) {
+    uint32_t tenths = air->distance(duration);
+    return und == CM ? (tenths + 50) / 100 : (tenths + 127) / 254;
+  }
+
+  return duration / und / 2;  //distance by divisor
+}
+
+/*
+ * Send the trigger pulse and return at once. Call poll() until it stops
+ * returning ULTRASONIC_BUSY, then get the result with distance() or
+ * duration(). Returns false if a measurement is already in progress or
+ * the echo pin has no interrupt.
+ */
+bool Ultrasonic::trigger() {
+  if (usePins && !pinEdges.hasInterrupt())
+    return false;
+
+  return async.start(timeout);
+}
+
+/*
+ * Advance the measurement. Never blocks. Each echo received is also fed
+ * to the filter set with setFilter().
+ */
+UltrasonicStatus Ultrasonic::poll() {
+  bool busy = async.busy();
+  UltrasonicStatus status = async.poll();
+
+  if (busy && status == ULTRASONIC_OK && filter != NULL)
+    filter->add(async.duration());
+
+  return status;
+}
+
+/*
+ * Use another sensor (e.g. synthetic echoes in tests), or NULL for the
+ * pins again.
+ */
+void Ultrasonic::setEdgeSource(UltrasonicEdgeSource *source) {
+  usePins = source == NULL;
+  async.setSource(usePins ? &pinEdges : source);
+}
+
+#if !defined(ESP32) && !defined(ESP8266)
+UltrasonicPinEdges *UltrasonicPinEdges::capturing = NULL;
+#endif
+
+UltrasonicPinEdges::UltrasonicPinEdges(uint8_t trigPin, uint8_t echoPin) {
+  trig = trigPin;
+  echo = echoPin;
+  edges = NULL;
+}
+
+bool UltrasonicPinEdges::hasInterrupt() {
+#ifdef NOT_AN_INTERRUPT
+  return digitalPinToInterrupt(echo) != NOT_AN_INTERRUPT;
+#else
+  return true;
+#endif
 }
 
+void UltrasonicPinEdges::trigger() {
+  if (trig == echo)
+    pinMode(trig, OUTPUT);
+
+  digitalWrite(trig, LOW);
+  delayMicroseconds(2);
+  digitalWrite(trig, HIGH);
+  delayMicroseconds(10);
+  digitalWrite(trig, LOW);
+
+  if (trig == echo)
+    pinMode(trig, INPUT);
+}
+
+/*
+ * The interrupt is attached after the trigger pulse, so on three pin
+ * sensors the trigger itself is not recorded.
+ */
+void UltrasonicPinEdges::capture(UltrasonicEchoEdges *echoEdges) {
+  edges = echoEdges;
+#if defined(ESP32) || defined(ESP8266)
+  attachInterruptArg(digitalPinToInterrupt(echo), onEdge, this, CHANGE);
+#else
+  capturing = this;
+  attachInterrupt(digitalPinToInterrupt(echo), onEdge, CHANGE);
+#endif
+}
+
+void UltrasonicPinEdges::stop() {
+  detachInterrupt(digitalPinToInterrupt(echo));
+  edges = NULL;
+}
+
+unsigned long UltrasonicPinEdges::micros() {
+  return ::micros();
+}
+
+void ULTRASONIC_ISR_ATTR UltrasonicPinEdges::onEdge(void *arg) {
+  UltrasonicPinEdges *line = (UltrasonicPinEdges *)arg;
+  if (line != NULL && line->edges != NULL)
+    line->edges->record(::micros(), digitalRead(line->echo) == HIGH);
+}
+
+#if !defined(ESP32) && !defined(ESP8266)
+void ULTRASONIC_ISR_ATTR UltrasonicPinEdges::onEdge() {
+  onEdge(capturing);
+}
+#endif
+
 /*
  * This method is too verbal, so, it's deprecated.
  * Use read() instead.
@@ -20,12 +20,51 @@
 #ifndef Ultrasonic_h
 #define Ultrasonic_h
 
+#include "UltrasonicEcho.h"
+#include "UltrasonicFilter.h"
+#include "UltrasonicAir.h"
+
 /*
  * Values of divisors
  */
 #define CM 28
 #define INC 71
 
+/*
+ * Interrupt handlers must be in IRAM on ESP boards.
+ */
+#if defined(ESP32)
+  #define ULTRASONIC_ISR_ATTR IRAM_ATTR
+#elif defined(ESP8266)
+  #define ULTRASONIC_ISR_ATTR ICACHE_RAM_ATTR
+#else
+  #define ULTRASONIC_ISR_ATTR
+#endif
+
+/*
+ * Trigger and echo pins, with the echo edges timestamped by the pin
+ * change interrupt.
+ */
+class UltrasonicPinEdges : public UltrasonicEdgeSource {
+  public:
+    UltrasonicPinEdges(uint8_t trigPin, uint8_t echoPin);
+    bool hasInterrupt();
+    void trigger();
+    void capture(UltrasonicEchoEdges *edges);
+    void stop();
+    unsigned long micros();
+
+  private:
+    uint8_t trig;
+    uint8_t echo;
+    UltrasonicEchoEdges *edges;
+    static void onEdge(void *arg);
+#if !defined(ESP32) && !defined(ESP8266)
+    static void onEdge();
+    static UltrasonicPinEdges *capturing; // No interrupt argument: one echo at a time
+#endif
+};
+
 class Ultrasonic {
   public:
     Ultrasonic(uint8_t sigPin) : Ultrasonic(sigPin, sigPin) {};
@@ -35,6 +74,14 @@ class Ultrasonic {
     void setTimeout(unsigned long timeOut) {timeout = timeOut;}
     void setMaxDistance(unsigned long dist) {timeout = dist*CM*2;}
 
+    bool trigger();
+    UltrasonicStatus poll();
+    unsigned long duration() {return async.duration();}
+    unsigned int distance(uint8_t und = CM) {return scale(async.duration(), und);}
+    void setEdgeSource(UltrasonicEdgeSource *source);
+    void setFilter(UltrasonicFilter *echoFilter) {filter = echoFilter;}
+    void setAir(const UltrasonicAir *airSnapshot) {air = airSnapshot;}
+
   private:
     uint8_t trig;
     uint8_t echo;
@@ -42,6 +89,12 @@ class Ultrasonic {
     unsigned long previousMicros;
     unsigned long timeout;
     unsigned int timing();
+    unsigned int scale(unsigned long duration, uint8_t und);
+    UltrasonicPinEdges pinEdges;
+    UltrasonicEcho async;
+    boolean usePins = true;
+    UltrasonicFilter *filter = NULL;
+    const UltrasonicAir *air = NULL;
 };
 
 #endif // Ultrasonic_h
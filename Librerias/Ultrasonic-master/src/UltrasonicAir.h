@@ -0,0 +1,45 @@
+/*
+ * UltrasonicAir.h
+ *
+ * Speed of sound for the air the sensors are in. Update the snapshot
+ * when the temperature (and humidity) are measured, e.g. from a DHT
+ * sensor, and share it with every Ultrasonic and UltrasonicFilter: it
+ * keeps the conversion factor ready, so each echo costs one integer
+ * multiply.
+ *
+ * This file does not depend on Arduino.
+ *
+ * Released into the MIT License.
+ */
+
+#ifndef UltrasonicAir_h
+#define UltrasonicAir_h
+
+#include <stdint.h>
+
+#define ULTRASONIC_AIR_MIN -40 // Table range, in Celsius
+#define ULTRASONIC_AIR_MAX 85
+
+class UltrasonicAir {
+  public:
+    UltrasonicAir(float temperature = 20, float humidity = 0);
+    bool set(float temperature, float humidity = 0);
+    int16_t temperature() const {return tenths;}
+    uint8_t humidity() const {return relative;}
+    uint16_t factor() const {return scale;}
+
+    /*
+     * Distance for an echo of duration microseconds, in tenths of a
+     * millimetre.
+     */
+    uint32_t distance(unsigned long duration) const {
+      return ((uint32_t)duration * scale + 8192) >> 14;
+    }
+
+  private:
+    int16_t tenths;   // Temperature, in tenths of a degree Celsius
+    uint8_t relative; // Relative humidity, in percent
+    uint16_t scale;   // Tenths of a millimetre per microsecond of echo, Q14
+};
+
+#endif // UltrasonicAir_h
@@ -0,0 +1,134 @@
+/*
+ * UltrasonicFilter.cpp
+ *
+ * Running median, Hampel outlier rejection and smoothing of echoes.
+ *
+ * Released into the MIT License.
+ */
+
+#include "UltrasonicFilter.h"
+
+/*
+ * window: echoes kept for the median (1 to ULTRASONIC_FILTER_MAX).
+ * threshold: an echo further than threshold scaled MADs from the median
+ * is an outlier and is replaced by the median (0 disables the rejection).
+ * smoothing: each accepted echo moves the output 1/2^smoothing of the way
+ * (0 disables the smoothing).
+ */
+UltrasonicFilter::UltrasonicFilter(uint8_t window, uint8_t thresholdMads, uint8_t smoothingShift) {
+  size = window < 1 ? 1 : window > ULTRASONIC_FILTER_MAX ? ULTRASONIC_FILTER_MAX : window;
+  threshold = thresholdMads;
+  smoothing = smoothingShift > 8 ? 8 : smoothingShift;
+  air = NULL;
+  reset();
+}
+
+void UltrasonicFilter::reset() {
+  head = 0;
+  filled = 0;
+  middle = 0;
+  smoothed = 0;
+  outliers = 0;
+}
+
+/*
+ * Add an echo duration, in microseconds. Returns false if it was
+ * rejected as an outlier; it still enters the window, so a real change
+ * of distance is followed once it fills half of it.
+ */
+bool UltrasonicFilter::add(unsigned long duration) {
+  uint16_t sample = duration > 0xFFFF ? 0xFFFF : duration;
+  bool first = filled == 0;
+  bool accepted = true;
+
+  slide(sample);
+
+  // Hampel: |x - median| > threshold * 1.4826 * MAD. The MAD is at least
+  // 1 us, so the jitter of a still target is not rejected when most of
+  // the window holds the same echo
+  uint16_t value = sample;
+  if (threshold > 0 && filled >= 3) {
+    uint32_t offset = sample > middle ? sample - middle : middle - sample;
+    uint16_t mad = deviation();
+    if (mad < 1)
+      mad = 1;
+    if (offset * 1000 / 1483 > (uint32_t)threshold * mad) {
+      value = middle;
+      accepted = false;
+      outliers++;
+    }
+  }
+
+  // With the speed of sound of the air snapshot, or the same scale as
+  // read(): CM microseconds per centimetre, there and back
+  uint32_t tenths = air != NULL ? air->distance(value) : ((uint32_t)value * 100 + 28) / 56;
+  if (first || smoothing == 0) {
+    smoothed = tenths << 4;
+  } else {
+    int32_t step = (int32_t)(tenths << 4) - (int32_t)smoothed;
+    smoothed = (int32_t)smoothed + step / (1 << smoothing);
+  }
+
+  return accepted;
+}
+
+/*
+ * Replace the oldest echo with sample, in the ring and in the sorted
+ * copy, and update the median.
+ */
+void UltrasonicFilter::slide(uint16_t sample) {
+  uint8_t n = filled;
+
+  if (n == size) {
+    // Remove the oldest echo from the sorted copy
+    uint16_t oldest = ring[head];
+    uint8_t i = 0;
+    while (sorted[i] != oldest)
+      i++;
+    for (; i + 1 < n; i++)
+      sorted[i] = sorted[i + 1];
+    n--;
+  } else {
+    filled++;
+  }
+
+  ring[head] = sample;
+  head = (head + 1) % size;
+
+  // Insert the new echo in order
+  uint8_t i = n;
+  while (i > 0 && sorted[i - 1] > sample) {
+    sorted[i] = sorted[i - 1];
+    i--;
+  }
+  sorted[i] = sample;
+  n++;
+
+  middle = (n & 1) ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2] + 1) / 2;
+}
+
+/*
+ * Median absolute deviation of the window. The deviations of the echoes
+ * below the median, read downwards, and of those above it, read upwards,
+ * are both increasing, so merging them finds the median deviation
+ * without sorting.
+ */
+uint16_t UltrasonicFilter::deviation() {
+  uint8_t n = filled;
+  int8_t below = 0;
+  while (below < n && sorted[below] < middle)
+    below++;
+  uint8_t above = below;
+  below--;
+
+  uint16_t previous = 0, current = 0;
+  for (uint8_t k = 0; k <= n / 2; k++) {
+    previous = current;
+    if (above < n && (below < 0 || sorted[above] - middle <= middle - sorted[below]))
+      current = sorted[above++] - middle;
+    else
+      current = middle - sorted[below--];
+  }
+
+  return (n & 1) ? current : (previous + current + 1) / 2;
+}
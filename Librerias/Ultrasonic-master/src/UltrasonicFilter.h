@@ -0,0 +1,50 @@
+/*
+ * UltrasonicFilter.h
+ *
+ * Streaming filter for echo durations: a ring of the latest echoes kept
+ * sorted as it slides (running median), a Hampel outlier rejector and
+ * an exponential smoothing, all in integer arithmetic. The result is
+ * kept up to date as echoes arrive, so reading it costs nothing.
+ *
+ * This file does not depend on Arduino.
+ *
+ * Released into the MIT License.
+ */
+
+#ifndef UltrasonicFilter_h
+#define UltrasonicFilter_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include "UltrasonicAir.h"
+
+#define ULTRASONIC_FILTER_MAX 15 // Largest window, in echoes
+
+class UltrasonicFilter {
+  public:
+    UltrasonicFilter(uint8_t window = 5, uint8_t threshold = 3, uint8_t smoothing = 2);
+    void reset();
+    bool add(unsigned long duration);
+    uint32_t distance() const {return (smoothed + 8) >> 4;}
+    uint16_t median() const {return middle;}
+    uint8_t count() const {return filled;}
+    uint32_t rejected() const {return outliers;}
+    void setAir(const UltrasonicAir *airSnapshot) {air = airSnapshot;}
+
+  private:
+    uint16_t ring[ULTRASONIC_FILTER_MAX];   // Echoes in arrival order
+    uint16_t sorted[ULTRASONIC_FILTER_MAX]; // The same echoes, sorted
+    uint8_t size;
+    uint8_t head;
+    uint8_t filled;
+    uint8_t threshold;
+    uint8_t smoothing;
+    uint16_t middle;
+    uint32_t smoothed; // Tenths of a millimetre, with 4 fractional bits
+    uint32_t outliers;
+    const UltrasonicAir *air; // Speed of sound, or NULL for the scale of read()
+    void slide(uint16_t sample);
+    uint16_t deviation();
+};
+
+#endif // UltrasonicFilter_h
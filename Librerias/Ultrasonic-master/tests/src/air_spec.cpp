@@ -0,0 +1,114 @@
+#include "UltrasonicAir.h"
+#include "UltrasonicFilter.h"
+#include "BDDTest.h"
+#include "trace.h"
+#include <math.h>
+
+// Velocidad del sonido de referencia, en m/s
+static double speedOfSound(double temperature, double humidity) {
+    return 331.3 * sqrt(1 + temperature / 273.15) + 0.0124 * humidity;
+}
+
+
+int test_air_table() {
+    IT("matches the speed of sound from -40 to 85 C within 0.01 %");
+    UltrasonicAir air;
+
+    double maxError = 0;
+    for (int t = -400; t <= 850; t++) {
+        for (int h = 0; h <= 100; h += 25) {
+            IS_TRUE(air.set(t / 10.0f, h));
+            IS_EQUAL(air.temperature(), t);
+            IS_EQUAL(air.humidity(), h);
+
+            // El factor son décimas de mm por us de eco (ida y vuelta), en Q14
+            double expected = speedOfSound(t / 10.0, h) / 200 * 16384;
+            double error = fabs(air.factor() - expected) / expected;
+            if (error > maxError) {
+                maxError = error;
+            }
+        }
+    }
+    IS_TRUE(maxError < 0.0001);
+
+    END_IT
+}
+
+int test_air_distance() {
+    IT("converts echoes to tenths of a millimetre with one multiply");
+
+    // 20 C, aire seco: 343.2 m/s. Un eco de 1160 us son 199.1 mm
+    UltrasonicAir air;
+    IS_EQUAL(air.temperature(), 200);
+    IS_EQUAL(air.distance(1160), 1991);
+
+    // 0 C: 331.3 m/s, 192.2 mm; a 35 C, 351.9 m/s, 204.1 mm
+    air.set(0);
+    IS_EQUAL(air.distance(1160), 1922);
+    air.set(35);
+    IS_EQUAL(air.distance(1160), 2041);
+
+    // La humedad agrega poco: 100 % a 35 C, +1.24 m/s
+    air.set(35, 100);
+    IS_EQUAL(air.distance(1160), 2048);
+
+    // Hasta 4 m (23.3 ms de eco) con menos de 0.1 mm de diferencia
+    air.set(21.5f, 60);
+    double expected = 23300 * speedOfSound(21.5, 60) / 200;
+    IS_TRUE(fabs(air.distance(23300) - expected) < 1);
+
+    END_IT
+}
+
+int test_air_limits() {
+    IT("clamps to the table and ignores failed sensor reads");
+    UltrasonicAir air(25, 40);
+
+    IS_FALSE(air.set(NAN, 50));
+    IS_EQUAL(air.temperature(), 250);
+    IS_EQUAL(air.humidity(), 40);
+
+    // Humedad no válida: aire seco
+    IS_TRUE(air.set(25, NAN));
+    IS_EQUAL(air.humidity(), 0);
+
+    air.set(-60, -5);
+    IS_EQUAL(air.temperature(), -400);
+    IS_EQUAL(air.humidity(), 0);
+    air.set(120, 140);
+    IS_EQUAL(air.temperature(), 850);
+    IS_EQUAL(air.humidity(), 100);
+
+    END_IT
+}
+
+int test_air_filter() {
+    IT("lets the filter use the shared snapshot");
+    UltrasonicAir air(0);
+    UltrasonicFilter filter(1, 0, 0);
+
+    filter.add(1160);
+    IS_EQUAL(filter.distance(), 2071);
+
+    filter.setAir(&air);
+    filter.add(1160);
+    IS_EQUAL(filter.distance(), 1922);
+
+    // El mismo snapshot, actualizado, sirve a todos los que lo usan
+    air.set(35);
+    filter.add(1160);
+    IS_EQUAL(filter.distance(), 2041);
+
+    END_IT
+}
+
+int main()
+{
+    SUITE("Air");
+    test_air_table();
+    test_air_distance();
+    test_air_limits();
+    test_air_filter();
+
+    FINISH
+}
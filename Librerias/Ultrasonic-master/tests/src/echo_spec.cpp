@@ -0,0 +1,148 @@
+#include "UltrasonicEcho.h"
+#include "SyntheticEcho.h"
+#include "BDDTest.h"
+#include "trace.h"
+
+#define TIMEOUT 20000UL
+
+// Llama a poll() cada 10 us mientras la medición siga en curso
+static UltrasonicStatus run(UltrasonicEcho& echo, SyntheticEcho& sensor, unsigned long limit = 100000) {
+    UltrasonicStatus status = echo.poll();
+
+    for (unsigned long t = 0; status == ULTRASONIC_BUSY && t < limit; t += 10) {
+        sensor.advance(10);
+        status = echo.poll();
+    }
+    return status;
+}
+
+
+int test_echo_pulse() {
+    IT("measures the echo pulse without blocking");
+    SyntheticEcho sensor;
+    UltrasonicEcho echo;
+    echo.setSource(&sensor);
+
+    // 1160 us: 20 cm
+    sensor.setEcho(450, 1160);
+    IS_EQUAL(echo.poll(), ULTRASONIC_IDLE);
+    IS_TRUE(echo.start(TIMEOUT));
+    IS_EQUAL(sensor.triggers, 1);
+    IS_TRUE(sensor.capturing());
+
+    // poll() vuelve de inmediato mientras el eco no termina
+    sensor.advance(1000);
+    IS_EQUAL(echo.poll(), ULTRASONIC_BUSY);
+    IS_TRUE(echo.busy());
+
+    IS_EQUAL(run(echo, sensor), ULTRASONIC_OK);
+    IS_EQUAL(echo.duration(), 1160);
+    IS_EQUAL(echo.duration() / 28 / 2, 20);
+    IS_EQUAL(sensor.stops, 1);
+    IS_FALSE(sensor.capturing());
+    IS_FALSE(echo.busy());
+
+    // El resultado queda hasta la próxima medición
+    IS_EQUAL(echo.poll(), ULTRASONIC_OK);
+    IS_EQUAL(sensor.stops, 1);
+
+    END_IT
+}
+
+int test_echo_missing() {
+    IT("reports a missing echo after the timeout");
+    SyntheticEcho sensor;
+    UltrasonicEcho echo;
+    echo.setSource(&sensor);
+
+    sensor.setEcho(0, 0);
+    IS_TRUE(echo.start(TIMEOUT));
+
+    sensor.advance(TIMEOUT);
+    IS_EQUAL(echo.poll(), ULTRASONIC_BUSY);
+    sensor.advance(10);
+    IS_EQUAL(echo.poll(), ULTRASONIC_TIMEOUT);
+
+    // Como read(): sin eco la duración es 0
+    IS_EQUAL(echo.duration(), 0);
+    IS_EQUAL(sensor.stops, 1);
+
+    END_IT
+}
+
+int test_echo_too_long() {
+    IT("reports an echo longer than the timeout");
+    SyntheticEcho sensor;
+    UltrasonicEcho echo;
+    echo.setSource(&sensor);
+
+    // El plazo cuenta desde el inicio del eco, como en read()
+    sensor.setStuckEcho(500);
+    IS_TRUE(echo.start(TIMEOUT));
+
+    sensor.advance(500 + TIMEOUT);
+    IS_EQUAL(echo.poll(), ULTRASONIC_BUSY);
+    IS_EQUAL(run(echo, sensor), ULTRASONIC_TIMEOUT);
+    IS_EQUAL(echo.duration(), TIMEOUT);
+
+    END_IT
+}
+
+int test_echo_edges() {
+    IT("ignores edges before the rise and after the fall");
+    SyntheticEcho sensor;
+    UltrasonicEcho echo;
+    echo.setSource(&sensor);
+
+    SyntheticEcho::Edge edges[] = {
+        { 100, false }, { 300, true }, { 400, true }, { 2300, false }, { 2500, true }, { 2600, false }
+    };
+    sensor.edges.assign(edges, edges + 6);
+    IS_TRUE(echo.start(TIMEOUT));
+
+    sensor.advance(3000);
+    IS_EQUAL(echo.poll(), ULTRASONIC_OK);
+    IS_EQUAL(echo.duration(), 2000);
+
+    END_IT
+}
+
+int test_echo_restart() {
+    IT("starts one measurement at a time and can cancel it");
+    SyntheticEcho sensor;
+    UltrasonicEcho echo;
+
+    // Sin sensor no hay medición
+    IS_FALSE(echo.start(TIMEOUT));
+    echo.setSource(&sensor);
+
+    sensor.setEcho(200, 600);
+    IS_TRUE(echo.start(TIMEOUT));
+    IS_FALSE(echo.start(TIMEOUT));
+    IS_EQUAL(sensor.triggers, 1);
+
+    echo.cancel();
+    IS_EQUAL(echo.status(), ULTRASONIC_IDLE);
+    IS_EQUAL(sensor.stops, 1);
+
+    // Una medición nueva no ve los flancos de la anterior
+    sensor.advance(5000);
+    sensor.setEcho(200, 900);
+    IS_TRUE(echo.start(TIMEOUT));
+    IS_EQUAL(run(echo, sensor), ULTRASONIC_OK);
+    IS_EQUAL(echo.duration(), 900);
+
+    END_IT
+}
+
+int main()
+{
+    SUITE("Echo");
+    test_echo_pulse();
+    test_echo_missing();
+    test_echo_too_long();
+    test_echo_edges();
+    test_echo_restart();
+
+    FINISH
+}
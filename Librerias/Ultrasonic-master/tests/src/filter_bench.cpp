@@ -0,0 +1,52 @@
+#include "UltrasonicFilter.h"
+#include "Hampel.h"
+#include <stdlib.h>
+#include <chrono>
+#include <iostream>
+
+#define SAMPLES    4096
+#define ITERATIONS 1000
+
+static void report(const char* name, std::chrono::steady_clock::time_point start, uint32_t check) {
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count() / ((double)SAMPLES * ITERATIONS);
+    std::cout << name << ": " << ns << " ns/echo (" << 1e9 / ns << " echoes/s, check " << check << ")\n";
+}
+
+int main()
+{
+    static uint16_t samples[SAMPLES];
+    uint32_t check;
+
+    srand(1);
+    for (int i = 0; i < SAMPLES; i++) {
+        samples[i] = (rand() % 10 == 0) ? rand() % 20000 : 1000 + rand() % 60;
+    }
+
+    for (int window = 5; window <= ULTRASONIC_FILTER_MAX; window += 5) {
+        std::cout << "window " << window << "\n";
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        check = 0;
+        for (int k = 0; k < ITERATIONS; k++) {
+            Hampel reference(window, 3);
+            for (int i = 0; i < SAMPLES; i++) {
+                uint16_t median;
+                check += reference.add(samples[i], &median);
+            }
+        }
+        report("  copy and sort", start, check);
+
+        start = std::chrono::steady_clock::now();
+        check = 0;
+        for (int k = 0; k < ITERATIONS; k++) {
+            UltrasonicFilter filter(window, 3);
+            for (int i = 0; i < SAMPLES; i++) {
+                check += filter.add(samples[i]);
+            }
+        }
+        report("  UltrasonicFilter", start, check);
+    }
+
+    return 0;
+}
@@ -0,0 +1,153 @@
+#include "UltrasonicFilter.h"
+#include "Hampel.h"
+#include "BDDTest.h"
+#include "trace.h"
+#include <stdlib.h>
+
+// Eco de 20 cm (2071 décimas de mm) y de 40 cm
+#define ECHO_20CM 1160
+#define ECHO_40CM 2320
+
+// Eco con ruido, y un pico de vez en cuando
+static uint16_t noisyEcho() {
+    if (rand() % 10 == 0) {
+        return rand() % 20000;
+    }
+    return 1000 + rand() % 60;
+}
+
+
+int test_filter_median() {
+    IT("keeps the running median of every window size");
+
+    for (int window = 1; window <= ULTRASONIC_FILTER_MAX; window++) {
+        UltrasonicFilter filter(window, 0);
+        Hampel reference(window, 0);
+        srand(window);
+
+        bool same = true;
+        for (int i = 0; i < 500; i++) {
+            uint16_t sample = rand() % 3000;
+            uint16_t median;
+            reference.add(sample, &median);
+            filter.add(sample);
+            same = same && filter.median() == median;
+        }
+        IS_TRUE(same);
+        IS_EQUAL(filter.count(), window);
+    }
+
+    END_IT
+}
+
+int test_filter_outliers() {
+    IT("rejects the same outliers as a sorted Hampel filter");
+
+    for (int window = 3; window <= ULTRASONIC_FILTER_MAX; window += 2) {
+        UltrasonicFilter filter(window, 3);
+        Hampel reference(window, 3);
+        srand(100 + window);
+
+        bool same = true;
+        uint32_t rejected = 0;
+        for (int i = 0; i < 1000; i++) {
+            uint16_t sample = noisyEcho();
+            uint16_t median;
+            bool accepted = reference.add(sample, &median);
+            rejected += !accepted;
+            same = same && filter.add(sample) == accepted;
+        }
+        IS_TRUE(same);
+        IS_EQUAL(filter.rejected(), rejected);
+        IS_TRUE(rejected > 0);
+    }
+
+    END_IT
+}
+
+int test_filter_spike() {
+    IT("replaces a spike with the median and follows a real change");
+    UltrasonicFilter filter(5, 3, 0);
+
+    for (int i = 0; i < 5; i++) {
+        IS_TRUE(filter.add(ECHO_20CM));
+    }
+    IS_EQUAL(filter.distance(), 2071);
+
+    // Un pico no mueve la distancia
+    IS_FALSE(filter.add(12000));
+    IS_EQUAL(filter.distance(), 2071);
+    IS_EQUAL(filter.rejected(), 1);
+
+    // Un cambio real se acepta cuando la mediana lo alcanza (aquí, con la ayuda del pico que
+    // sigue en la ventana)
+    IS_FALSE(filter.add(ECHO_40CM));
+    IS_TRUE(filter.add(ECHO_40CM));
+    IS_TRUE(filter.add(ECHO_40CM));
+    IS_EQUAL(filter.median(), ECHO_40CM);
+    IS_EQUAL(filter.distance(), 4143);
+
+    END_IT
+}
+
+int test_filter_jitter() {
+    IT("accepts the jitter of a still target");
+    UltrasonicFilter filter(5, 3, 0);
+
+    // La mayoría de la ventana tiene el mismo eco, y su MAD es 0
+    const uint16_t echoes[] = { 0, 0, 0, 1, 0, 0, 2, 0, 0, 1 };
+    for (int i = 0; i < 10; i++) {
+        IS_TRUE(filter.add(ECHO_20CM + echoes[i]));
+    }
+    IS_EQUAL(filter.rejected(), 0);
+
+    // Un eco más lejano sigue siendo un outlier
+    IS_FALSE(filter.add(ECHO_20CM + 60));
+
+    END_IT
+}
+
+int test_filter_smoothing() {
+    IT("smooths the distance in tenths of a millimetre");
+    UltrasonicFilter raw(1, 0, 0);
+
+    // La misma escala que read(): 28 us por cm, ida y vuelta
+    raw.add(ECHO_20CM);
+    IS_EQUAL(raw.distance(), 2071);
+    raw.add(56);
+    IS_EQUAL(raw.distance(), 100);
+
+    // Cada eco acerca la salida 1/4 del camino
+    UltrasonicFilter smooth(1, 0, 2);
+    smooth.add(ECHO_20CM);
+    IS_EQUAL(smooth.distance(), 2071);
+    smooth.add(ECHO_40CM);
+    IS_EQUAL(smooth.distance(), 2589);
+    for (int i = 0; i < 40; i++) {
+        smooth.add(ECHO_40CM);
+    }
+    IS_EQUAL(smooth.distance(), 4143);
+    for (int i = 0; i < 40; i++) {
+        smooth.add(ECHO_20CM);
+    }
+    IS_EQUAL(smooth.distance(), 2071);
+
+    smooth.reset();
+    IS_EQUAL(smooth.count(), 0);
+    smooth.add(ECHO_40CM);
+    IS_EQUAL(smooth.distance(), 4143);
+
+    END_IT
+}
+
+int main()
+{
+    SUITE("Filter");
+    test_filter_median();
+    test_filter_outliers();
+    test_filter_spike();
+    test_filter_jitter();
+    test_filter_smoothing();
+
+    FINISH
+}
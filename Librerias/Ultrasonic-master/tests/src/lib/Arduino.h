@@ -0,0 +1,35 @@
+#ifndef Arduino_h
+#define Arduino_h
+
+// Reemplazo de Arduino.h para compilar Ultrasonic.cpp en Linux. Los pines no hacen nada (las
+// pruebas usan un eco sintético con Ultrasonic::setEdgeSource()), y el reloj lo controla la prueba
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+typedef bool boolean;
+
+#define HIGH          1
+#define LOW           0
+#define INPUT         0
+#define OUTPUT        1
+#define CHANGE        3
+
+#define digitalPinToInterrupt(p) (p)
+
+// Reloj de las pruebas, en us: micros() lo devuelve, y millis() lo devuelve en ms
+extern uint32_t hostMicros;
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+void attachInterrupt(uint8_t pin, void (*handler)(), int mode);
+void detachInterrupt(uint8_t pin);
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef clocked_echo_h
+#define clocked_echo_h
+
+// Eco sintético que sigue el reloj de Arduino.h (hostMicros), para probar varios sensores con un
+// mismo reloj. Guarda el momento de cada disparo y del fin de cada medición
+
+#include "Arduino.h"
+#include "SyntheticEcho.h"
+
+class ClockedEcho : public SyntheticEcho {
+public:
+    std::vector<unsigned long> triggerTimes;
+    std::vector<unsigned long> stopTimes;
+
+    ClockedEcho() {
+        now = hostMicros;
+    }
+
+    virtual void trigger() {
+        sync();
+        triggerTimes.push_back(now);
+        SyntheticEcho::trigger();
+    }
+
+    virtual void stop() {
+        sync();
+        stopTimes.push_back(now);
+        SyntheticEcho::stop();
+    }
+
+    virtual unsigned long micros() {
+        sync();
+        return now;
+    }
+
+private:
+    void sync() {
+        if (hostMicros > now) {
+            advance(hostMicros - now);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef hampel_h
+#define hampel_h
+
+// Filtro de Hampel de referencia: copia y ordena la ventana en cada muestra. Las pruebas comparan
+// UltrasonicFilter con él, y el benchmark mide la diferencia
+
+#include <stdint.h>
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+class Hampel {
+public:
+    size_t window;
+    unsigned threshold;
+    std::deque<uint16_t> samples;
+
+    Hampel(size_t window, unsigned threshold) : window(window), threshold(threshold) {}
+
+    // Mediana con redondeo hacia arriba para ventanas pares, como UltrasonicFilter
+    static uint16_t median(std::vector<uint16_t> v) {
+        std::sort(v.begin(), v.end());
+        size_t n = v.size();
+        return (n & 1) ? v[n / 2] : (v[n / 2 - 1] + v[n / 2] + 1) / 2;
+    }
+
+    // Agrega una muestra; devuelve false si es un outlier
+    bool add(uint16_t sample, uint16_t* med) {
+        samples.push_back(sample);
+        if (samples.size() > window) {
+            samples.pop_front();
+        }
+
+        std::vector<uint16_t> v(samples.begin(), samples.end());
+        *med = median(v);
+        if (threshold == 0 || v.size() < 3) {
+            return true;
+        }
+
+        for (size_t i = 0; i < v.size(); i++) {
+            v[i] = v[i] > *med ? v[i] - *med : *med - v[i];
+        }
+        // MAD de al menos 1 us, como UltrasonicFilter
+        uint32_t mad = std::max<uint32_t>(median(v), 1);
+        uint32_t offset = sample > *med ? sample - *med : *med - sample;
+        return offset * 1000 / 1483 <= threshold * mad;
+    }
+};
+
+#endif
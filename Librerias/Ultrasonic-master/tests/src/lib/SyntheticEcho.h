@@ -0,0 +1,87 @@
+#ifndef synthetic_echo_h
+#define synthetic_echo_h
+
+// Sensor sintético para UltrasonicEcho: un reloj controlado por la prueba y un eco configurable,
+// cuyos flancos se guardan a medida que avanza el reloj (como lo haría la interrupción del pin
+// ECHO). Con tick > 0, cada llamada a micros() avanza el reloj, para probar la lectura bloqueante
+
+#include "UltrasonicEcho.h"
+#include <vector>
+
+class SyntheticEcho : public UltrasonicEdgeSource {
+public:
+    // Un flanco del pin ECHO, relativo al disparo
+    struct Edge {
+        unsigned long at;
+        bool high;
+    };
+
+    unsigned long now;          // Reloj, en us
+    unsigned long tick;         // Avance del reloj en cada llamada a micros()
+    int triggers;               // Llamadas a trigger()
+    int stops;                  // Llamadas a stop()
+    std::vector<Edge> edges;    // Flancos del próximo eco
+
+    SyntheticEcho() : now(1000), tick(0), triggers(0), stops(0), _edges(NULL), _triggered(0), _next(0) {}
+
+    // Eco de length us que empieza delay us después del disparo. length 0: sin eco
+    void setEcho(unsigned long delay, unsigned long length) {
+        edges.clear();
+        if (length > 0) {
+            edges.push_back(Edge{ delay, true });
+            edges.push_back(Edge{ delay + length, false });
+        }
+    }
+
+    // Eco que empieza delay us después del disparo y no termina
+    void setStuckEcho(unsigned long delay) {
+        edges.clear();
+        edges.push_back(Edge{ delay, true });
+    }
+
+    // Avanza el reloj, entregando los flancos que ocurren hasta entonces
+    void advance(unsigned long micros) {
+        now += micros;
+        deliver();
+    }
+
+    bool capturing() const {
+        return _edges != NULL;
+    }
+
+    virtual void trigger() {
+        triggers++;
+        _triggered = now;
+        _next = 0;
+    }
+
+    virtual void capture(UltrasonicEchoEdges* edges) {
+        _edges = edges;
+    }
+
+    virtual void stop() {
+        _edges = NULL;
+        stops++;
+    }
+
+    virtual unsigned long micros() {
+        if (tick > 0) {
+            advance(tick);
+        }
+        return now;
+    }
+
+private:
+    UltrasonicEchoEdges* _edges;
+    unsigned long _triggered;
+    size_t _next;
+
+    void deliver() {
+        while (_edges != NULL && _next < edges.size() && _triggered + edges[_next].at <= now) {
+            _edges->record(_triggered + edges[_next].at, edges[_next].high);
+            _next++;
+        }
+    }
+};
+
+#endif
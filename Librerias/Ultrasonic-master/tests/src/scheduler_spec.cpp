@@ -0,0 +1,180 @@
+#include "Arduino.h"
+#include "UltrasonicScheduler.h"
+#include "ClockedEcho.h"
+#include "BDDTest.h"
+#include "trace.h"
+#include <algorithm>
+
+#define GUARD 10000UL
+
+// Llama a scheduler.loop() cada 10 us durante ms milisegundos. Devuelve el máximo de mediciones
+// simultáneas observado
+static int run(UltrasonicScheduler& scheduler, ClockedEcho* echoes, unsigned long ms) {
+    int maxInFlight = 0;
+
+    for (unsigned long t = 0; t < ms * 100; t++) {
+        hostMicros += 10;
+        scheduler.loop();
+
+        int inFlight = 0;
+        for (uint8_t i = 0; i < scheduler.count(); i++) {
+            inFlight += echoes[i].capturing();
+        }
+        if (inFlight > maxInFlight) {
+            maxInFlight = inFlight;
+        }
+    }
+    return maxInFlight;
+}
+
+// Los disparos de todos los sensores, en orden: cada uno debe esperar la guarda tras el fin de la
+// medición anterior
+static bool guarded(ClockedEcho* echoes, int count, unsigned long guard) {
+    std::vector<std::pair<unsigned long, unsigned long> > measurements;
+    for (int i = 0; i < count; i++) {
+        for (size_t k = 0; k < echoes[i].stopTimes.size(); k++) {
+            measurements.push_back(std::make_pair(echoes[i].triggerTimes[k], echoes[i].stopTimes[k]));
+        }
+    }
+    std::sort(measurements.begin(), measurements.end());
+
+    for (size_t k = 1; k < measurements.size(); k++) {
+        if (measurements[k].first < measurements[k - 1].second + guard) {
+            return false;
+        }
+    }
+    return measurements.size() > 1;
+}
+
+
+int test_scheduler_crosstalk() {
+    IT("fires one sensor at a time with a guard after each echo");
+    hostMicros = 0;
+    UltrasonicScheduler scheduler(4);
+    ClockedEcho echoes[4];
+
+    for (int i = 0; i < 4; i++) {
+        IS_EQUAL(scheduler.add(10 + i, 20 + i), i);
+        echoes[i].setEcho(300, 1160 * (i + 1));
+        scheduler.sensor(i).setEdgeSource(&echoes[i]);
+    }
+    scheduler.begin(GUARD);
+
+    IS_EQUAL(run(scheduler, echoes, 1000), 1);
+    IS_TRUE(guarded(echoes, 4, GUARD));
+
+    // En el orden en que se agregaron
+    IS_EQUAL(echoes[0].triggerTimes[0], 10);
+    IS_TRUE(echoes[0].triggerTimes[0] < echoes[1].triggerTimes[0]);
+    IS_TRUE(echoes[1].triggerTimes[0] < echoes[2].triggerTimes[0]);
+    IS_TRUE(echoes[2].triggerTimes[0] < echoes[3].triggerTimes[0]);
+    IS_TRUE(echoes[3].triggerTimes[0] < echoes[0].triggerTimes[1]);
+
+    // Un ciclo: 4 guardas y 4 ecos de 300 us de espera más 1160, 2320, 3480 y 4640 us
+    // (~52800 us), así que cada sensor se mide ~18.9 veces por segundo
+    for (int i = 0; i < 4; i++) {
+        float rate = scheduler.rate(i);
+        IS_TRUE(rate > 18.5f && rate < 19.5f);
+    }
+
+    END_IT
+}
+
+int test_scheduler_table() {
+    IT("publishes the filtered distance of each sensor in the table");
+    hostMicros = 0;
+    UltrasonicScheduler scheduler(2);
+    ClockedEcho echoes[2];
+
+    for (int i = 0; i < 2; i++) {
+        scheduler.add(10 + i, 20 + i);
+        scheduler.sensor(i).setEdgeSource(&echoes[i]);
+    }
+    echoes[0].setEcho(300, 1160);
+    echoes[1].setEcho(0, 0);
+    scheduler.begin(GUARD);
+
+    run(scheduler, echoes, 400);
+
+    const UltrasonicReading& r = scheduler.reading(0);
+    IS_EQUAL(r.status, ULTRASONIC_OK);
+    IS_EQUAL(r.distance, 2071);
+    IS_EQUAL(r.failures, 0);
+    IS_TRUE(r.measurements > 5);
+    IS_TRUE(r.timestamp > 350);
+    IS_EQUAL(scheduler.filter(0).median(), 1160);
+
+    // Sin eco: cuenta fallas y no hay distancia
+    const UltrasonicReading& s = scheduler.reading(1);
+    IS_TRUE(s.status == ULTRASONIC_TIMEOUT || s.status == ULTRASONIC_BUSY);
+    IS_TRUE(s.measurements > 5);
+    IS_EQUAL(s.failures, s.measurements);
+    IS_EQUAL(s.distance, 0);
+    IS_EQUAL(s.timestamp, 0);
+
+    // Un pico aislado no llega a la tabla
+    echoes[0].setEcho(300, 9000);
+    uint32_t measurements = r.measurements;
+    while (r.measurements == measurements) {
+        run(scheduler, echoes, 1);
+    }
+    IS_EQUAL(r.status, ULTRASONIC_OK);
+    IS_EQUAL(r.distance, 2071);
+
+    // Con la temperatura del aire: 20 C
+    UltrasonicAir air;
+    scheduler.setAir(&air);
+    echoes[0].setEcho(300, 1160);
+    measurements = r.measurements;
+    while (r.measurements == measurements) {
+        run(scheduler, echoes, 1);
+    }
+    IS_TRUE(r.distance < 2071 && r.distance >= 1991);
+
+    END_IT
+}
+
+int test_scheduler_order() {
+    IT("follows a custom order and respects its capacity");
+    hostMicros = 0;
+    UltrasonicScheduler scheduler(3);
+    ClockedEcho echoes[3];
+
+    for (int i = 0; i < 3; i++) {
+        IS_EQUAL(scheduler.add(10 + i, 20 + i), i);
+        echoes[i].setEcho(300, 1160);
+        scheduler.sensor(i).setEdgeSource(&echoes[i]);
+    }
+    IS_EQUAL(scheduler.add(13, 23), -1);
+    IS_EQUAL(scheduler.count(), 3);
+
+    const uint8_t bad[] = { 0, 3 };
+    IS_FALSE(scheduler.setOrder(bad, 2));
+    const uint8_t order[] = { 0, 1, 0, 2 };
+    IS_TRUE(scheduler.setOrder(order, 4));
+    scheduler.begin(GUARD);
+
+    IS_EQUAL(run(scheduler, echoes, 1000), 1);
+    IS_TRUE(guarded(echoes, 3, GUARD));
+
+    // El sensor 0 se mide el doble de veces
+    size_t n0 = echoes[0].triggerTimes.size();
+    size_t n1 = echoes[1].triggerTimes.size();
+    size_t n2 = echoes[2].triggerTimes.size();
+    IS_TRUE(n0 >= 2 * n1 - 1 && n0 <= 2 * n1 + 1);
+    IS_TRUE(n1 >= n2 && n1 <= n2 + 1);
+    IS_TRUE(echoes[1].triggerTimes[0] < echoes[0].triggerTimes[1]);
+    IS_TRUE(echoes[0].triggerTimes[1] < echoes[2].triggerTimes[0]);
+
+    END_IT
+}
+
+int main()
+{
+    SUITE("Scheduler");
+    test_scheduler_crosstalk();
+    test_scheduler_table();
+    test_scheduler_order();
+
+    FINISH
+}
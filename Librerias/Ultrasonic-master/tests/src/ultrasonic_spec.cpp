@@ -0,0 +1,128 @@
+#include "Arduino.h"
+#include "Ultrasonic.h"
+#include "SyntheticEcho.h"
+#include "BDDTest.h"
+#include "trace.h"
+
+int test_ultrasonic_read() {
+    IT("keeps the blocking read() on top of the echo capture");
+    Ultrasonic ultrasonic(12, 13);
+    SyntheticEcho sensor;
+    sensor.tick = 1;
+    ultrasonic.setEdgeSource(&sensor);
+
+    // 5680 us: 101 cm, 40 in
+    sensor.setEcho(400, 5680);
+    IS_EQUAL(ultrasonic.read(), 101);
+    IS_EQUAL(ultrasonic.read(CM), 101);
+    IS_EQUAL(ultrasonic.read(INC), 40);
+    IS_EQUAL(sensor.triggers, 3);
+
+    // Sin objeto en rango: 0, como antes
+    sensor.setEcho(0, 0);
+    unsigned long start = sensor.now;
+    IS_EQUAL(ultrasonic.read(), 0);
+    IS_TRUE(sensor.now - start > 20000UL);
+
+    END_IT
+}
+
+int test_ultrasonic_async() {
+    IT("triggers and returns at once, then polls the result");
+    Ultrasonic ultrasonic(12, 13);
+    SyntheticEcho sensor;
+    ultrasonic.setEdgeSource(&sensor);
+
+    sensor.setEcho(300, 1160);
+    IS_TRUE(ultrasonic.trigger());
+    IS_FALSE(ultrasonic.trigger());
+    IS_EQUAL(ultrasonic.poll(), ULTRASONIC_BUSY);
+
+    sensor.advance(1000);
+    IS_EQUAL(ultrasonic.poll(), ULTRASONIC_BUSY);
+    sensor.advance(500);
+    IS_EQUAL(ultrasonic.poll(), ULTRASONIC_OK);
+    IS_EQUAL(ultrasonic.duration(), 1160);
+    IS_EQUAL(ultrasonic.distance(), 20);
+    IS_EQUAL(ultrasonic.distance(INC), 8);
+
+    // El timeout configurado se aplica a la medición asíncrona
+    ultrasonic.setMaxDistance(100);
+    sensor.setStuckEcho(300);
+    IS_TRUE(ultrasonic.trigger());
+    sensor.advance(300 + 100 * CM * 2 + 1);
+    IS_EQUAL(ultrasonic.poll(), ULTRASONIC_TIMEOUT);
+    IS_EQUAL(ultrasonic.distance(), 100);
+
+    END_IT
+}
+
+int test_ultrasonic_filter() {
+    IT("feeds each echo once to the attached filter");
+    Ultrasonic ultrasonic(12, 13);
+    UltrasonicFilter filter(5, 3, 0);
+    SyntheticEcho sensor;
+    ultrasonic.setEdgeSource(&sensor);
+    ultrasonic.setFilter(&filter);
+
+    for (int i = 0; i < 4; i++) {
+        sensor.setEcho(300, 1160);
+        IS_TRUE(ultrasonic.trigger());
+        sensor.advance(2000);
+        IS_EQUAL(ultrasonic.poll(), ULTRASONIC_OK);
+        IS_EQUAL(ultrasonic.poll(), ULTRASONIC_OK);
+    }
+    IS_EQUAL(filter.count(), 4);
+
+    // Las lecturas bloqueantes también pasan por el filtro, y un eco perdido no entra
+    sensor.tick = 1;
+    sensor.setEcho(300, 9000);
+    IS_EQUAL(ultrasonic.read(), 160);
+    sensor.setEcho(0, 0);
+    IS_EQUAL(ultrasonic.read(), 0);
+    IS_EQUAL(filter.count(), 5);
+    IS_EQUAL(filter.rejected(), 1);
+    IS_EQUAL(filter.distance(), 2071);
+
+    END_IT
+}
+
+int test_ultrasonic_air() {
+    IT("compensates read() and distance() with the air snapshot");
+    Ultrasonic ultrasonic(12, 13);
+    UltrasonicAir air(35);
+    SyntheticEcho sensor;
+    sensor.tick = 1;
+    ultrasonic.setEdgeSource(&sensor);
+
+    // 5680 us: 101 cm con la escala fija; 99.9 cm a 35 C
+    sensor.setEcho(400, 5680);
+    IS_EQUAL(ultrasonic.read(), 101);
+    ultrasonic.setAir(&air);
+    IS_EQUAL(ultrasonic.read(), 100);
+    IS_EQUAL(ultrasonic.read(INC), 39);
+    IS_EQUAL(ultrasonic.distance(), 100);
+
+    // A 0 C el sonido es más lento: 94.1 cm
+    air.set(0);
+    IS_EQUAL(ultrasonic.distance(), 94);
+
+    // Otros divisores siguen como antes
+    IS_EQUAL(ultrasonic.distance(10), 284);
+
+    ultrasonic.setAir(NULL);
+    IS_EQUAL(ultrasonic.distance(), 101);
+
+    END_IT
+}
+
+int main()
+{
+    SUITE("Ultrasonic");
+    test_ultrasonic_read();
+    test_ultrasonic_async();
+    test_ultrasonic_filter();
+    test_ultrasonic_air();
+
+    FINISH
+}